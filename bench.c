@@ -0,0 +1,912 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "leptjson.h"
+
+/* helper - timing */
+
+/* wall time, clock() would add up the time of every thread */
+static double bench_now() {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void bench_report(const char* name, size_t bytes, int iters, double secs) {
+    printf("%-32s %10.2f MB/s %12.3f us/iter\n", name,
+        secs > 0 ? (double)bytes * iters / secs / (1024.0 * 1024.0) : 0.0,
+        secs * 1e6 / iters);
+}
+
+#define BENCH(name, bytes, iters, stmt) \
+    do { \
+        double t0 = bench_now(); \
+        for(int it = 0; it < (iters); it ++) { \
+            stmt; \
+        } \
+        bench_report((name), (bytes), (iters), bench_now() - t0); \
+    } while(0)
+
+/* helper - documents */
+
+typedef struct {
+    char* s;
+    size_t len, cap;
+} bench_buf;
+
+static void bench_append(bench_buf* b, const char* s) {
+    size_t n = strlen(s);
+    if(b->len + n + 1 > b->cap) {
+        b->cap = (b->len + n + 1) * 2;
+        b->s = (char*)realloc(b->s, b->cap);
+    }
+    memcpy(b->s + b->len, s, n + 1);
+    b->len += n;
+}
+
+/* an array of small records, typical of API request bodies */
+static char* bench_records(int n) {
+    bench_buf b = { NULL, 0, 0 };
+    char tmp[256];
+
+    bench_append(&b, "[");
+    for(int i = 0; i < n; i ++) {
+        sprintf(tmp, "%s{\"id\":%d,\"name\":\"user%d\",\"active\":%s,\"score\":%d.%d,"
+            "\"tags\":[\"a\",\"bb\",\"ccc\"],\"geo\":{\"lat\":%d.5,\"lng\":-%d.25}}",
+            i ? "," : "", i, i, (i & 1) ? "true" : "false", i * 7, i % 10, i % 90, i % 180);
+        bench_append(&b, tmp);
+    }
+    bench_append(&b, "]");
+
+    return b.s;
+}
+
+/* records with the long, descriptive keys of a typical export */
+static char* bench_accounts(int n) {
+    bench_buf b = { NULL, 0, 0 };
+    char tmp[512];
+
+    bench_append(&b, "[");
+    for(int i = 0; i < n; i ++) {
+        sprintf(tmp, "%s{\"account_identifier\":%d,\"display_name\":\"user%d\","
+            "\"created_at_timestamp\":%d,\"last_login_timestamp\":%d,\"email_verified\":%s,"
+            "\"billing_address\":{\"street_address_line1\":\"%d Main St\",\"postal_code\":\"%05d\","
+            "\"country_code\":\"US\"},\"notification_preferences\":[\"email\",\"sms\"]}",
+            i ? "," : "", i, i, 1600000000 + i, 1700000000 + i, (i & 1) ? "true" : "false", i, i % 100000);
+        bench_append(&b, tmp);
+    }
+    bench_append(&b, "]");
+
+    return b.s;
+}
+
+/* a pretty-printed config with long base64 blobs */
+static char* bench_pretty(int n) {
+    bench_buf b = { NULL, 0, 0 };
+    char tmp[64];
+
+    bench_append(&b, "{\n");
+    for(int i = 0; i < n; i ++) {
+        sprintf(tmp, "%s    \"section%d\": {\n        \"blob\": \"", i ? ",\n" : "", i);
+        bench_append(&b, tmp);
+        for(int j = 0; j < 16; j ++) {
+            bench_append(&b, "QUJDREVGR0hJSktMTU5PUFFSU1RVVldYWVphYmNkZWZnaGlqa2xtbm9w");
+        }
+        bench_append(&b, "\",\n        \"list\": [\n            1,\n            2,\n            3\n        ]\n    }");
+    }
+    bench_append(&b, "\n}\n");
+
+    return b.s;
+}
+
+/* a GeoJSON-like coordinate array */
+static char* bench_coords(int n) {
+    bench_buf b = { NULL, 0, 0 };
+    char tmp[64];
+    unsigned seed = 12345;
+
+    bench_append(&b, "[");
+    for(int i = 0; i < n; i ++) {
+        seed = seed * 1103515245 + 12345;
+        sprintf(tmp, "%s[%.7f,%.7f]", i ? "," : "",
+            -180.0 + (seed >> 8) % 3600000 / 10000.0 + (seed & 0xFF) / 2560000.0,
+            -90.0 + (seed >> 12) % 1800000 / 10000.0);
+        bench_append(&b, tmp);
+    }
+    bench_append(&b, "]");
+
+    return b.s;
+}
+
+/* many deeply nested arrays and objects */
+static char* bench_deep(int n, int depth) {
+    bench_buf b = { NULL, 0, 0 };
+
+    bench_append(&b, "[");
+    for(int i = 0; i < n; i ++) {
+        bench_append(&b, i ? ",[" : "[");
+        for(int d = 1; d < depth; d ++) {
+            bench_append(&b, (d & 1) ? "{\"k\":[" : "[");
+        }
+        bench_append(&b, "1");
+        for(int d = depth - 1; d >= 1; d --) {
+            bench_append(&b, (d & 1) ? "]}" : "]");
+        }
+        bench_append(&b, "]");
+    }
+    bench_append(&b, "]");
+
+    return b.s;
+}
+
+/* long text fields with the odd escape, as in log or message exports */
+static char* bench_strings(int n) {
+    bench_buf b = { NULL, 0, 0 };
+
+    bench_append(&b, "[");
+    for(int i = 0; i < n; i ++) {
+        bench_append(&b, i ? ",\"" : "\"");
+        for(int j = 0; j < 4; j ++) {
+            bench_append(&b, "The quick brown fox jumps over the lazy dog, \\\"again\\\" and again.\\n");
+        }
+        bench_append(&b, "\"");
+    }
+    bench_append(&b, "]");
+
+    return b.s;
+}
+
+/* benchmarks */
+
+static void bench_parse_arena() {
+    char* json = bench_records(1000);
+    size_t len = strlen(json);
+    lept_arena a;
+    lept_value v;
+
+    BENCH("parse (malloc)", len, 200, {
+        lept_parse(&v, json);
+        lept_free(&v);
+    });
+
+    lept_arena_init(&a, 0);
+    BENCH("parse (arena)", len, 200, {
+        lept_parse_arena(&v, json, len, &a);
+        lept_arena_reset(&a);
+    });
+    lept_arena_free(&a);
+
+    free(json);
+}
+
+static void bench_parse_scan() {
+    char* json = bench_pretty(200);
+    size_t len = strlen(json);
+    lept_value v;
+
+    BENCH("parse (pretty, long strings)", len, 200, {
+        lept_parse(&v, json);
+        lept_free(&v);
+    });
+
+    free(json);
+}
+
+static void bench_parse_insitu() {
+    char* json = bench_records(1000);
+    size_t len = strlen(json);
+    char* buf = (char*)malloc(len + 1);
+    lept_value v;
+
+    BENCH("parse (records, copied strings)", len, 200, {
+        lept_parse_n(&v, json, len);
+        lept_free(&v);
+    });
+
+    /* the buffer is clobbered, so every run starts from a fresh copy */
+    BENCH("parse (records, in situ)", len, 200, {
+        memcpy(buf, json, len);
+        lept_parse_insitu(&v, buf, len);
+        lept_free(&v);
+    });
+
+    free(buf);
+    free(json);
+}
+
+/* bytes of keys too long to be inline, each a copy of its own */
+static size_t bench_key_bytes(const lept_value* v) {
+    size_t n = 0;
+    if(lept_get_type(v) == LEPT_ARRAY) {
+        for(size_t i = 0; i < lept_get_array_size(v); i ++) {
+            n += bench_key_bytes(lept_get_array_element(v, i));
+        }
+    } else if(lept_get_type(v) == LEPT_OBJECT) {
+        for(size_t i = 0; i < lept_get_object_size(v); i ++) {
+            size_t klen = lept_get_object_key_length(v, i);
+            n += (klen > LEPT_INLINE_MAX) ? klen + 1 : 0;
+            n += bench_key_bytes(lept_get_object_value(v, i));
+        }
+    }
+    return n;
+}
+
+static void bench_parse_intern() {
+    char* json = bench_accounts(1000);
+    size_t len = strlen(json), copied;
+    lept_intern* t = lept_intern_new();
+    lept_value v;
+
+    BENCH("parse (accounts, copied keys)", len, 200, {
+        lept_parse_n(&v, json, len);
+        lept_free(&v);
+    });
+
+    BENCH("parse (accounts, interned keys)", len, 200, {
+        lept_parse_intern(&v, json, len, t);
+        lept_free(&v);
+    });
+
+    lept_parse_n(&v, json, len);
+    copied = bench_key_bytes(&v);
+    lept_free(&v);
+    printf("key text: %zu bytes copied, %zu bytes interned\n", copied, lept_intern_size(t));
+
+    lept_intern_free(t);
+    free(json);
+}
+
+static int bench_count_number(void* user, double d) {
+    *(double*)user += d;
+    return 0;
+}
+
+/* summing every number, without a tree */
+static void bench_parse_sax() {
+    char* json = bench_records(1000);
+    size_t len = strlen(json);
+    lept_sax_handler h = { NULL, NULL, bench_count_number, NULL, NULL, NULL, NULL, NULL, NULL };
+    double sum = 0.0;
+    lept_value v;
+
+    BENCH("parse (records, dom)", len, 200, {
+        lept_parse_n(&v, json, len);
+        lept_free(&v);
+    });
+
+    BENCH("parse (records, sax)", len, 200, {
+        lept_parse_sax(json, len, &h, &sum);
+    });
+
+    free(json);
+}
+
+/* the records document arriving in socket-sized chunks */
+static void bench_parse_stream() {
+    char* json = bench_records(1000);
+    size_t len = strlen(json);
+    lept_stream* s = lept_stream_new();
+    lept_value v;
+
+    BENCH("parse (records, whole)", len, 200, {
+        lept_parse_n(&v, json, len);
+        lept_free(&v);
+    });
+
+    BENCH("parse (records, 4 KB chunks)", len, 200, {
+        for(size_t off = 0; off < len; off += 4096) {
+            lept_stream_feed(s, json + off, (len - off < 4096) ? len - off : 4096);
+        }
+        lept_stream_finish(s, &v);
+        lept_free(&v);
+    });
+
+    lept_stream_free(s);
+    free(json);
+}
+
+/* newline-delimited records, as in log and export files */
+static void bench_parse_lines() {
+    char* json = bench_records(100000);
+    size_t len = strlen(json), n = 0;
+    static const int nthreads[] = { 1, 2, 4, 8 };
+    char name[64];
+    char* line = NULL;
+    size_t cap = 0;
+    lept_line* lines;
+    lept_value* values = (lept_value*)malloc(100000 * sizeof(lept_value));
+
+    /* one record per line: the top-level "},{" become "}\n{" */
+    for(size_t i = 1; i + 1 < len; i ++) {
+        if(json[i] == ',' && json[i - 1] == '}' && json[i + 1] == '{') {
+            json[i] = '\n';
+        }
+    }
+    json ++;
+    len -= 2;
+
+    /* every value is kept, as lept_parse_lines() does */
+    BENCH("parse lines (copy + lept_parse)", len, 5, {
+        const char* p = json;
+        const char* end = json + len;
+        n = 0;
+        while(p < end) {
+            const char* nl = (const char*)memchr(p, '\n', (size_t)(end - p));
+            size_t l = (nl != NULL ? nl : end) - p;
+            if(l + 1 > cap) {
+                cap = (l + 1) * 2;
+                line = (char*)realloc(line, cap);
+            }
+            memcpy(line, p, l);
+            line[l] = '\0';
+            lept_parse(&values[n ++], line);
+            p += l + 1;
+        }
+        for(size_t i = 0; i < n; i ++) {
+            lept_free(&values[i]);
+        }
+    });
+    free(line);
+    free(values);
+
+    for(size_t t = 0; t < sizeof(nthreads) / sizeof(nthreads[0]); t ++) {
+        sprintf(name, "parse lines (%d threads)", nthreads[t]);
+        BENCH(name, len, 5, {
+            n = lept_parse_lines(json, len, &lines, nthreads[t]);
+            lept_free_lines(lines, n);
+        });
+    }
+
+    free(json - 1);
+}
+
+/* one large array, split between its elements */
+static void bench_parse_parallel() {
+    char* json = bench_records(100000);
+    size_t len = strlen(json);
+    static const int nthreads[] = { 1, 2, 4, 8 };
+    char name[64];
+    lept_value v;
+
+    BENCH("parse array (lept_parse_n)", len, 5, {
+        lept_parse_n(&v, json, len);
+        lept_free(&v);
+    });
+
+    for(size_t t = 0; t < sizeof(nthreads) / sizeof(nthreads[0]); t ++) {
+        sprintf(name, "parse array (%d threads)", nthreads[t]);
+        BENCH(name, len, 5, {
+            lept_parse_parallel(&v, json, len, nthreads[t]);
+            lept_free(&v);
+        });
+    }
+
+    free(json);
+}
+
+static void bench_parse_engine() {
+    char* docs[2];
+    const char* names[2][2] = {
+        { "parse (records, recursive)", "parse (records, index)" },
+        { "parse (pretty, recursive)", "parse (pretty, index)" }
+    };
+    lept_value v;
+
+    docs[0] = bench_records(20000);
+    docs[1] = bench_pretty(2000);
+    for(int d = 0; d < 2; d ++) {
+        size_t len = strlen(docs[d]);
+        lept_set_engine(LEPT_ENGINE_RECURSIVE);
+        BENCH(names[d][0], len, 20, {
+            lept_parse_n(&v, docs[d], len);
+            lept_free(&v);
+        });
+        lept_set_engine(LEPT_ENGINE_INDEX);
+        BENCH(names[d][1], len, 20, {
+            lept_parse_n(&v, docs[d], len);
+            lept_free(&v);
+        });
+        lept_set_engine(LEPT_ENGINE_RECURSIVE);
+        free(docs[d]);
+    }
+}
+
+static void bench_parse_deep() {
+    char* json = bench_deep(200, 500);
+    size_t len = strlen(json);
+    lept_sax_handler h = { NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL };
+    lept_value v;
+
+    BENCH("parse (deep, dom)", len, 50, {
+        lept_parse_n(&v, json, len);
+        lept_free(&v);
+    });
+
+    BENCH("parse (deep, sax)", len, 50, {
+        lept_parse_sax(json, len, &h, NULL);
+    });
+
+    free(json);
+}
+
+static void bench_parse_number() {
+    char* json = bench_coords(20000);
+    size_t len = strlen(json);
+    lept_value v;
+
+    BENCH("parse (coordinates)", len, 50, {
+        lept_parse(&v, json);
+        lept_free(&v);
+    });
+
+    free(json);
+}
+
+/* every field of a wide object, by key */
+static void bench_find_object() {
+    bench_buf b = { NULL, 0, 0 };
+    char tmp[64];
+    lept_value v;
+    size_t hits = 0;
+
+    bench_append(&b, "{");
+    for(int i = 0; i < 500; i ++) {
+        sprintf(tmp, "%s\"field_%d\":%d", i ? "," : "", i, i);
+        bench_append(&b, tmp);
+    }
+    bench_append(&b, "}");
+    lept_parse(&v, b.s);
+
+    BENCH("find 500 keys (linear)", b.len, 200, {
+        for(int i = 0; i < 500; i ++) {
+            size_t n = sprintf(tmp, "field_%d", i);
+            for(size_t j = 0; j < lept_get_object_size(&v); j ++) {
+                if(lept_get_object_key_length(&v, j) == n && memcmp(lept_get_object_key(&v, j), tmp, n) == 0) {
+                    hits ++;
+                    break;
+                }
+            }
+        }
+    });
+
+    BENCH("find 500 keys (hashed)", b.len, 200, {
+        for(int i = 0; i < 500; i ++) {
+            size_t n = sprintf(tmp, "field_%d", i);
+            hits += lept_find_object_value(&v, tmp, n) != NULL;
+        }
+    });
+
+    printf("%zu hits\n", hits);
+    lept_free(&v);
+    free(b.s);
+}
+
+static int bench_query_sum(void* user, lept_value* v) {
+    *(double*)user += lept_get_number(v);
+    return 0;
+}
+
+/* a path compiled once against compiling it for every lookup */
+static void bench_query() {
+    char* json = bench_records(2000);
+    size_t len = strlen(json);
+    const char* path = "/1500/geo/lat";
+    lept_query* q = lept_query_compile(path, strlen(path));
+    lept_query* all = lept_query_compile("$[*].geo.lat", 12);
+    double sum = 0.0;
+    lept_value v;
+
+    lept_parse(&v, json);
+
+    BENCH("pointer x1000 (compile each time)", len, 200, {
+        for(int i = 0; i < 1000; i ++) {
+            lept_query* p = lept_query_compile(path, strlen(path));
+            sum += lept_get_number(lept_query_first(p, &v));
+            lept_query_free(p);
+        }
+    });
+
+    BENCH("pointer x1000 (compiled once)", len, 200, {
+        for(int i = 0; i < 1000; i ++) {
+            sum += lept_get_number(lept_query_first(q, &v));
+        }
+    });
+
+    BENCH("$[*].geo.lat (by hand)", len, 200, {
+        for(size_t i = 0; i < lept_get_array_size(&v); i ++) {
+            lept_value* geo = lept_find_object_value(lept_get_array_element(&v, i), "geo", 3);
+            sum += lept_get_number(lept_find_object_value(geo, "lat", 3));
+        }
+    });
+
+    BENCH("$[*].geo.lat (query)", len, 200, {
+        lept_query_eval(all, &v, bench_query_sum, &sum);
+    });
+
+    printf("(%g)\n", sum);
+    lept_query_free(q);
+    lept_query_free(all);
+    lept_free(&v);
+    free(json);
+}
+
+/* the records document, built in code instead of parsed */
+static void bench_build(lept_value* v, int n) {
+    char tmp[32];
+    lept_set_array(v, 0);
+    for(int i = 0; i < n; i ++) {
+        lept_value* r = lept_pushback_array_element(v);
+        lept_value* e;
+        lept_set_object(r, 0);
+        lept_set_number(lept_set_object_value(r, "id", 2), i);
+        lept_set_string(lept_set_object_value(r, "name", 4), tmp, sprintf(tmp, "user%d", i));
+        lept_set_boolean(lept_set_object_value(r, "active", 6), i & 1);
+        lept_set_number(lept_set_object_value(r, "score", 5), i * 7 + (i % 10) / 10.0);
+        e = lept_set_object_value(r, "tags", 4);
+        lept_set_array(e, 3);
+        lept_set_string(lept_pushback_array_element(e), "a", 1);
+        lept_set_string(lept_pushback_array_element(e), "bb", 2);
+        lept_set_string(lept_pushback_array_element(e), "ccc", 3);
+        e = lept_set_object_value(r, "geo", 3);
+        lept_set_object(e, 2);
+        lept_set_number(lept_set_object_value(e, "lat", 3), i % 90 + 0.5);
+        lept_set_number(lept_set_object_value(e, "lng", 3), -(i % 180) - 0.25);
+    }
+}
+
+static void bench_build_records() {
+    char* json = bench_records(1000);
+    size_t len = strlen(json);
+    lept_value v;
+
+    BENCH("build records (text + parse)", len, 200, {
+        char* t = bench_records(1000);
+        lept_parse(&v, t);
+        lept_free(&v);
+        free(t);
+    });
+
+    lept_init(&v);
+    BENCH("build records (mutation api)", len, 200, {
+        bench_build(&v, 1000);
+        lept_free(&v);
+    });
+
+    free(json);
+}
+
+static void bench_stringify_number() {
+    char* json = bench_coords(20000);
+    char* out;
+    size_t len;
+    lept_value v;
+
+    lept_parse(&v, json);
+    lept_stringify(&v, &out, &len);
+    free(out);
+
+    BENCH("stringify (coordinates)", len, 50, {
+        lept_stringify(&v, &out, NULL);
+        free(out);
+    });
+
+    lept_free(&v);
+    free(json);
+}
+
+static void bench_stringify_string() {
+    char* json = bench_strings(5000);
+    char* out;
+    size_t len;
+    lept_value v;
+
+    lept_parse(&v, json);
+    lept_stringify(&v, &out, &len);
+    free(out);
+
+    BENCH("stringify (strings)", len, 50, {
+        lept_stringify(&v, &out, NULL);
+        free(out);
+    });
+
+    lept_free(&v);
+    free(json);
+}
+
+static int bench_discard(void* user, const char* s, size_t len) {
+    (void)s;
+    *(size_t*)user += len;
+    return 0;
+}
+
+/* one growing buffer against a fixed one handed to a sink */
+static void bench_stringify_sink() {
+    char* json = bench_records(20000);
+    char* out;
+    size_t len, written = 0;
+    lept_value v;
+
+    lept_parse(&v, json);
+    lept_stringify(&v, &out, &len);
+    free(out);
+
+    BENCH("stringify (records, buffer)", len, 20, {
+        lept_stringify(&v, &out, NULL);
+        free(out);
+    });
+
+    BENCH("stringify (records, sink)", len, 20, {
+        lept_stringify_to(&v, bench_discard, &written);
+    });
+
+    /* measured and allocated once */
+    BENCH("stringify (records, length + into)", len, 20, {
+        size_t n = lept_stringify_length(&v) + 1;
+        out = (char*)malloc(n);
+        lept_stringify_into(&v, out, n, NULL);
+        free(out);
+    });
+
+    /* into a buffer reused across responses */
+    out = (char*)malloc(len + 1);
+    BENCH("stringify (records, pooled into)", len, 20, {
+        lept_stringify_into(&v, out, len + 1, NULL);
+    });
+    free(out);
+
+    lept_free(&v);
+    free(json);
+}
+
+/* a bulk export, written on several threads */
+static void bench_stringify_parallel() {
+    char* json = bench_records(100000);
+    static const int nthreads[] = { 1, 2, 4, 8 };
+    char name[64];
+    char* out;
+    size_t len;
+    lept_value v;
+
+    lept_parse(&v, json);
+    lept_stringify(&v, &out, &len);
+    free(out);
+
+    BENCH("stringify (records, lept_stringify)", len, 5, {
+        lept_stringify(&v, &out, NULL);
+        free(out);
+    });
+
+    for(size_t t = 0; t < sizeof(nthreads) / sizeof(nthreads[0]); t ++) {
+        sprintf(name, "stringify (records, %d threads)", nthreads[t]);
+        BENCH(name, len, 5, {
+            lept_stringify_parallel(&v, &out, NULL, nthreads[t]);
+            free(out);
+        });
+    }
+
+    lept_free(&v);
+    free(json);
+}
+
+/* the same tree as text, CBOR and MessagePack */
+static void bench_binary_doc(const char* doc, char* json) {
+    static const struct {
+        const char* name;
+        int (*encode)(const lept_value*, char**, size_t*);
+        int (*decode)(lept_value*, const char*, size_t);
+    } codecs[] = {
+        { "cbor", lept_encode_cbor, lept_decode_cbor },
+        { "msgpack", lept_encode_msgpack, lept_decode_msgpack },
+    };
+    size_t len = strlen(json), blen;
+    char name[64];
+    char *out, *bin;
+    lept_value v, w;
+
+    lept_parse_n(&v, json, len);
+    printf("%s: json %zu bytes", doc, len);
+    for(size_t i = 0; i < sizeof(codecs) / sizeof(codecs[0]); i ++) {
+        codecs[i].encode(&v, &bin, &blen);
+        printf(", %s %zu bytes", codecs[i].name, blen);
+        free(bin);
+    }
+    printf("\n");
+
+    sprintf(name, "encode (%s, json)", doc);
+    BENCH(name, len, 20, {
+        lept_stringify(&v, &out, NULL);
+        free(out);
+    });
+    sprintf(name, "decode (%s, json)", doc);
+    BENCH(name, len, 20, {
+        lept_parse_n(&w, json, len);
+        lept_free(&w);
+    });
+    for(size_t i = 0; i < sizeof(codecs) / sizeof(codecs[0]); i ++) {
+        codecs[i].encode(&v, &bin, &blen);
+        sprintf(name, "encode (%s, %s)", doc, codecs[i].name);
+        BENCH(name, blen, 20, {
+            codecs[i].encode(&v, &out, NULL);
+            free(out);
+        });
+        sprintf(name, "decode (%s, %s)", doc, codecs[i].name);
+        BENCH(name, blen, 20, {
+            codecs[i].decode(&w, bin, blen);
+            lept_free(&w);
+        });
+        free(bin);
+    }
+
+    lept_free(&v);
+    free(json);
+}
+
+static void bench_binary() {
+    bench_binary_doc("records", bench_records(20000));
+    bench_binary_doc("coords", bench_coords(20000));
+}
+
+/* a handler reading a few fields of a large request body */
+static void bench_parse_lazy() {
+    char* records = bench_records(2000);
+    char* json = (char*)malloc(strlen(records) + 256);
+    size_t len = sprintf(json, "{\"id\":17,\"user\":{\"id\":3,\"name\":\"user3\"},\"items\":%s,"
+        "\"status\":\"open\",\"ts\":1700000000}", records);
+    double sum = 0.0, d;
+    lept_lazy root, f, g;
+    char* s;
+    size_t n;
+
+    BENCH("read 4 fields (lept_parse)", len, 200, {
+        lept_value v;
+        lept_parse_n(&v, json, len);
+        sum += lept_get_number(lept_find_object_value(&v, "id", 2));
+        sum += lept_get_string_length(lept_find_object_value(lept_find_object_value(&v, "user", 4), "name", 4));
+        sum += lept_get_string_length(lept_find_object_value(&v, "status", 6));
+        sum += lept_get_number(lept_find_object_value(&v, "ts", 2));
+        lept_free(&v);
+    });
+
+    BENCH("read 4 fields (lept_lazy)", len, 200, {
+        lept_lazy_init(&root, json, len);
+        lept_lazy_find_field(&root, "id", 2, &f);
+        lept_lazy_get_number(&f, &d);
+        sum += d;
+        lept_lazy_find_field(&root, "user", 4, &f);
+        lept_lazy_find_field(&f, "name", 4, &g);
+        lept_lazy_get_string(&g, &s, &n);
+        sum += n;
+        free(s);
+        lept_lazy_find_field(&root, "status", 6, &f);
+        lept_lazy_get_string(&f, &s, &n);
+        sum += n;
+        free(s);
+        lept_lazy_find_field(&root, "ts", 2, &f);
+        lept_lazy_get_number(&f, &d);
+        sum += d;
+    });
+
+    printf("(%g)\n", sum);
+    free(records);
+    free(json);
+}
+
+/* bytes a tree holds: its nodes, member keys and strings too long to be inline */
+static size_t bench_tree_bytes(const lept_value* v) {
+    size_t n = sizeof(lept_value);
+    if(lept_get_type(v) == LEPT_STRING && lept_get_string_length(v) > LEPT_INLINE_MAX) {
+        n += lept_get_string_length(v) + 1;
+    } else if(lept_get_type(v) == LEPT_ARRAY) {
+        for(size_t i = 0; i < lept_get_array_size(v); i ++) {
+            n += bench_tree_bytes(lept_get_array_element(v, i));
+        }
+    } else if(lept_get_type(v) == LEPT_OBJECT) {
+        for(size_t i = 0; i < lept_get_object_size(v); i ++) {
+            size_t klen = lept_get_object_key_length(v, i);
+            n += sizeof(lept_value) + ((klen > LEPT_INLINE_MAX) ? klen + 1 : 0);
+            n += bench_tree_bytes(lept_get_object_value(v, i));
+        }
+    }
+    return n;
+}
+
+static void bench_parse_projected() {
+    static const char* paths[] = { "/user/id", "/ts", "/items/*/score" };
+    char* records = bench_records(2000);
+    char* json = (char*)malloc(strlen(records) + 256);
+    size_t len = sprintf(json, "{\"id\":17,\"user\":{\"id\":3,\"name\":\"user3\"},\"items\":%s,"
+        "\"status\":\"open\",\"ts\":1700000000}", records);
+    lept_projection* p = lept_projection_compile(paths, 3);
+    size_t full, kept;
+    lept_value v;
+
+    BENCH("parse (records, whole)", len, 200, {
+        lept_parse_n(&v, json, len);
+        lept_free(&v);
+    });
+
+    BENCH("parse (records, 3 paths projected)", len, 200, {
+        lept_parse_projected(&v, json, len, p);
+        lept_free(&v);
+    });
+
+    lept_parse_n(&v, json, len);
+    full = bench_tree_bytes(&v);
+    lept_free(&v);
+    lept_parse_projected(&v, json, len, p);
+    kept = bench_tree_bytes(&v);
+    lept_free(&v);
+    printf("tree: %zu bytes whole, %zu bytes projected\n", full, kept);
+
+    lept_projection_free(p);
+    free(records);
+    free(json);
+}
+
+/* startup: parse the text again, or map the snapshot written once */
+static void bench_snapshot() {
+    const char* path = "leptjson_bench.snapshot";
+    char* json = bench_records(100000);
+    size_t len = strlen(json);
+    double sum = 0.0;
+    lept_snapshot* s;
+    lept_value v;
+    FILE* fp;
+
+    lept_parse_n(&v, json, len);
+    lept_snapshot_write(&v, path);
+    lept_free(&v);
+    if((fp = fopen(path, "rb")) != NULL) {
+        fseek(fp, 0, SEEK_END);
+        printf("records: json %zu bytes, snapshot %ld bytes\n", len, ftell(fp));
+        fclose(fp);
+    }
+
+    BENCH("load (records, lept_parse)", len, 5, {
+        lept_parse_n(&v, json, len);
+        sum += lept_get_number(lept_find_object_value(lept_get_array_element(&v, 5000), "score", 5));
+        lept_free(&v);
+    });
+
+    BENCH("load (records, snapshot)", len, 5, {
+        lept_view e;
+        s = lept_snapshot_open(path);
+        e = lept_view_get_array_element(lept_snapshot_root(s), 5000);
+        sum += lept_view_get_number(lept_view_find_object_value(e, "score", 5));
+        lept_snapshot_close(s);
+    });
+
+    printf("(%g)\n", sum);
+    remove(path);
+    free(json);
+}
+
+/* main */
+
+int main() {
+    bench_parse_arena();
+    bench_parse_scan();
+    bench_parse_insitu();
+    bench_parse_intern();
+    bench_parse_sax();
+    bench_parse_stream();
+    bench_parse_lines();
+    bench_parse_parallel();
+    bench_parse_lazy();
+    bench_parse_projected();
+    bench_parse_engine();
+    bench_parse_deep();
+    bench_parse_number();
+    bench_find_object();
+    bench_query();
+    bench_build_records();
+    bench_stringify_number();
+    bench_stringify_string();
+    bench_stringify_sink();
+    bench_stringify_parallel();
+    bench_binary();
+    bench_snapshot();
+
+    return 0;
+}
@@ -1,29 +1,416 @@
 #include "leptjson.h"
 
 #include <assert.h>  /* assert() */
-#include <stdlib.h>  /* NULL, strtod(), realloc()... */
+#include <stdlib.h>  /* NULL, malloc(), realloc()... */
 #include <string.h>  /* memcpy()... */
-#include <ctype.h>   /* isdigit() */
 #include <math.h>    /* HUGE_VAL */
-#include <errno.h>   /* errno */
+#include <float.h>   /* FLT_EVAL_METHOD */
 #include <stdio.h>
+#include <stdint.h>  /* uintptr_t, uint64_t */
+#include <errno.h>   /* EINTR */
+#ifdef _WIN32
+#include <io.h>      /* _write() */
+#include <windows.h> /* CreateThread() */
+#else
+#include <unistd.h>  /* write(), sysconf() */
+#include <pthread.h> /* pthread_create() */
+#include <fcntl.h>   /* open() */
+#include <sys/mman.h> /* mmap() */
+#include <sys/stat.h> /* fstat() */
+#endif
+
+#if !defined(LEPT_NO_SIMD) && defined(__GNUC__) && defined(__SSE2__)
+#define LEPT_SIMD_SSE2
+#include <emmintrin.h>
+#if defined(__x86_64__) || defined(__i386__)
+#define LEPT_SIMD_AVX2
+#include <immintrin.h>
+#endif
+#endif
 
 #ifndef LEPT_PARSE_STACK_INIT_SIZE
 #define LEPT_PARSE_STACK_INIT_SIZE 256
 #endif
 
+#ifndef LEPT_ARENA_BLOCK_SIZE
+#define LEPT_ARENA_BLOCK_SIZE 65536
+#endif
+
+#ifndef LEPT_PARSE_MAX_DEPTH
+#define LEPT_PARSE_MAX_DEPTH 1024 /* default nesting limit, 0: none */
+#endif
+
+#ifndef LEPT_STRINGIFY_BUFFER_SIZE
+#define LEPT_STRINGIFY_BUFFER_SIZE 4096 /* bytes handed to a sink at a time */
+#endif
+
+#ifndef LEPT_OBJECT_HASH_MIN
+#define LEPT_OBJECT_HASH_MIN 16 /* smaller objects are searched linearly */
+#endif
+
+/* an open array or object */
+typedef struct {
+    size_t size;  /* elements or members so far, binary: items */
+    size_t count; /* binary: items expected, or LEPT_INDEFINITE */
+    char kind;    /* '[' or '{' */
+} lept_level;
+
 typedef struct {
     const char* json;
+    const char* end; /* input is [json, end), not necessarily NUL-terminated */
     char* stack;
     size_t size, top;
+    lept_arena* arena; /* NULL: nodes are malloc()ed */
+    lept_intern* intern; /* NULL: keys are copied like strings */
+    int insitu;        /* strings are decoded in place, over the input */
+    uint32_t* index;   /* structural index, NULL: not built */
+    const uint32_t* index_cur;
+    const char* index_base;
+    const lept_sax_handler* sax; /* events go to sax with user */
+    void* user;
+    lept_level* levels; /* containers being parsed, innermost last */
+    size_t depth, levels_size;
+    size_t max_depth;    /* 0: no limit */
+    lept_engine engine;
+    lept_write_fn write; /* stringify sink, gets the stack with user */
+    size_t flush_at;     /* stack top at which output goes to the sink */
+    int write_ret;
+    int abort_ret;       /* what a SAX call returning non-zero fails with */
+    char* spill;         /* the stack is a caller's buffer, which never grows; NULL: heap */
 } lept_context;
 
+/* arena */
+
+struct lept_arena_block {
+    lept_arena_block* next;
+    size_t size, used;
+    /* payload follows the header */
+};
+
+/* every allocation is rounded up to keep doubles and pointers aligned */
+typedef union {
+    double d;
+    void* p;
+    size_t s;
+} lept_arena_align;
+
+#define LEPT_ARENA_ALIGN(n) \
+    (((n) + sizeof(lept_arena_align) - 1) & ~(sizeof(lept_arena_align) - 1))
+
+void lept_arena_init(lept_arena* a, size_t block_size) {
+    assert(a != NULL);
+    a->head = a->cur = NULL;
+    a->block_size = block_size > 0 ? block_size : LEPT_ARENA_BLOCK_SIZE;
+    a->stack = NULL;
+    a->stack_size = 0;
+}
+
+void lept_arena_reset(lept_arena* a) {
+    assert(a != NULL);
+    /* blocks are kept and reused, the next allocation rewinds to head */
+    a->cur = NULL;
+}
+
+void lept_arena_free(lept_arena* a) {
+    lept_arena_block* b;
+    assert(a != NULL);
+    while((b = a->head) != NULL) {
+        a->head = b->next;
+        free(b);
+    }
+    free(a->stack);
+    lept_arena_init(a, a->block_size);
+}
+
+/* move to the next block able to hold size bytes, allocating it if needed */
+static lept_arena_block* lept_arena_grow(lept_arena* a, size_t size) {
+    lept_arena_block* next = (a->cur != NULL) ? a->cur->next : a->head;
+
+    if(next == NULL || next->size < size) {
+        size_t n = (size > a->block_size) ? size : a->block_size;
+        lept_arena_block* b = (lept_arena_block*)malloc(LEPT_ARENA_ALIGN(sizeof(lept_arena_block)) + n);
+        b->size = n;
+        b->next = next;
+        if(a->cur != NULL) {
+            a->cur->next = b;
+        } else {
+            a->head = b;
+        }
+        next = b;
+    }
+    next->used = 0;
+    a->cur = next;
+
+    return next;
+}
+
+static void* lept_arena_alloc(lept_arena* a, size_t size) {
+    lept_arena_block* b = a->cur;
+    void* ret;
+
+    size = LEPT_ARENA_ALIGN(size);
+    if(b == NULL || b->used + size > b->size) {
+        b = lept_arena_grow(a, size);
+    }
+    ret = (char*)b + LEPT_ARENA_ALIGN(sizeof(lept_arena_block)) + b->used;
+    b->used += size;
+
+    return ret;
+}
+
+/* scan kernels
+ *
+ * lept_skip_whitespace() returns the first byte in [p, end) that is not JSON
+ * whitespace, lept_scan_string() the first '\"', '\\' or control byte; both
+ * return end when there is none. The vector versions handle whole blocks and
+ * leave the tail shorter than a block to the scalar loop.
+ */
+
+#define LEPT_ISWS(ch) ((ch) == ' ' || (ch) == '\t' || (ch) == '\n' || (ch) == '\r')
+
+typedef const char* (*lept_scan_fn)(const char* p, const char* end);
+
+static const char* lept_skip_whitespace_scalar(const char* p, const char* end) {
+    while(p < end && LEPT_ISWS(*p)) {
+        p++;
+    }
+    return p;
+}
+
+static const char* lept_scan_string_scalar(const char* p, const char* end) {
+    while(p < end && *p != '\"' && *p != '\\' && (unsigned char)*p >= 0x20) {
+        p++;
+    }
+    return p;
+}
+
+#ifdef LEPT_SIMD_SSE2
+
+/* bit i set: byte i is whitespace */
+static inline unsigned lept_ws_mask_sse2(__m128i s) {
+    __m128i m = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(s, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(s, _mm_set1_epi8('\t'))),
+        _mm_or_si128(_mm_cmpeq_epi8(s, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(s, _mm_set1_epi8('\r'))));
+    return (unsigned)_mm_movemask_epi8(m);
+}
+
+/* bit i set: byte i is '"', '\\' or below 0x20 */
+static inline unsigned lept_string_mask_sse2(__m128i s) {
+    __m128i m = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(s, _mm_set1_epi8('\"')), _mm_cmpeq_epi8(s, _mm_set1_epi8('\\'))),
+        _mm_cmpeq_epi8(_mm_subs_epu8(s, _mm_set1_epi8(0x1F)), _mm_setzero_si128()));
+    return (unsigned)_mm_movemask_epi8(m);
+}
+
+static const char* lept_skip_whitespace_sse2(const char* p, const char* end) {
+    for(; end - p >= 16; p += 16) {
+        unsigned mask = ~lept_ws_mask_sse2(_mm_loadu_si128((const __m128i*)p)) & 0xFFFF;
+        if(mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+    return lept_skip_whitespace_scalar(p, end);
+}
+
+static const char* lept_scan_string_sse2(const char* p, const char* end) {
+    for(; end - p >= 16; p += 16) {
+        unsigned mask = lept_string_mask_sse2(_mm_loadu_si128((const __m128i*)p));
+        if(mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+    return lept_scan_string_scalar(p, end);
+}
+
+#endif /* LEPT_SIMD_SSE2 */
+
+#ifdef LEPT_SIMD_AVX2
+
+#define LEPT_TARGET_AVX2 __attribute__((target("avx2")))
+
+LEPT_TARGET_AVX2
+static inline unsigned lept_ws_mask_avx2(__m256i s) {
+    __m256i m = _mm256_or_si256(
+        _mm256_or_si256(_mm256_cmpeq_epi8(s, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(s, _mm256_set1_epi8('\t'))),
+        _mm256_or_si256(_mm256_cmpeq_epi8(s, _mm256_set1_epi8('\n')), _mm256_cmpeq_epi8(s, _mm256_set1_epi8('\r'))));
+    return (unsigned)_mm256_movemask_epi8(m);
+}
+
+LEPT_TARGET_AVX2
+static inline unsigned lept_string_mask_avx2(__m256i s) {
+    __m256i m = _mm256_or_si256(
+        _mm256_or_si256(_mm256_cmpeq_epi8(s, _mm256_set1_epi8('\"')), _mm256_cmpeq_epi8(s, _mm256_set1_epi8('\\'))),
+        _mm256_cmpeq_epi8(_mm256_subs_epu8(s, _mm256_set1_epi8(0x1F)), _mm256_setzero_si256()));
+    return (unsigned)_mm256_movemask_epi8(m);
+}
+
+LEPT_TARGET_AVX2
+static const char* lept_skip_whitespace_avx2(const char* p, const char* end) {
+    for(; end - p >= 32; p += 32) {
+        unsigned mask = ~lept_ws_mask_avx2(_mm256_loadu_si256((const __m256i*)p));
+        if(mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+    return lept_skip_whitespace_scalar(p, end);
+}
+
+LEPT_TARGET_AVX2
+static const char* lept_scan_string_avx2(const char* p, const char* end) {
+    for(; end - p >= 32; p += 32) {
+        unsigned mask = lept_string_mask_avx2(_mm256_loadu_si256((const __m256i*)p));
+        if(mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+    return lept_scan_string_scalar(p, end);
+}
+
+#endif /* LEPT_SIMD_AVX2 */
+
+/* classify kernels
+ *
+ * lept_classify() sorts the 64 bytes at p into bit masks, bit i for byte i,
+ * for stage 1 of the structural index.
+ */
+
+typedef struct {
+    uint64_t quote, backslash, ws, op; /* op: one of {}[]:, */
+} lept_block_masks;
+
+typedef void (*lept_classify_fn)(const char* p, lept_block_masks* m);
+
+static void lept_classify_scalar(const char* p, lept_block_masks* m) {
+    m->quote = m->backslash = m->ws = m->op = 0;
+    for(int i = 0; i < 64; i ++) {
+        uint64_t bit = (uint64_t)1 << i;
+        switch(p[i]) {
+            case '\"': m->quote |= bit; break;
+            case '\\': m->backslash |= bit; break;
+            case ' ': case '\t': case '\n': case '\r': m->ws |= bit; break;
+            case '{': case '}': case '[': case ']': case ':': case ',': m->op |= bit; break;
+        }
+    }
+}
+
+#ifdef LEPT_SIMD_SSE2
+
+static void lept_classify_sse2(const char* p, lept_block_masks* m) {
+    m->quote = m->backslash = m->ws = m->op = 0;
+    for(int i = 0; i < 64; i += 16) {
+        __m128i s = _mm_loadu_si128((const __m128i*)(p + i));
+        /* '[' and ']' are '{' and '}' with bit 5 cleared */
+        __m128i l = _mm_or_si128(s, _mm_set1_epi8(0x20));
+        __m128i op = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(l, _mm_set1_epi8('{')), _mm_cmpeq_epi8(l, _mm_set1_epi8('}'))),
+            _mm_or_si128(_mm_cmpeq_epi8(s, _mm_set1_epi8(':')), _mm_cmpeq_epi8(s, _mm_set1_epi8(','))));
+        m->quote |= (uint64_t)(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(s, _mm_set1_epi8('\"'))) << i;
+        m->backslash |= (uint64_t)(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(s, _mm_set1_epi8('\\'))) << i;
+        m->ws |= (uint64_t)lept_ws_mask_sse2(s) << i;
+        m->op |= (uint64_t)(unsigned)_mm_movemask_epi8(op) << i;
+    }
+}
+
+#endif /* LEPT_SIMD_SSE2 */
+
+#ifdef LEPT_SIMD_AVX2
+
+LEPT_TARGET_AVX2
+static void lept_classify_avx2(const char* p, lept_block_masks* m) {
+    m->quote = m->backslash = m->ws = m->op = 0;
+    for(int i = 0; i < 64; i += 32) {
+        __m256i s = _mm256_loadu_si256((const __m256i*)(p + i));
+        __m256i l = _mm256_or_si256(s, _mm256_set1_epi8(0x20));
+        __m256i op = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(l, _mm256_set1_epi8('{')), _mm256_cmpeq_epi8(l, _mm256_set1_epi8('}'))),
+            _mm256_or_si256(_mm256_cmpeq_epi8(s, _mm256_set1_epi8(':')), _mm256_cmpeq_epi8(s, _mm256_set1_epi8(','))));
+        m->quote |= (uint64_t)(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(s, _mm256_set1_epi8('\"'))) << i;
+        m->backslash |= (uint64_t)(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(s, _mm256_set1_epi8('\\'))) << i;
+        m->ws |= (uint64_t)lept_ws_mask_avx2(s) << i;
+        m->op |= (uint64_t)(unsigned)_mm256_movemask_epi8(op) << i;
+    }
+}
+
+#endif /* LEPT_SIMD_AVX2 */
+
+static lept_scan_fn lept_skip_whitespace = NULL;
+static lept_scan_fn lept_scan_string = NULL;
+static lept_classify_fn lept_classify = NULL;
+
+/* pick the widest kernels the running cpu supports */
+static void lept_scan_select() {
+    lept_scan_fn ws = lept_skip_whitespace_scalar, str = lept_scan_string_scalar;
+    lept_classify_fn cls = lept_classify_scalar;
+
+#ifdef LEPT_SIMD_SSE2
+    ws = lept_skip_whitespace_sse2;
+    str = lept_scan_string_sse2;
+    cls = lept_classify_sse2;
+#endif
+#ifdef LEPT_SIMD_AVX2
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2")) {
+        ws = lept_skip_whitespace_avx2;
+        str = lept_scan_string_avx2;
+        cls = lept_classify_avx2;
+    }
+#endif
+
+    lept_classify = cls;
+    lept_skip_whitespace = ws;
+    lept_scan_string = str;
+}
+
+/* once per process, however many threads get here first at the same time */
+#ifdef _WIN32
+static INIT_ONCE lept_scan_once = INIT_ONCE_STATIC_INIT;
+
+static BOOL CALLBACK lept_scan_select_once(PINIT_ONCE once, PVOID arg, PVOID* ctx) {
+    (void)once;
+    (void)arg;
+    (void)ctx;
+    lept_scan_select();
+    return TRUE;
+}
+#else
+static pthread_once_t lept_scan_once = PTHREAD_ONCE_INIT;
+#endif
+
+static void lept_scan_init() {
+#ifdef _WIN32
+    InitOnceExecuteOnce(&lept_scan_once, lept_scan_select_once, NULL, NULL);
+#else
+    pthread_once(&lept_scan_once, lept_scan_select);
+#endif
+}
+
 /* context */
 
-static void lept_context_init(lept_context* c, const char* json) {
+/* the process defaults, each parse takes a copy when it starts */
+static size_t lept_parse_max_depth = LEPT_PARSE_MAX_DEPTH;
+static lept_engine lept_parse_engine = LEPT_ENGINE_RECURSIVE;
+
+static void lept_context_init(lept_context* c, const char* json, size_t len) {
+    lept_scan_init();
     c->json = json;
+    c->end = (json != NULL) ? json + len : NULL;
     c->stack = NULL;
     c->top = c->size = 0;
+    c->arena = NULL;
+    c->intern = NULL;
+    c->insitu = 0;
+    c->index = NULL;
+    c->sax = NULL;
+    c->user = NULL;
+    c->levels = NULL;
+    c->depth = c->levels_size = 0;
+    c->max_depth = lept_parse_max_depth;
+    c->engine = lept_parse_engine;
+    c->write = NULL;
+    c->flush_at = (size_t)-1;
+    c->write_ret = LEPT_STRINGIFY_OK;
+    c->abort_ret = LEPT_PARSE_ABORTED;
+    c->spill = NULL;
 }
 
 static void lept_context_free(lept_context* c) {
@@ -31,10 +418,23 @@ static void lept_context_free(lept_context* c) {
     free(c->stack);
 }
 
+#define LEPT_CONTEXT_SPILL_SIZE 64 /* more than one token pushed at a time */
+
+/* a fixed buffer is full: fail, and let the rest of the output run over the spill area */
+static void lept_context_overflow(lept_context* c) {
+    c->write_ret = LEPT_STRINGIFY_BUFFER_TOO_SMALL;
+    c->stack = c->spill;
+    c->size = LEPT_CONTEXT_SPILL_SIZE;
+    c->top = 0;
+}
+
 static void* lept_context_push(lept_context* c, size_t size) {
     void* ret;
     assert(size > 0);
-    if(c->top + size >= c->size) {
+    if(c->top + size >= c->size && c->spill != NULL) {
+        assert(size < LEPT_CONTEXT_SPILL_SIZE);
+        lept_context_overflow(c);
+    } else if(c->top + size >= c->size) {
         if(c->size == 0) {
             c->size = LEPT_PARSE_STACK_INIT_SIZE;
         }
@@ -64,670 +464,6554 @@ static void* lept_context_pop(lept_context* c, size_t size) {
 #define LEPT_CONTEXT_POP_ALL(c) \
     lept_context_pop((c), c->top) \
 
+/* depth */
+
+void lept_set_max_depth(size_t depth) {
+    lept_parse_max_depth = depth;
+}
+
+size_t lept_get_max_depth() {
+    return lept_parse_max_depth;
+}
+
+/* enter a container, the nesting limit counts every open one */
+static int lept_context_open(lept_context* c, char kind) {
+    if(c->max_depth != 0 && c->depth >= c->max_depth) {
+        return LEPT_PARSE_TOO_DEEP;
+    }
+    if(c->depth == c->levels_size) {
+        c->levels_size = c->levels_size > 0 ? c->levels_size * 2 : 16;
+        c->levels = (lept_level*)realloc(c->levels, c->levels_size * sizeof(lept_level));
+    }
+    c->levels[c->depth].size = 0;
+    c->levels[c->depth].kind = kind;
+    c->depth ++;
+    return LEPT_PARSE_OK;
+}
+
+/* node storage comes from the arena when there is one */
+static void* lept_context_alloc(lept_context* c, size_t size) {
+    return (c->arena != NULL) ? lept_arena_alloc(c->arena, size) : malloc(size);
+}
+
+/* arena nodes are released all at once by lept_arena_reset() */
+#define LEPT_CONTEXT_FLAGS(c) (((c)->arena != NULL) ? LEPT_BORROWED : 0)
+
+/* strings */
+
+#define LEPT_INLINE 0x04 /* lept_value.flags, the string is in small */
+
+#define LEPT_STRING_PTR(v) (((v)->flags & LEPT_INLINE) ? (v)->small : (v)->s)
+#define LEPT_STRING_LEN(v) \
+    (((v)->flags & LEPT_INLINE) ? (size_t)(LEPT_INLINE_MAX - (v)->small[LEPT_INLINE_MAX]) : (size_t)(v)->size)
+
+/* a short string goes into the node, where the length byte doubles as the
+ * '\0' of a string of LEPT_INLINE_MAX */
+static int lept_string_inline(lept_value* v, const char* s, size_t len) {
+    if(len > LEPT_INLINE_MAX) {
+        return 0;
+    }
+    memcpy(v->small, s, len);
+    v->small[len] = '\0';
+    v->small[LEPT_INLINE_MAX] = (char)(LEPT_INLINE_MAX - len);
+    v->type = LEPT_STRING;
+    v->flags = LEPT_INLINE;
+    return 1;
+}
+
+static void lept_context_set_string(lept_context* c, lept_value* v, const char* s, size_t len) {
+    if(lept_string_inline(v, s, len)) {
+        return ;
+    }
+    v->s = (char*)lept_context_alloc(c, len + 1);
+    memcpy(v->s, s, len);
+    v->s[len] = '\0';
+    v->size = (uint32_t)len;
+    v->type = LEPT_STRING;
+    v->flags = LEPT_CONTEXT_FLAGS(c);
+}
+
+/* call the handler of event if there is one, a non-zero return aborts */
+#define LEPT_SAX_CALL(c, event, args) \
+    do { \
+        if((c)->sax->event != NULL && (c)->sax->event args != 0) { \
+            return (c)->abort_ret; \
+        } \
+    } while(0)
+
+/* the byte at p, or '\0' at the end of input */
+#define LEPT_PEEK(c, p) (((p) < (c)->end) ? *(p) : '\0')
+
+/* structural index
+ *
+ * Stage 1 records the offset of every token start outside strings: the
+ * operators {}[]:, the opening quotes, and the first byte of each other run
+ * that follows whitespace or an operator. The byte after any whitespace is
+ * then always an entry, so stage 2, the usual parser, crosses whitespace by
+ * jumping to the next entry. Tokens are still parsed one by one from the
+ * input, which keeps results and errors the same as without the index.
+ */
+
+void lept_set_engine(lept_engine e) {
+    assert(e == LEPT_ENGINE_RECURSIVE || e == LEPT_ENGINE_INDEX);
+    lept_parse_engine = e;
+}
+
+lept_engine lept_get_engine() {
+    return lept_parse_engine;
+}
+
+static int lept_ctz64(uint64_t x) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(x);
+#else
+    int n = 0;
+    while(!(x & 1)) {
+        x >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+/* bit i set: an odd number of quotes at or before byte i */
+static inline uint64_t lept_prefix_xor(uint64_t x) {
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+/* the unescaped quotes of a block, carrying a backslash at its end to the next */
+static uint64_t lept_block_quotes(const lept_block_masks* m, uint64_t* escaped_next) {
+    uint64_t escaped = *escaped_next, bs;
+
+    /* a backslash escapes the next byte unless it is escaped itself */
+    *escaped_next = 0;
+    for(bs = m->backslash; bs != 0; bs &= bs - 1) {
+        int i = lept_ctz64(bs);
+        if(escaped & ((uint64_t)1 << i)) {
+            continue;
+        }
+        if(i == 63) {
+            *escaped_next = 1;
+        } else {
+            escaped |= (uint64_t)1 << (i + 1);
+        }
+    }
+    return m->quote & ~escaped;
+}
+
+static void lept_index_build(lept_context* c) {
+    size_t len = c->end - c->json, n = 0, cap = len / 8 + 64;
+    uint64_t in_string = 0, escaped_next = 0, scalar_prev = 0; /* carried across blocks */
+    uint32_t* index;
+
+    /* offsets are 32-bit, larger inputs go without an index */
+    if(len >= UINT32_MAX) {
+        return ;
+    }
+    index = (uint32_t*)malloc(cap * sizeof(uint32_t));
+
+    for(size_t off = 0; off < len; off += 64) {
+        lept_block_masks m;
+        uint64_t quote, str, scalar, bits;
+
+        if(len - off >= 64) {
+            lept_classify(c->json + off, &m);
+        } else {
+            /* pad the tail with whitespace, which is never indexed */
+            char tail[64];
+            memset(tail, ' ', sizeof(tail));
+            memcpy(tail, c->json + off, len - off);
+            lept_classify(tail, &m);
+        }
+
+        /* str covers each string from its opening quote up to the closing one */
+        quote = lept_block_quotes(&m, &escaped_next);
+        str = lept_prefix_xor(quote) ^ in_string;
+        in_string = (uint64_t)0 - (str >> 63);
+
+        scalar = ~(str | quote | m.ws | m.op);
+        bits = (m.op & ~str) | (quote & str) | (scalar & ~((scalar << 1) | scalar_prev));
+        scalar_prev = scalar >> 63;
+
+        if(n + 64 > cap) {
+            cap += cap >> 1;
+            index = (uint32_t*)realloc(index, cap * sizeof(uint32_t));
+        }
+        for(; bits != 0; bits &= bits - 1) {
+            index[n++] = (uint32_t)(off + lept_ctz64(bits));
+        }
+    }
+    /* sentinel: whitespace at the end runs up to the end */
+    if(n + 1 > cap) {
+        index = (uint32_t*)realloc(index, (cap + 1) * sizeof(uint32_t));
+    }
+    index[n] = (uint32_t)len;
+
+    c->index = index;
+    c->index_cur = index;
+    c->index_base = c->json;
+}
+
+/* the token after the whitespace at p is the next entry past p */
+static const char* lept_index_skip(lept_context* c, const char* p) {
+    const uint32_t* i = c->index_cur;
+    size_t off = p - c->index_base;
+    while(*i <= off) {
+        i++;
+    }
+    c->index_cur = i;
+    return c->index_base + *i;
+}
+
 /* parse ws */
 
 static void lept_parse_whitespace(lept_context* c) {
     const char *p = c->json;
-    while (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')
+    /* most runs are empty or a single byte, keep those off the vector path */
+    if(p < c->end && LEPT_ISWS(*p)) {
         p++;
-    c->json = p;
+        if(p < c->end && LEPT_ISWS(*p)) {
+            p = (c->index != NULL) ? lept_index_skip(c, p) : lept_skip_whitespace(p, c->end);
+        }
+        c->json = p;
+    }
 }
 
 /* parse true, null, false */
 
-static int lept_parse_literal(lept_context* c, lept_value* v, const char* literal, lept_type type) {
+static int lept_parse_literal(lept_context* c, const char* literal, lept_type type) {
   	size_t i;
 
   	assert(*c->json == literal[0]);
 
   	for(i = 0; literal[i]; i ++) {
-  		if(c->json[i] != literal[i]) {
+  		if(c->json + i == c->end || c->json[i] != literal[i]) {
   			return LEPT_PARSE_INVALID_VALUE;
   		}
   	}
     c->json += i;
-    v->type = type;
+    if(type == LEPT_NULL) {
+        LEPT_SAX_CALL(c, null, (c->user));
+    } else {
+        LEPT_SAX_CALL(c, boolean, (c->user, type == LEPT_TRUE));
+    }
 
     return LEPT_PARSE_OK;
 }
 
-/* parse number */
+/* parse number
+ *
+ * The grammar is scanned by hand, accumulating the first 19 significant
+ * digits in w so that the value is w * 10^q. Conversion to double tries, in
+ * order: Clinger's exact fast path (w and 10^q both exact doubles), the
+ * Eisel-Lemire algorithm over a table of 128-bit powers of five, and a
+ * big-decimal conversion for the rare inputs neither can round correctly.
+ * None of them depends on the locale or touches errno.
+ */
 
-static int lept_parse_number(lept_context* c, lept_value* v) {
-    const char* cur_phase = c->json;
-    char* next_phase = NULL;
+#define LEPT_ISDIGIT(ch) ((unsigned)((ch) - '0') < 10)
 
-    assert(*cur_phase == '0' || *cur_phase == '1' || *cur_phase == '2' ||
-        *cur_phase == '3' || *cur_phase == '4' || *cur_phase == '5' ||
-        *cur_phase == '6' || *cur_phase == '7' || *cur_phase == '8' ||
-        *cur_phase == '9' || *cur_phase == '-');
+#define LEPT_NUMBER_FAIL UINT64_MAX /* never the bits of a parsed double */
 
-    if(*cur_phase == '0') {
-    	/* avoid "00.." and hex number(strtod supports "00.." and hex number) */
-        if(cur_phase[1] != '\0' && (cur_phase[1] == '0' || cur_phase[1] == 'x')) {
-            return LEPT_PARSE_INVALID_VALUE;
+#if defined(__SIZEOF_INT128__)
+__extension__ typedef unsigned __int128 lept_uint128;
+#endif
+
+static const double lept_pow10_exact[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/* 5^q for q in [-342, 308], normalized to 128 bits (rounded up for q < 0) */
+static const uint64_t lept_pow5_128[][2] = {
+    { 0xEEF453D6923BD65AULL, 0x113FAA2906A13B3FULL }, /* 5^-342 */
+    { 0x9558B4661B6565F8ULL, 0x4AC7CA59A424C507ULL }, /* 5^-341 */
+    { 0xBAAEE17FA23EBF76ULL, 0x5D79BCF00D2DF649ULL }, /* 5^-340 */
+    { 0xE95A99DF8ACE6F53ULL, 0xF4D82C2C107973DCULL }, /* 5^-339 */
+    { 0x91D8A02BB6C10594ULL, 0x79071B9B8A4BE869ULL }, /* 5^-338 */
+    { 0xB64EC836A47146F9ULL, 0x9748E2826CDEE284ULL }, /* 5^-337 */
+    { 0xE3E27A444D8D98B7ULL, 0xFD1B1B2308169B25ULL }, /* 5^-336 */
+    { 0x8E6D8C6AB0787F72ULL, 0xFE30F0F5E50E20F7ULL }, /* 5^-335 */
+    { 0xB208EF855C969F4FULL, 0xBDBD2D335E51A935ULL }, /* 5^-334 */
+    { 0xDE8B2B66B3BC4723ULL, 0xAD2C788035E61382ULL }, /* 5^-333 */
+    { 0x8B16FB203055AC76ULL, 0x4C3BCB5021AFCC31ULL }, /* 5^-332 */
+    { 0xADDCB9E83C6B1793ULL, 0xDF4ABE242A1BBF3DULL }, /* 5^-331 */
+    { 0xD953E8624B85DD78ULL, 0xD71D6DAD34A2AF0DULL }, /* 5^-330 */
+    { 0x87D4713D6F33AA6BULL, 0x8672648C40E5AD68ULL }, /* 5^-329 */
+    { 0xA9C98D8CCB009506ULL, 0x680EFDAF511F18C2ULL }, /* 5^-328 */
+    { 0xD43BF0EFFDC0BA48ULL, 0x0212BD1B2566DEF2ULL }, /* 5^-327 */
+    { 0x84A57695FE98746DULL, 0x014BB630F7604B57ULL }, /* 5^-326 */
+    { 0xA5CED43B7E3E9188ULL, 0x419EA3BD35385E2DULL }, /* 5^-325 */
+    { 0xCF42894A5DCE35EAULL, 0x52064CAC828675B9ULL }, /* 5^-324 */
+    { 0x818995CE7AA0E1B2ULL, 0x7343EFEBD1940993ULL }, /* 5^-323 */
+    { 0xA1EBFB4219491A1FULL, 0x1014EBE6C5F90BF8ULL }, /* 5^-322 */
+    { 0xCA66FA129F9B60A6ULL, 0xD41A26E077774EF6ULL }, /* 5^-321 */
+    { 0xFD00B897478238D0ULL, 0x8920B098955522B4ULL }, /* 5^-320 */
+    { 0x9E20735E8CB16382ULL, 0x55B46E5F5D5535B0ULL }, /* 5^-319 */
+    { 0xC5A890362FDDBC62ULL, 0xEB2189F734AA831DULL }, /* 5^-318 */
+    { 0xF712B443BBD52B7BULL, 0xA5E9EC7501D523E4ULL }, /* 5^-317 */
+    { 0x9A6BB0AA55653B2DULL, 0x47B233C92125366EULL }, /* 5^-316 */
+    { 0xC1069CD4EABE89F8ULL, 0x999EC0BB696E840AULL }, /* 5^-315 */
+    { 0xF148440A256E2C76ULL, 0xC00670EA43CA250DULL }, /* 5^-314 */
+    { 0x96CD2A865764DBCAULL, 0x380406926A5E5728ULL }, /* 5^-313 */
+    { 0xBC807527ED3E12BCULL, 0xC605083704F5ECF2ULL }, /* 5^-312 */
+    { 0xEBA09271E88D976BULL, 0xF7864A44C633682EULL }, /* 5^-311 */
+    { 0x93445B8731587EA3ULL, 0x7AB3EE6AFBE0211DULL }, /* 5^-310 */
+    { 0xB8157268FDAE9E4CULL, 0x5960EA05BAD82964ULL }, /* 5^-309 */
+    { 0xE61ACF033D1A45DFULL, 0x6FB92487298E33BDULL }, /* 5^-308 */
+    { 0x8FD0C16206306BABULL, 0xA5D3B6D479F8E056ULL }, /* 5^-307 */
+    { 0xB3C4F1BA87BC8696ULL, 0x8F48A4899877186CULL }, /* 5^-306 */
+    { 0xE0B62E2929ABA83CULL, 0x331ACDABFE94DE87ULL }, /* 5^-305 */
+    { 0x8C71DCD9BA0B4925ULL, 0x9FF0C08B7F1D0B14ULL }, /* 5^-304 */
+    { 0xAF8E5410288E1B6FULL, 0x07ECF0AE5EE44DD9ULL }, /* 5^-303 */
+    { 0xDB71E91432B1A24AULL, 0xC9E82CD9F69D6150ULL }, /* 5^-302 */
+    { 0x892731AC9FAF056EULL, 0xBE311C083A225CD2ULL }, /* 5^-301 */
+    { 0xAB70FE17C79AC6CAULL, 0x6DBD630A48AAF406ULL }, /* 5^-300 */
+    { 0xD64D3D9DB981787DULL, 0x092CBBCCDAD5B108ULL }, /* 5^-299 */
+    { 0x85F0468293F0EB4EULL, 0x25BBF56008C58EA5ULL }, /* 5^-298 */
+    { 0xA76C582338ED2621ULL, 0xAF2AF2B80AF6F24EULL }, /* 5^-297 */
+    { 0xD1476E2C07286FAAULL, 0x1AF5AF660DB4AEE1ULL }, /* 5^-296 */
+    { 0x82CCA4DB847945CAULL, 0x50D98D9FC890ED4DULL }, /* 5^-295 */
+    { 0xA37FCE126597973CULL, 0xE50FF107BAB528A0ULL }, /* 5^-294 */
+    { 0xCC5FC196FEFD7D0CULL, 0x1E53ED49A96272C8ULL }, /* 5^-293 */
+    { 0xFF77B1FCBEBCDC4FULL, 0x25E8E89C13BB0F7AULL }, /* 5^-292 */
+    { 0x9FAACF3DF73609B1ULL, 0x77B191618C54E9ACULL }, /* 5^-291 */
+    { 0xC795830D75038C1DULL, 0xD59DF5B9EF6A2417ULL }, /* 5^-290 */
+    { 0xF97AE3D0D2446F25ULL, 0x4B0573286B44AD1DULL }, /* 5^-289 */
+    { 0x9BECCE62836AC577ULL, 0x4EE367F9430AEC32ULL }, /* 5^-288 */
+    { 0xC2E801FB244576D5ULL, 0x229C41F793CDA73FULL }, /* 5^-287 */
+    { 0xF3A20279ED56D48AULL, 0x6B43527578C1110FULL }, /* 5^-286 */
+    { 0x9845418C345644D6ULL, 0x830A13896B78AAA9ULL }, /* 5^-285 */
+    { 0xBE5691EF416BD60CULL, 0x23CC986BC656D553ULL }, /* 5^-284 */
+    { 0xEDEC366B11C6CB8FULL, 0x2CBFBE86B7EC8AA8ULL }, /* 5^-283 */
+    { 0x94B3A202EB1C3F39ULL, 0x7BF7D71432F3D6A9ULL }, /* 5^-282 */
+    { 0xB9E08A83A5E34F07ULL, 0xDAF5CCD93FB0CC53ULL }, /* 5^-281 */
+    { 0xE858AD248F5C22C9ULL, 0xD1B3400F8F9CFF68ULL }, /* 5^-280 */
+    { 0x91376C36D99995BEULL, 0x23100809B9C21FA1ULL }, /* 5^-279 */
+    { 0xB58547448FFFFB2DULL, 0xABD40A0C2832A78AULL }, /* 5^-278 */
+    { 0xE2E69915B3FFF9F9ULL, 0x16C90C8F323F516CULL }, /* 5^-277 */
+    { 0x8DD01FAD907FFC3BULL, 0xAE3DA7D97F6792E3ULL }, /* 5^-276 */
+    { 0xB1442798F49FFB4AULL, 0x99CD11CFDF41779CULL }, /* 5^-275 */
+    { 0xDD95317F31C7FA1DULL, 0x40405643D711D583ULL }, /* 5^-274 */
+    { 0x8A7D3EEF7F1CFC52ULL, 0x482835EA666B2572ULL }, /* 5^-273 */
+    { 0xAD1C8EAB5EE43B66ULL, 0xDA3243650005EECFULL }, /* 5^-272 */
+    { 0xD863B256369D4A40ULL, 0x90BED43E40076A82ULL }, /* 5^-271 */
+    { 0x873E4F75E2224E68ULL, 0x5A7744A6E804A291ULL }, /* 5^-270 */
+    { 0xA90DE3535AAAE202ULL, 0x711515D0A205CB36ULL }, /* 5^-269 */
+    { 0xD3515C2831559A83ULL, 0x0D5A5B44CA873E03ULL }, /* 5^-268 */
+    { 0x8412D9991ED58091ULL, 0xE858790AFE9486C2ULL }, /* 5^-267 */
+    { 0xA5178FFF668AE0B6ULL, 0x626E974DBE39A872ULL }, /* 5^-266 */
+    { 0xCE5D73FF402D98E3ULL, 0xFB0A3D212DC8128FULL }, /* 5^-265 */
+    { 0x80FA687F881C7F8EULL, 0x7CE66634BC9D0B99ULL }, /* 5^-264 */
+    { 0xA139029F6A239F72ULL, 0x1C1FFFC1EBC44E80ULL }, /* 5^-263 */
+    { 0xC987434744AC874EULL, 0xA327FFB266B56220ULL }, /* 5^-262 */
+    { 0xFBE9141915D7A922ULL, 0x4BF1FF9F0062BAA8ULL }, /* 5^-261 */
+    { 0x9D71AC8FADA6C9B5ULL, 0x6F773FC3603DB4A9ULL }, /* 5^-260 */
+    { 0xC4CE17B399107C22ULL, 0xCB550FB4384D21D3ULL }, /* 5^-259 */
+    { 0xF6019DA07F549B2BULL, 0x7E2A53A146606A48ULL }, /* 5^-258 */
+    { 0x99C102844F94E0FBULL, 0x2EDA7444CBFC426DULL }, /* 5^-257 */
+    { 0xC0314325637A1939ULL, 0xFA911155FEFB5308ULL }, /* 5^-256 */
+    { 0xF03D93EEBC589F88ULL, 0x793555AB7EBA27CAULL }, /* 5^-255 */
+    { 0x96267C7535B763B5ULL, 0x4BC1558B2F3458DEULL }, /* 5^-254 */
+    { 0xBBB01B9283253CA2ULL, 0x9EB1AAEDFB016F16ULL }, /* 5^-253 */
+    { 0xEA9C227723EE8BCBULL, 0x465E15A979C1CADCULL }, /* 5^-252 */
+    { 0x92A1958A7675175FULL, 0x0BFACD89EC191EC9ULL }, /* 5^-251 */
+    { 0xB749FAED14125D36ULL, 0xCEF980EC671F667BULL }, /* 5^-250 */
+    { 0xE51C79A85916F484ULL, 0x82B7E12780E7401AULL }, /* 5^-249 */
+    { 0x8F31CC0937AE58D2ULL, 0xD1B2ECB8B0908810ULL }, /* 5^-248 */
+    { 0xB2FE3F0B8599EF07ULL, 0x861FA7E6DCB4AA15ULL }, /* 5^-247 */
+    { 0xDFBDCECE67006AC9ULL, 0x67A791E093E1D49AULL }, /* 5^-246 */
+    { 0x8BD6A141006042BDULL, 0xE0C8BB2C5C6D24E0ULL }, /* 5^-245 */
+    { 0xAECC49914078536DULL, 0x58FAE9F773886E18ULL }, /* 5^-244 */
+    { 0xDA7F5BF590966848ULL, 0xAF39A475506A899EULL }, /* 5^-243 */
+    { 0x888F99797A5E012DULL, 0x6D8406C952429603ULL }, /* 5^-242 */
+    { 0xAAB37FD7D8F58178ULL, 0xC8E5087BA6D33B83ULL }, /* 5^-241 */
+    { 0xD5605FCDCF32E1D6ULL, 0xFB1E4A9A90880A64ULL }, /* 5^-240 */
+    { 0x855C3BE0A17FCD26ULL, 0x5CF2EEA09A55067FULL }, /* 5^-239 */
+    { 0xA6B34AD8C9DFC06FULL, 0xF42FAA48C0EA481EULL }, /* 5^-238 */
+    { 0xD0601D8EFC57B08BULL, 0xF13B94DAF124DA26ULL }, /* 5^-237 */
+    { 0x823C12795DB6CE57ULL, 0x76C53D08D6B70858ULL }, /* 5^-236 */
+    { 0xA2CB1717B52481EDULL, 0x54768C4B0C64CA6EULL }, /* 5^-235 */
+    { 0xCB7DDCDDA26DA268ULL, 0xA9942F5DCF7DFD09ULL }, /* 5^-234 */
+    { 0xFE5D54150B090B02ULL, 0xD3F93B35435D7C4CULL }, /* 5^-233 */
+    { 0x9EFA548D26E5A6E1ULL, 0xC47BC5014A1A6DAFULL }, /* 5^-232 */
+    { 0xC6B8E9B0709F109AULL, 0x359AB6419CA1091BULL }, /* 5^-231 */
+    { 0xF867241C8CC6D4C0ULL, 0xC30163D203C94B62ULL }, /* 5^-230 */
+    { 0x9B407691D7FC44F8ULL, 0x79E0DE63425DCF1DULL }, /* 5^-229 */
+    { 0xC21094364DFB5636ULL, 0x985915FC12F542E4ULL }, /* 5^-228 */
+    { 0xF294B943E17A2BC4ULL, 0x3E6F5B7B17B2939DULL }, /* 5^-227 */
+    { 0x979CF3CA6CEC5B5AULL, 0xA705992CEECF9C42ULL }, /* 5^-226 */
+    { 0xBD8430BD08277231ULL, 0x50C6FF782A838353ULL }, /* 5^-225 */
+    { 0xECE53CEC4A314EBDULL, 0xA4F8BF5635246428ULL }, /* 5^-224 */
+    { 0x940F4613AE5ED136ULL, 0x871B7795E136BE99ULL }, /* 5^-223 */
+    { 0xB913179899F68584ULL, 0x28E2557B59846E3FULL }, /* 5^-222 */
+    { 0xE757DD7EC07426E5ULL, 0x331AEADA2FE589CFULL }, /* 5^-221 */
+    { 0x9096EA6F3848984FULL, 0x3FF0D2C85DEF7621ULL }, /* 5^-220 */
+    { 0xB4BCA50B065ABE63ULL, 0x0FED077A756B53A9ULL }, /* 5^-219 */
+    { 0xE1EBCE4DC7F16DFBULL, 0xD3E8495912C62894ULL }, /* 5^-218 */
+    { 0x8D3360F09CF6E4BDULL, 0x64712DD7ABBBD95CULL }, /* 5^-217 */
+    { 0xB080392CC4349DECULL, 0xBD8D794D96AACFB3ULL }, /* 5^-216 */
+    { 0xDCA04777F541C567ULL, 0xECF0D7A0FC5583A0ULL }, /* 5^-215 */
+    { 0x89E42CAAF9491B60ULL, 0xF41686C49DB57244ULL }, /* 5^-214 */
+    { 0xAC5D37D5B79B6239ULL, 0x311C2875C522CED5ULL }, /* 5^-213 */
+    { 0xD77485CB25823AC7ULL, 0x7D633293366B828BULL }, /* 5^-212 */
+    { 0x86A8D39EF77164BCULL, 0xAE5DFF9C02033197ULL }, /* 5^-211 */
+    { 0xA8530886B54DBDEBULL, 0xD9F57F830283FDFCULL }, /* 5^-210 */
+    { 0xD267CAA862A12D66ULL, 0xD072DF63C324FD7BULL }, /* 5^-209 */
+    { 0x8380DEA93DA4BC60ULL, 0x4247CB9E59F71E6DULL }, /* 5^-208 */
+    { 0xA46116538D0DEB78ULL, 0x52D9BE85F074E608ULL }, /* 5^-207 */
+    { 0xCD795BE870516656ULL, 0x67902E276C921F8BULL }, /* 5^-206 */
+    { 0x806BD9714632DFF6ULL, 0x00BA1CD8A3DB53B6ULL }, /* 5^-205 */
+    { 0xA086CFCD97BF97F3ULL, 0x80E8A40ECCD228A4ULL }, /* 5^-204 */
+    { 0xC8A883C0FDAF7DF0ULL, 0x6122CD128006B2CDULL }, /* 5^-203 */
+    { 0xFAD2A4B13D1B5D6CULL, 0x796B805720085F81ULL }, /* 5^-202 */
+    { 0x9CC3A6EEC6311A63ULL, 0xCBE3303674053BB0ULL }, /* 5^-201 */
+    { 0xC3F490AA77BD60FCULL, 0xBEDBFC4411068A9CULL }, /* 5^-200 */
+    { 0xF4F1B4D515ACB93BULL, 0xEE92FB5515482D44ULL }, /* 5^-199 */
+    { 0x991711052D8BF3C5ULL, 0x751BDD152D4D1C4AULL }, /* 5^-198 */
+    { 0xBF5CD54678EEF0B6ULL, 0xD262D45A78A0635DULL }, /* 5^-197 */
+    { 0xEF340A98172AACE4ULL, 0x86FB897116C87C34ULL }, /* 5^-196 */
+    { 0x9580869F0E7AAC0EULL, 0xD45D35E6AE3D4DA0ULL }, /* 5^-195 */
+    { 0xBAE0A846D2195712ULL, 0x8974836059CCA109ULL }, /* 5^-194 */
+    { 0xE998D258869FACD7ULL, 0x2BD1A438703FC94BULL }, /* 5^-193 */
+    { 0x91FF83775423CC06ULL, 0x7B6306A34627DDCFULL }, /* 5^-192 */
+    { 0xB67F6455292CBF08ULL, 0x1A3BC84C17B1D542ULL }, /* 5^-191 */
+    { 0xE41F3D6A7377EECAULL, 0x20CABA5F1D9E4A93ULL }, /* 5^-190 */
+    { 0x8E938662882AF53EULL, 0x547EB47B7282EE9CULL }, /* 5^-189 */
+    { 0xB23867FB2A35B28DULL, 0xE99E619A4F23AA43ULL }, /* 5^-188 */
+    { 0xDEC681F9F4C31F31ULL, 0x6405FA00E2EC94D4ULL }, /* 5^-187 */
+    { 0x8B3C113C38F9F37EULL, 0xDE83BC408DD3DD04ULL }, /* 5^-186 */
+    { 0xAE0B158B4738705EULL, 0x9624AB50B148D445ULL }, /* 5^-185 */
+    { 0xD98DDAEE19068C76ULL, 0x3BADD624DD9B0957ULL }, /* 5^-184 */
+    { 0x87F8A8D4CFA417C9ULL, 0xE54CA5D70A80E5D6ULL }, /* 5^-183 */
+    { 0xA9F6D30A038D1DBCULL, 0x5E9FCF4CCD211F4CULL }, /* 5^-182 */
+    { 0xD47487CC8470652BULL, 0x7647C3200069671FULL }, /* 5^-181 */
+    { 0x84C8D4DFD2C63F3BULL, 0x29ECD9F40041E073ULL }, /* 5^-180 */
+    { 0xA5FB0A17C777CF09ULL, 0xF468107100525890ULL }, /* 5^-179 */
+    { 0xCF79CC9DB955C2CCULL, 0x7182148D4066EEB4ULL }, /* 5^-178 */
+    { 0x81AC1FE293D599BFULL, 0xC6F14CD848405530ULL }, /* 5^-177 */
+    { 0xA21727DB38CB002FULL, 0xB8ADA00E5A506A7CULL }, /* 5^-176 */
+    { 0xCA9CF1D206FDC03BULL, 0xA6D90811F0E4851CULL }, /* 5^-175 */
+    { 0xFD442E4688BD304AULL, 0x908F4A166D1DA663ULL }, /* 5^-174 */
+    { 0x9E4A9CEC15763E2EULL, 0x9A598E4E043287FEULL }, /* 5^-173 */
+    { 0xC5DD44271AD3CDBAULL, 0x40EFF1E1853F29FDULL }, /* 5^-172 */
+    { 0xF7549530E188C128ULL, 0xD12BEE59E68EF47CULL }, /* 5^-171 */
+    { 0x9A94DD3E8CF578B9ULL, 0x82BB74F8301958CEULL }, /* 5^-170 */
+    { 0xC13A148E3032D6E7ULL, 0xE36A52363C1FAF01ULL }, /* 5^-169 */
+    { 0xF18899B1BC3F8CA1ULL, 0xDC44E6C3CB279AC1ULL }, /* 5^-168 */
+    { 0x96F5600F15A7B7E5ULL, 0x29AB103A5EF8C0B9ULL }, /* 5^-167 */
+    { 0xBCB2B812DB11A5DEULL, 0x7415D448F6B6F0E7ULL }, /* 5^-166 */
+    { 0xEBDF661791D60F56ULL, 0x111B495B3464AD21ULL }, /* 5^-165 */
+    { 0x936B9FCEBB25C995ULL, 0xCAB10DD900BEEC34ULL }, /* 5^-164 */
+    { 0xB84687C269EF3BFBULL, 0x3D5D514F40EEA742ULL }, /* 5^-163 */
+    { 0xE65829B3046B0AFAULL, 0x0CB4A5A3112A5112ULL }, /* 5^-162 */
+    { 0x8FF71A0FE2C2E6DCULL, 0x47F0E785EABA72ABULL }, /* 5^-161 */
+    { 0xB3F4E093DB73A093ULL, 0x59ED216765690F56ULL }, /* 5^-160 */
+    { 0xE0F218B8D25088B8ULL, 0x306869C13EC3532CULL }, /* 5^-159 */
+    { 0x8C974F7383725573ULL, 0x1E414218C73A13FBULL }, /* 5^-158 */
+    { 0xAFBD2350644EEACFULL, 0xE5D1929EF90898FAULL }, /* 5^-157 */
+    { 0xDBAC6C247D62A583ULL, 0xDF45F746B74ABF39ULL }, /* 5^-156 */
+    { 0x894BC396CE5DA772ULL, 0x6B8BBA8C328EB783ULL }, /* 5^-155 */
+    { 0xAB9EB47C81F5114FULL, 0x066EA92F3F326564ULL }, /* 5^-154 */
+    { 0xD686619BA27255A2ULL, 0xC80A537B0EFEFEBDULL }, /* 5^-153 */
+    { 0x8613FD0145877585ULL, 0xBD06742CE95F5F36ULL }, /* 5^-152 */
+    { 0xA798FC4196E952E7ULL, 0x2C48113823B73704ULL }, /* 5^-151 */
+    { 0xD17F3B51FCA3A7A0ULL, 0xF75A15862CA504C5ULL }, /* 5^-150 */
+    { 0x82EF85133DE648C4ULL, 0x9A984D73DBE722FBULL }, /* 5^-149 */
+    { 0xA3AB66580D5FDAF5ULL, 0xC13E60D0D2E0EBBAULL }, /* 5^-148 */
+    { 0xCC963FEE10B7D1B3ULL, 0x318DF905079926A8ULL }, /* 5^-147 */
+    { 0xFFBBCFE994E5C61FULL, 0xFDF17746497F7052ULL }, /* 5^-146 */
+    { 0x9FD561F1FD0F9BD3ULL, 0xFEB6EA8BEDEFA633ULL }, /* 5^-145 */
+    { 0xC7CABA6E7C5382C8ULL, 0xFE64A52EE96B8FC0ULL }, /* 5^-144 */
+    { 0xF9BD690A1B68637BULL, 0x3DFDCE7AA3C673B0ULL }, /* 5^-143 */
+    { 0x9C1661A651213E2DULL, 0x06BEA10CA65C084EULL }, /* 5^-142 */
+    { 0xC31BFA0FE5698DB8ULL, 0x486E494FCFF30A62ULL }, /* 5^-141 */
+    { 0xF3E2F893DEC3F126ULL, 0x5A89DBA3C3EFCCFAULL }, /* 5^-140 */
+    { 0x986DDB5C6B3A76B7ULL, 0xF89629465A75E01CULL }, /* 5^-139 */
+    { 0xBE89523386091465ULL, 0xF6BBB397F1135823ULL }, /* 5^-138 */
+    { 0xEE2BA6C0678B597FULL, 0x746AA07DED582E2CULL }, /* 5^-137 */
+    { 0x94DB483840B717EFULL, 0xA8C2A44EB4571CDCULL }, /* 5^-136 */
+    { 0xBA121A4650E4DDEBULL, 0x92F34D62616CE413ULL }, /* 5^-135 */
+    { 0xE896A0D7E51E1566ULL, 0x77B020BAF9C81D17ULL }, /* 5^-134 */
+    { 0x915E2486EF32CD60ULL, 0x0ACE1474DC1D122EULL }, /* 5^-133 */
+    { 0xB5B5ADA8AAFF80B8ULL, 0x0D819992132456BAULL }, /* 5^-132 */
+    { 0xE3231912D5BF60E6ULL, 0x10E1FFF697ED6C69ULL }, /* 5^-131 */
+    { 0x8DF5EFABC5979C8FULL, 0xCA8D3FFA1EF463C1ULL }, /* 5^-130 */
+    { 0xB1736B96B6FD83B3ULL, 0xBD308FF8A6B17CB2ULL }, /* 5^-129 */
+    { 0xDDD0467C64BCE4A0ULL, 0xAC7CB3F6D05DDBDEULL }, /* 5^-128 */
+    { 0x8AA22C0DBEF60EE4ULL, 0x6BCDF07A423AA96BULL }, /* 5^-127 */
+    { 0xAD4AB7112EB3929DULL, 0x86C16C98D2C953C6ULL }, /* 5^-126 */
+    { 0xD89D64D57A607744ULL, 0xE871C7BF077BA8B7ULL }, /* 5^-125 */
+    { 0x87625F056C7C4A8BULL, 0x11471CD764AD4972ULL }, /* 5^-124 */
+    { 0xA93AF6C6C79B5D2DULL, 0xD598E40D3DD89BCFULL }, /* 5^-123 */
+    { 0xD389B47879823479ULL, 0x4AFF1D108D4EC2C3ULL }, /* 5^-122 */
+    { 0x843610CB4BF160CBULL, 0xCEDF722A585139BAULL }, /* 5^-121 */
+    { 0xA54394FE1EEDB8FEULL, 0xC2974EB4EE658828ULL }, /* 5^-120 */
+    { 0xCE947A3DA6A9273EULL, 0x733D226229FEEA32ULL }, /* 5^-119 */
+    { 0x811CCC668829B887ULL, 0x0806357D5A3F525FULL }, /* 5^-118 */
+    { 0xA163FF802A3426A8ULL, 0xCA07C2DCB0CF26F7ULL }, /* 5^-117 */
+    { 0xC9BCFF6034C13052ULL, 0xFC89B393DD02F0B5ULL }, /* 5^-116 */
+    { 0xFC2C3F3841F17C67ULL, 0xBBAC2078D443ACE2ULL }, /* 5^-115 */
+    { 0x9D9BA7832936EDC0ULL, 0xD54B944B84AA4C0DULL }, /* 5^-114 */
+    { 0xC5029163F384A931ULL, 0x0A9E795E65D4DF11ULL }, /* 5^-113 */
+    { 0xF64335BCF065D37DULL, 0x4D4617B5FF4A16D5ULL }, /* 5^-112 */
+    { 0x99EA0196163FA42EULL, 0x504BCED1BF8E4E45ULL }, /* 5^-111 */
+    { 0xC06481FB9BCF8D39ULL, 0xE45EC2862F71E1D6ULL }, /* 5^-110 */
+    { 0xF07DA27A82C37088ULL, 0x5D767327BB4E5A4CULL }, /* 5^-109 */
+    { 0x964E858C91BA2655ULL, 0x3A6A07F8D510F86FULL }, /* 5^-108 */
+    { 0xBBE226EFB628AFEAULL, 0x890489F70A55368BULL }, /* 5^-107 */
+    { 0xEADAB0ABA3B2DBE5ULL, 0x2B45AC74CCEA842EULL }, /* 5^-106 */
+    { 0x92C8AE6B464FC96FULL, 0x3B0B8BC90012929DULL }, /* 5^-105 */
+    { 0xB77ADA0617E3BBCBULL, 0x09CE6EBB40173744ULL }, /* 5^-104 */
+    { 0xE55990879DDCAABDULL, 0xCC420A6A101D0515ULL }, /* 5^-103 */
+    { 0x8F57FA54C2A9EAB6ULL, 0x9FA946824A12232DULL }, /* 5^-102 */
+    { 0xB32DF8E9F3546564ULL, 0x47939822DC96ABF9ULL }, /* 5^-101 */
+    { 0xDFF9772470297EBDULL, 0x59787E2B93BC56F7ULL }, /* 5^-100 */
+    { 0x8BFBEA76C619EF36ULL, 0x57EB4EDB3C55B65AULL }, /* 5^-99 */
+    { 0xAEFAE51477A06B03ULL, 0xEDE622920B6B23F1ULL }, /* 5^-98 */
+    { 0xDAB99E59958885C4ULL, 0xE95FAB368E45ECEDULL }, /* 5^-97 */
+    { 0x88B402F7FD75539BULL, 0x11DBCB0218EBB414ULL }, /* 5^-96 */
+    { 0xAAE103B5FCD2A881ULL, 0xD652BDC29F26A119ULL }, /* 5^-95 */
+    { 0xD59944A37C0752A2ULL, 0x4BE76D3346F0495FULL }, /* 5^-94 */
+    { 0x857FCAE62D8493A5ULL, 0x6F70A4400C562DDBULL }, /* 5^-93 */
+    { 0xA6DFBD9FB8E5B88EULL, 0xCB4CCD500F6BB952ULL }, /* 5^-92 */
+    { 0xD097AD07A71F26B2ULL, 0x7E2000A41346A7A7ULL }, /* 5^-91 */
+    { 0x825ECC24C873782FULL, 0x8ED400668C0C28C8ULL }, /* 5^-90 */
+    { 0xA2F67F2DFA90563BULL, 0x728900802F0F32FAULL }, /* 5^-89 */
+    { 0xCBB41EF979346BCAULL, 0x4F2B40A03AD2FFB9ULL }, /* 5^-88 */
+    { 0xFEA126B7D78186BCULL, 0xE2F610C84987BFA8ULL }, /* 5^-87 */
+    { 0x9F24B832E6B0F436ULL, 0x0DD9CA7D2DF4D7C9ULL }, /* 5^-86 */
+    { 0xC6EDE63FA05D3143ULL, 0x91503D1C79720DBBULL }, /* 5^-85 */
+    { 0xF8A95FCF88747D94ULL, 0x75A44C6397CE912AULL }, /* 5^-84 */
+    { 0x9B69DBE1B548CE7CULL, 0xC986AFBE3EE11ABAULL }, /* 5^-83 */
+    { 0xC24452DA229B021BULL, 0xFBE85BADCE996168ULL }, /* 5^-82 */
+    { 0xF2D56790AB41C2A2ULL, 0xFAE27299423FB9C3ULL }, /* 5^-81 */
+    { 0x97C560BA6B0919A5ULL, 0xDCCD879FC967D41AULL }, /* 5^-80 */
+    { 0xBDB6B8E905CB600FULL, 0x5400E987BBC1C920ULL }, /* 5^-79 */
+    { 0xED246723473E3813ULL, 0x290123E9AAB23B68ULL }, /* 5^-78 */
+    { 0x9436C0760C86E30BULL, 0xF9A0B6720AAF6521ULL }, /* 5^-77 */
+    { 0xB94470938FA89BCEULL, 0xF808E40E8D5B3E69ULL }, /* 5^-76 */
+    { 0xE7958CB87392C2C2ULL, 0xB60B1D1230B20E04ULL }, /* 5^-75 */
+    { 0x90BD77F3483BB9B9ULL, 0xB1C6F22B5E6F48C2ULL }, /* 5^-74 */
+    { 0xB4ECD5F01A4AA828ULL, 0x1E38AEB6360B1AF3ULL }, /* 5^-73 */
+    { 0xE2280B6C20DD5232ULL, 0x25C6DA63C38DE1B0ULL }, /* 5^-72 */
+    { 0x8D590723948A535FULL, 0x579C487E5A38AD0EULL }, /* 5^-71 */
+    { 0xB0AF48EC79ACE837ULL, 0x2D835A9DF0C6D851ULL }, /* 5^-70 */
+    { 0xDCDB1B2798182244ULL, 0xF8E431456CF88E65ULL }, /* 5^-69 */
+    { 0x8A08F0F8BF0F156BULL, 0x1B8E9ECB641B58FFULL }, /* 5^-68 */
+    { 0xAC8B2D36EED2DAC5ULL, 0xE272467E3D222F3FULL }, /* 5^-67 */
+    { 0xD7ADF884AA879177ULL, 0x5B0ED81DCC6ABB0FULL }, /* 5^-66 */
+    { 0x86CCBB52EA94BAEAULL, 0x98E947129FC2B4E9ULL }, /* 5^-65 */
+    { 0xA87FEA27A539E9A5ULL, 0x3F2398D747B36224ULL }, /* 5^-64 */
+    { 0xD29FE4B18E88640EULL, 0x8EEC7F0D19A03AADULL }, /* 5^-63 */
+    { 0x83A3EEEEF9153E89ULL, 0x1953CF68300424ACULL }, /* 5^-62 */
+    { 0xA48CEAAAB75A8E2BULL, 0x5FA8C3423C052DD7ULL }, /* 5^-61 */
+    { 0xCDB02555653131B6ULL, 0x3792F412CB06794DULL }, /* 5^-60 */
+    { 0x808E17555F3EBF11ULL, 0xE2BBD88BBEE40BD0ULL }, /* 5^-59 */
+    { 0xA0B19D2AB70E6ED6ULL, 0x5B6ACEAEAE9D0EC4ULL }, /* 5^-58 */
+    { 0xC8DE047564D20A8BULL, 0xF245825A5A445275ULL }, /* 5^-57 */
+    { 0xFB158592BE068D2EULL, 0xEED6E2F0F0D56712ULL }, /* 5^-56 */
+    { 0x9CED737BB6C4183DULL, 0x55464DD69685606BULL }, /* 5^-55 */
+    { 0xC428D05AA4751E4CULL, 0xAA97E14C3C26B886ULL }, /* 5^-54 */
+    { 0xF53304714D9265DFULL, 0xD53DD99F4B3066A8ULL }, /* 5^-53 */
+    { 0x993FE2C6D07B7FABULL, 0xE546A8038EFE4029ULL }, /* 5^-52 */
+    { 0xBF8FDB78849A5F96ULL, 0xDE98520472BDD033ULL }, /* 5^-51 */
+    { 0xEF73D256A5C0F77CULL, 0x963E66858F6D4440ULL }, /* 5^-50 */
+    { 0x95A8637627989AADULL, 0xDDE7001379A44AA8ULL }, /* 5^-49 */
+    { 0xBB127C53B17EC159ULL, 0x5560C018580D5D52ULL }, /* 5^-48 */
+    { 0xE9D71B689DDE71AFULL, 0xAAB8F01E6E10B4A6ULL }, /* 5^-47 */
+    { 0x9226712162AB070DULL, 0xCAB3961304CA70E8ULL }, /* 5^-46 */
+    { 0xB6B00D69BB55C8D1ULL, 0x3D607B97C5FD0D22ULL }, /* 5^-45 */
+    { 0xE45C10C42A2B3B05ULL, 0x8CB89A7DB77C506AULL }, /* 5^-44 */
+    { 0x8EB98A7A9A5B04E3ULL, 0x77F3608E92ADB242ULL }, /* 5^-43 */
+    { 0xB267ED1940F1C61CULL, 0x55F038B237591ED3ULL }, /* 5^-42 */
+    { 0xDF01E85F912E37A3ULL, 0x6B6C46DEC52F6688ULL }, /* 5^-41 */
+    { 0x8B61313BBABCE2C6ULL, 0x2323AC4B3B3DA015ULL }, /* 5^-40 */
+    { 0xAE397D8AA96C1B77ULL, 0xABEC975E0A0D081AULL }, /* 5^-39 */
+    { 0xD9C7DCED53C72255ULL, 0x96E7BD358C904A21ULL }, /* 5^-38 */
+    { 0x881CEA14545C7575ULL, 0x7E50D64177DA2E54ULL }, /* 5^-37 */
+    { 0xAA242499697392D2ULL, 0xDDE50BD1D5D0B9E9ULL }, /* 5^-36 */
+    { 0xD4AD2DBFC3D07787ULL, 0x955E4EC64B44E864ULL }, /* 5^-35 */
+    { 0x84EC3C97DA624AB4ULL, 0xBD5AF13BEF0B113EULL }, /* 5^-34 */
+    { 0xA6274BBDD0FADD61ULL, 0xECB1AD8AEACDD58EULL }, /* 5^-33 */
+    { 0xCFB11EAD453994BAULL, 0x67DE18EDA5814AF2ULL }, /* 5^-32 */
+    { 0x81CEB32C4B43FCF4ULL, 0x80EACF948770CED7ULL }, /* 5^-31 */
+    { 0xA2425FF75E14FC31ULL, 0xA1258379A94D028DULL }, /* 5^-30 */
+    { 0xCAD2F7F5359A3B3EULL, 0x096EE45813A04330ULL }, /* 5^-29 */
+    { 0xFD87B5F28300CA0DULL, 0x8BCA9D6E188853FCULL }, /* 5^-28 */
+    { 0x9E74D1B791E07E48ULL, 0x775EA264CF55347EULL }, /* 5^-27 */
+    { 0xC612062576589DDAULL, 0x95364AFE032A819EULL }, /* 5^-26 */
+    { 0xF79687AED3EEC551ULL, 0x3A83DDBD83F52205ULL }, /* 5^-25 */
+    { 0x9ABE14CD44753B52ULL, 0xC4926A9672793543ULL }, /* 5^-24 */
+    { 0xC16D9A0095928A27ULL, 0x75B7053C0F178294ULL }, /* 5^-23 */
+    { 0xF1C90080BAF72CB1ULL, 0x5324C68B12DD6339ULL }, /* 5^-22 */
+    { 0x971DA05074DA7BEEULL, 0xD3F6FC16EBCA5E04ULL }, /* 5^-21 */
+    { 0xBCE5086492111AEAULL, 0x88F4BB1CA6BCF585ULL }, /* 5^-20 */
+    { 0xEC1E4A7DB69561A5ULL, 0x2B31E9E3D06C32E6ULL }, /* 5^-19 */
+    { 0x9392EE8E921D5D07ULL, 0x3AFF322E62439FD0ULL }, /* 5^-18 */
+    { 0xB877AA3236A4B449ULL, 0x09BEFEB9FAD487C3ULL }, /* 5^-17 */
+    { 0xE69594BEC44DE15BULL, 0x4C2EBE687989A9B4ULL }, /* 5^-16 */
+    { 0x901D7CF73AB0ACD9ULL, 0x0F9D37014BF60A11ULL }, /* 5^-15 */
+    { 0xB424DC35095CD80FULL, 0x538484C19EF38C95ULL }, /* 5^-14 */
+    { 0xE12E13424BB40E13ULL, 0x2865A5F206B06FBAULL }, /* 5^-13 */
+    { 0x8CBCCC096F5088CBULL, 0xF93F87B7442E45D4ULL }, /* 5^-12 */
+    { 0xAFEBFF0BCB24AAFEULL, 0xF78F69A51539D749ULL }, /* 5^-11 */
+    { 0xDBE6FECEBDEDD5BEULL, 0xB573440E5A884D1CULL }, /* 5^-10 */
+    { 0x89705F4136B4A597ULL, 0x31680A88F8953031ULL }, /* 5^-9 */
+    { 0xABCC77118461CEFCULL, 0xFDC20D2B36BA7C3EULL }, /* 5^-8 */
+    { 0xD6BF94D5E57A42BCULL, 0x3D32907604691B4DULL }, /* 5^-7 */
+    { 0x8637BD05AF6C69B5ULL, 0xA63F9A49C2C1B110ULL }, /* 5^-6 */
+    { 0xA7C5AC471B478423ULL, 0x0FCF80DC33721D54ULL }, /* 5^-5 */
+    { 0xD1B71758E219652BULL, 0xD3C36113404EA4A9ULL }, /* 5^-4 */
+    { 0x83126E978D4FDF3BULL, 0x645A1CAC083126EAULL }, /* 5^-3 */
+    { 0xA3D70A3D70A3D70AULL, 0x3D70A3D70A3D70A4ULL }, /* 5^-2 */
+    { 0xCCCCCCCCCCCCCCCCULL, 0xCCCCCCCCCCCCCCCDULL }, /* 5^-1 */
+    { 0x8000000000000000ULL, 0x0000000000000000ULL }, /* 5^0 */
+    { 0xA000000000000000ULL, 0x0000000000000000ULL }, /* 5^1 */
+    { 0xC800000000000000ULL, 0x0000000000000000ULL }, /* 5^2 */
+    { 0xFA00000000000000ULL, 0x0000000000000000ULL }, /* 5^3 */
+    { 0x9C40000000000000ULL, 0x0000000000000000ULL }, /* 5^4 */
+    { 0xC350000000000000ULL, 0x0000000000000000ULL }, /* 5^5 */
+    { 0xF424000000000000ULL, 0x0000000000000000ULL }, /* 5^6 */
+    { 0x9896800000000000ULL, 0x0000000000000000ULL }, /* 5^7 */
+    { 0xBEBC200000000000ULL, 0x0000000000000000ULL }, /* 5^8 */
+    { 0xEE6B280000000000ULL, 0x0000000000000000ULL }, /* 5^9 */
+    { 0x9502F90000000000ULL, 0x0000000000000000ULL }, /* 5^10 */
+    { 0xBA43B74000000000ULL, 0x0000000000000000ULL }, /* 5^11 */
+    { 0xE8D4A51000000000ULL, 0x0000000000000000ULL }, /* 5^12 */
+    { 0x9184E72A00000000ULL, 0x0000000000000000ULL }, /* 5^13 */
+    { 0xB5E620F480000000ULL, 0x0000000000000000ULL }, /* 5^14 */
+    { 0xE35FA931A0000000ULL, 0x0000000000000000ULL }, /* 5^15 */
+    { 0x8E1BC9BF04000000ULL, 0x0000000000000000ULL }, /* 5^16 */
+    { 0xB1A2BC2EC5000000ULL, 0x0000000000000000ULL }, /* 5^17 */
+    { 0xDE0B6B3A76400000ULL, 0x0000000000000000ULL }, /* 5^18 */
+    { 0x8AC7230489E80000ULL, 0x0000000000000000ULL }, /* 5^19 */
+    { 0xAD78EBC5AC620000ULL, 0x0000000000000000ULL }, /* 5^20 */
+    { 0xD8D726B7177A8000ULL, 0x0000000000000000ULL }, /* 5^21 */
+    { 0x878678326EAC9000ULL, 0x0000000000000000ULL }, /* 5^22 */
+    { 0xA968163F0A57B400ULL, 0x0000000000000000ULL }, /* 5^23 */
+    { 0xD3C21BCECCEDA100ULL, 0x0000000000000000ULL }, /* 5^24 */
+    { 0x84595161401484A0ULL, 0x0000000000000000ULL }, /* 5^25 */
+    { 0xA56FA5B99019A5C8ULL, 0x0000000000000000ULL }, /* 5^26 */
+    { 0xCECB8F27F4200F3AULL, 0x0000000000000000ULL }, /* 5^27 */
+    { 0x813F3978F8940984ULL, 0x4000000000000000ULL }, /* 5^28 */
+    { 0xA18F07D736B90BE5ULL, 0x5000000000000000ULL }, /* 5^29 */
+    { 0xC9F2C9CD04674EDEULL, 0xA400000000000000ULL }, /* 5^30 */
+    { 0xFC6F7C4045812296ULL, 0x4D00000000000000ULL }, /* 5^31 */
+    { 0x9DC5ADA82B70B59DULL, 0xF020000000000000ULL }, /* 5^32 */
+    { 0xC5371912364CE305ULL, 0x6C28000000000000ULL }, /* 5^33 */
+    { 0xF684DF56C3E01BC6ULL, 0xC732000000000000ULL }, /* 5^34 */
+    { 0x9A130B963A6C115CULL, 0x3C7F400000000000ULL }, /* 5^35 */
+    { 0xC097CE7BC90715B3ULL, 0x4B9F100000000000ULL }, /* 5^36 */
+    { 0xF0BDC21ABB48DB20ULL, 0x1E86D40000000000ULL }, /* 5^37 */
+    { 0x96769950B50D88F4ULL, 0x1314448000000000ULL }, /* 5^38 */
+    { 0xBC143FA4E250EB31ULL, 0x17D955A000000000ULL }, /* 5^39 */
+    { 0xEB194F8E1AE525FDULL, 0x5DCFAB0800000000ULL }, /* 5^40 */
+    { 0x92EFD1B8D0CF37BEULL, 0x5AA1CAE500000000ULL }, /* 5^41 */
+    { 0xB7ABC627050305ADULL, 0xF14A3D9E40000000ULL }, /* 5^42 */
+    { 0xE596B7B0C643C719ULL, 0x6D9CCD05D0000000ULL }, /* 5^43 */
+    { 0x8F7E32CE7BEA5C6FULL, 0xE4820023A2000000ULL }, /* 5^44 */
+    { 0xB35DBF821AE4F38BULL, 0xDDA2802C8A800000ULL }, /* 5^45 */
+    { 0xE0352F62A19E306EULL, 0xD50B2037AD200000ULL }, /* 5^46 */
+    { 0x8C213D9DA502DE45ULL, 0x4526F422CC340000ULL }, /* 5^47 */
+    { 0xAF298D050E4395D6ULL, 0x9670B12B7F410000ULL }, /* 5^48 */
+    { 0xDAF3F04651D47B4CULL, 0x3C0CDD765F114000ULL }, /* 5^49 */
+    { 0x88D8762BF324CD0FULL, 0xA5880A69FB6AC800ULL }, /* 5^50 */
+    { 0xAB0E93B6EFEE0053ULL, 0x8EEA0D047A457A00ULL }, /* 5^51 */
+    { 0xD5D238A4ABE98068ULL, 0x72A4904598D6D880ULL }, /* 5^52 */
+    { 0x85A36366EB71F041ULL, 0x47A6DA2B7F864750ULL }, /* 5^53 */
+    { 0xA70C3C40A64E6C51ULL, 0x999090B65F67D924ULL }, /* 5^54 */
+    { 0xD0CF4B50CFE20765ULL, 0xFFF4B4E3F741CF6DULL }, /* 5^55 */
+    { 0x82818F1281ED449FULL, 0xBFF8F10E7A8921A4ULL }, /* 5^56 */
+    { 0xA321F2D7226895C7ULL, 0xAFF72D52192B6A0DULL }, /* 5^57 */
+    { 0xCBEA6F8CEB02BB39ULL, 0x9BF4F8A69F764490ULL }, /* 5^58 */
+    { 0xFEE50B7025C36A08ULL, 0x02F236D04753D5B4ULL }, /* 5^59 */
+    { 0x9F4F2726179A2245ULL, 0x01D762422C946590ULL }, /* 5^60 */
+    { 0xC722F0EF9D80AAD6ULL, 0x424D3AD2B7B97EF5ULL }, /* 5^61 */
+    { 0xF8EBAD2B84E0D58BULL, 0xD2E0898765A7DEB2ULL }, /* 5^62 */
+    { 0x9B934C3B330C8577ULL, 0x63CC55F49F88EB2FULL }, /* 5^63 */
+    { 0xC2781F49FFCFA6D5ULL, 0x3CBF6B71C76B25FBULL }, /* 5^64 */
+    { 0xF316271C7FC3908AULL, 0x8BEF464E3945EF7AULL }, /* 5^65 */
+    { 0x97EDD871CFDA3A56ULL, 0x97758BF0E3CBB5ACULL }, /* 5^66 */
+    { 0xBDE94E8E43D0C8ECULL, 0x3D52EEED1CBEA317ULL }, /* 5^67 */
+    { 0xED63A231D4C4FB27ULL, 0x4CA7AAA863EE4BDDULL }, /* 5^68 */
+    { 0x945E455F24FB1CF8ULL, 0x8FE8CAA93E74EF6AULL }, /* 5^69 */
+    { 0xB975D6B6EE39E436ULL, 0xB3E2FD538E122B44ULL }, /* 5^70 */
+    { 0xE7D34C64A9C85D44ULL, 0x60DBBCA87196B616ULL }, /* 5^71 */
+    { 0x90E40FBEEA1D3A4AULL, 0xBC8955E946FE31CDULL }, /* 5^72 */
+    { 0xB51D13AEA4A488DDULL, 0x6BABAB6398BDBE41ULL }, /* 5^73 */
+    { 0xE264589A4DCDAB14ULL, 0xC696963C7EED2DD1ULL }, /* 5^74 */
+    { 0x8D7EB76070A08AECULL, 0xFC1E1DE5CF543CA2ULL }, /* 5^75 */
+    { 0xB0DE65388CC8ADA8ULL, 0x3B25A55F43294BCBULL }, /* 5^76 */
+    { 0xDD15FE86AFFAD912ULL, 0x49EF0EB713F39EBEULL }, /* 5^77 */
+    { 0x8A2DBF142DFCC7ABULL, 0x6E3569326C784337ULL }, /* 5^78 */
+    { 0xACB92ED9397BF996ULL, 0x49C2C37F07965404ULL }, /* 5^79 */
+    { 0xD7E77A8F87DAF7FBULL, 0xDC33745EC97BE906ULL }, /* 5^80 */
+    { 0x86F0AC99B4E8DAFDULL, 0x69A028BB3DED71A3ULL }, /* 5^81 */
+    { 0xA8ACD7C0222311BCULL, 0xC40832EA0D68CE0CULL }, /* 5^82 */
+    { 0xD2D80DB02AABD62BULL, 0xF50A3FA490C30190ULL }, /* 5^83 */
+    { 0x83C7088E1AAB65DBULL, 0x792667C6DA79E0FAULL }, /* 5^84 */
+    { 0xA4B8CAB1A1563F52ULL, 0x577001B891185938ULL }, /* 5^85 */
+    { 0xCDE6FD5E09ABCF26ULL, 0xED4C0226B55E6F86ULL }, /* 5^86 */
+    { 0x80B05E5AC60B6178ULL, 0x544F8158315B05B4ULL }, /* 5^87 */
+    { 0xA0DC75F1778E39D6ULL, 0x696361AE3DB1C721ULL }, /* 5^88 */
+    { 0xC913936DD571C84CULL, 0x03BC3A19CD1E38E9ULL }, /* 5^89 */
+    { 0xFB5878494ACE3A5FULL, 0x04AB48A04065C723ULL }, /* 5^90 */
+    { 0x9D174B2DCEC0E47BULL, 0x62EB0D64283F9C76ULL }, /* 5^91 */
+    { 0xC45D1DF942711D9AULL, 0x3BA5D0BD324F8394ULL }, /* 5^92 */
+    { 0xF5746577930D6500ULL, 0xCA8F44EC7EE36479ULL }, /* 5^93 */
+    { 0x9968BF6ABBE85F20ULL, 0x7E998B13CF4E1ECBULL }, /* 5^94 */
+    { 0xBFC2EF456AE276E8ULL, 0x9E3FEDD8C321A67EULL }, /* 5^95 */
+    { 0xEFB3AB16C59B14A2ULL, 0xC5CFE94EF3EA101EULL }, /* 5^96 */
+    { 0x95D04AEE3B80ECE5ULL, 0xBBA1F1D158724A12ULL }, /* 5^97 */
+    { 0xBB445DA9CA61281FULL, 0x2A8A6E45AE8EDC97ULL }, /* 5^98 */
+    { 0xEA1575143CF97226ULL, 0xF52D09D71A3293BDULL }, /* 5^99 */
+    { 0x924D692CA61BE758ULL, 0x593C2626705F9C56ULL }, /* 5^100 */
+    { 0xB6E0C377CFA2E12EULL, 0x6F8B2FB00C77836CULL }, /* 5^101 */
+    { 0xE498F455C38B997AULL, 0x0B6DFB9C0F956447ULL }, /* 5^102 */
+    { 0x8EDF98B59A373FECULL, 0x4724BD4189BD5EACULL }, /* 5^103 */
+    { 0xB2977EE300C50FE7ULL, 0x58EDEC91EC2CB657ULL }, /* 5^104 */
+    { 0xDF3D5E9BC0F653E1ULL, 0x2F2967B66737E3EDULL }, /* 5^105 */
+    { 0x8B865B215899F46CULL, 0xBD79E0D20082EE74ULL }, /* 5^106 */
+    { 0xAE67F1E9AEC07187ULL, 0xECD8590680A3AA11ULL }, /* 5^107 */
+    { 0xDA01EE641A708DE9ULL, 0xE80E6F4820CC9495ULL }, /* 5^108 */
+    { 0x884134FE908658B2ULL, 0x3109058D147FDCDDULL }, /* 5^109 */
+    { 0xAA51823E34A7EEDEULL, 0xBD4B46F0599FD415ULL }, /* 5^110 */
+    { 0xD4E5E2CDC1D1EA96ULL, 0x6C9E18AC7007C91AULL }, /* 5^111 */
+    { 0x850FADC09923329EULL, 0x03E2CF6BC604DDB0ULL }, /* 5^112 */
+    { 0xA6539930BF6BFF45ULL, 0x84DB8346B786151CULL }, /* 5^113 */
+    { 0xCFE87F7CEF46FF16ULL, 0xE612641865679A63ULL }, /* 5^114 */
+    { 0x81F14FAE158C5F6EULL, 0x4FCB7E8F3F60C07EULL }, /* 5^115 */
+    { 0xA26DA3999AEF7749ULL, 0xE3BE5E330F38F09DULL }, /* 5^116 */
+    { 0xCB090C8001AB551CULL, 0x5CADF5BFD3072CC5ULL }, /* 5^117 */
+    { 0xFDCB4FA002162A63ULL, 0x73D9732FC7C8F7F6ULL }, /* 5^118 */
+    { 0x9E9F11C4014DDA7EULL, 0x2867E7FDDCDD9AFAULL }, /* 5^119 */
+    { 0xC646D63501A1511DULL, 0xB281E1FD541501B8ULL }, /* 5^120 */
+    { 0xF7D88BC24209A565ULL, 0x1F225A7CA91A4226ULL }, /* 5^121 */
+    { 0x9AE757596946075FULL, 0x3375788DE9B06958ULL }, /* 5^122 */
+    { 0xC1A12D2FC3978937ULL, 0x0052D6B1641C83AEULL }, /* 5^123 */
+    { 0xF209787BB47D6B84ULL, 0xC0678C5DBD23A49AULL }, /* 5^124 */
+    { 0x9745EB4D50CE6332ULL, 0xF840B7BA963646E0ULL }, /* 5^125 */
+    { 0xBD176620A501FBFFULL, 0xB650E5A93BC3D898ULL }, /* 5^126 */
+    { 0xEC5D3FA8CE427AFFULL, 0xA3E51F138AB4CEBEULL }, /* 5^127 */
+    { 0x93BA47C980E98CDFULL, 0xC66F336C36B10137ULL }, /* 5^128 */
+    { 0xB8A8D9BBE123F017ULL, 0xB80B0047445D4184ULL }, /* 5^129 */
+    { 0xE6D3102AD96CEC1DULL, 0xA60DC059157491E5ULL }, /* 5^130 */
+    { 0x9043EA1AC7E41392ULL, 0x87C89837AD68DB2FULL }, /* 5^131 */
+    { 0xB454E4A179DD1877ULL, 0x29BABE4598C311FBULL }, /* 5^132 */
+    { 0xE16A1DC9D8545E94ULL, 0xF4296DD6FEF3D67AULL }, /* 5^133 */
+    { 0x8CE2529E2734BB1DULL, 0x1899E4A65F58660CULL }, /* 5^134 */
+    { 0xB01AE745B101E9E4ULL, 0x5EC05DCFF72E7F8FULL }, /* 5^135 */
+    { 0xDC21A1171D42645DULL, 0x76707543F4FA1F73ULL }, /* 5^136 */
+    { 0x899504AE72497EBAULL, 0x6A06494A791C53A8ULL }, /* 5^137 */
+    { 0xABFA45DA0EDBDE69ULL, 0x0487DB9D17636892ULL }, /* 5^138 */
+    { 0xD6F8D7509292D603ULL, 0x45A9D2845D3C42B6ULL }, /* 5^139 */
+    { 0x865B86925B9BC5C2ULL, 0x0B8A2392BA45A9B2ULL }, /* 5^140 */
+    { 0xA7F26836F282B732ULL, 0x8E6CAC7768D7141EULL }, /* 5^141 */
+    { 0xD1EF0244AF2364FFULL, 0x3207D795430CD926ULL }, /* 5^142 */
+    { 0x8335616AED761F1FULL, 0x7F44E6BD49E807B8ULL }, /* 5^143 */
+    { 0xA402B9C5A8D3A6E7ULL, 0x5F16206C9C6209A6ULL }, /* 5^144 */
+    { 0xCD036837130890A1ULL, 0x36DBA887C37A8C0FULL }, /* 5^145 */
+    { 0x802221226BE55A64ULL, 0xC2494954DA2C9789ULL }, /* 5^146 */
+    { 0xA02AA96B06DEB0FDULL, 0xF2DB9BAA10B7BD6CULL }, /* 5^147 */
+    { 0xC83553C5C8965D3DULL, 0x6F92829494E5ACC7ULL }, /* 5^148 */
+    { 0xFA42A8B73ABBF48CULL, 0xCB772339BA1F17F9ULL }, /* 5^149 */
+    { 0x9C69A97284B578D7ULL, 0xFF2A760414536EFBULL }, /* 5^150 */
+    { 0xC38413CF25E2D70DULL, 0xFEF5138519684ABAULL }, /* 5^151 */
+    { 0xF46518C2EF5B8CD1ULL, 0x7EB258665FC25D69ULL }, /* 5^152 */
+    { 0x98BF2F79D5993802ULL, 0xEF2F773FFBD97A61ULL }, /* 5^153 */
+    { 0xBEEEFB584AFF8603ULL, 0xAAFB550FFACFD8FAULL }, /* 5^154 */
+    { 0xEEAABA2E5DBF6784ULL, 0x95BA2A53F983CF38ULL }, /* 5^155 */
+    { 0x952AB45CFA97A0B2ULL, 0xDD945A747BF26183ULL }, /* 5^156 */
+    { 0xBA756174393D88DFULL, 0x94F971119AEEF9E4ULL }, /* 5^157 */
+    { 0xE912B9D1478CEB17ULL, 0x7A37CD5601AAB85DULL }, /* 5^158 */
+    { 0x91ABB422CCB812EEULL, 0xAC62E055C10AB33AULL }, /* 5^159 */
+    { 0xB616A12B7FE617AAULL, 0x577B986B314D6009ULL }, /* 5^160 */
+    { 0xE39C49765FDF9D94ULL, 0xED5A7E85FDA0B80BULL }, /* 5^161 */
+    { 0x8E41ADE9FBEBC27DULL, 0x14588F13BE847307ULL }, /* 5^162 */
+    { 0xB1D219647AE6B31CULL, 0x596EB2D8AE258FC8ULL }, /* 5^163 */
+    { 0xDE469FBD99A05FE3ULL, 0x6FCA5F8ED9AEF3BBULL }, /* 5^164 */
+    { 0x8AEC23D680043BEEULL, 0x25DE7BB9480D5854ULL }, /* 5^165 */
+    { 0xADA72CCC20054AE9ULL, 0xAF561AA79A10AE6AULL }, /* 5^166 */
+    { 0xD910F7FF28069DA4ULL, 0x1B2BA1518094DA04ULL }, /* 5^167 */
+    { 0x87AA9AFF79042286ULL, 0x90FB44D2F05D0842ULL }, /* 5^168 */
+    { 0xA99541BF57452B28ULL, 0x353A1607AC744A53ULL }, /* 5^169 */
+    { 0xD3FA922F2D1675F2ULL, 0x42889B8997915CE8ULL }, /* 5^170 */
+    { 0x847C9B5D7C2E09B7ULL, 0x69956135FEBADA11ULL }, /* 5^171 */
+    { 0xA59BC234DB398C25ULL, 0x43FAB9837E699095ULL }, /* 5^172 */
+    { 0xCF02B2C21207EF2EULL, 0x94F967E45E03F4BBULL }, /* 5^173 */
+    { 0x8161AFB94B44F57DULL, 0x1D1BE0EEBAC278F5ULL }, /* 5^174 */
+    { 0xA1BA1BA79E1632DCULL, 0x6462D92A69731732ULL }, /* 5^175 */
+    { 0xCA28A291859BBF93ULL, 0x7D7B8F7503CFDCFEULL }, /* 5^176 */
+    { 0xFCB2CB35E702AF78ULL, 0x5CDA735244C3D43EULL }, /* 5^177 */
+    { 0x9DEFBF01B061ADABULL, 0x3A0888136AFA64A7ULL }, /* 5^178 */
+    { 0xC56BAEC21C7A1916ULL, 0x088AAA1845B8FDD0ULL }, /* 5^179 */
+    { 0xF6C69A72A3989F5BULL, 0x8AAD549E57273D45ULL }, /* 5^180 */
+    { 0x9A3C2087A63F6399ULL, 0x36AC54E2F678864BULL }, /* 5^181 */
+    { 0xC0CB28A98FCF3C7FULL, 0x84576A1BB416A7DDULL }, /* 5^182 */
+    { 0xF0FDF2D3F3C30B9FULL, 0x656D44A2A11C51D5ULL }, /* 5^183 */
+    { 0x969EB7C47859E743ULL, 0x9F644AE5A4B1B325ULL }, /* 5^184 */
+    { 0xBC4665B596706114ULL, 0x873D5D9F0DDE1FEEULL }, /* 5^185 */
+    { 0xEB57FF22FC0C7959ULL, 0xA90CB506D155A7EAULL }, /* 5^186 */
+    { 0x9316FF75DD87CBD8ULL, 0x09A7F12442D588F2ULL }, /* 5^187 */
+    { 0xB7DCBF5354E9BECEULL, 0x0C11ED6D538AEB2FULL }, /* 5^188 */
+    { 0xE5D3EF282A242E81ULL, 0x8F1668C8A86DA5FAULL }, /* 5^189 */
+    { 0x8FA475791A569D10ULL, 0xF96E017D694487BCULL }, /* 5^190 */
+    { 0xB38D92D760EC4455ULL, 0x37C981DCC395A9ACULL }, /* 5^191 */
+    { 0xE070F78D3927556AULL, 0x85BBE253F47B1417ULL }, /* 5^192 */
+    { 0x8C469AB843B89562ULL, 0x93956D7478CCEC8EULL }, /* 5^193 */
+    { 0xAF58416654A6BABBULL, 0x387AC8D1970027B2ULL }, /* 5^194 */
+    { 0xDB2E51BFE9D0696AULL, 0x06997B05FCC0319EULL }, /* 5^195 */
+    { 0x88FCF317F22241E2ULL, 0x441FECE3BDF81F03ULL }, /* 5^196 */
+    { 0xAB3C2FDDEEAAD25AULL, 0xD527E81CAD7626C3ULL }, /* 5^197 */
+    { 0xD60B3BD56A5586F1ULL, 0x8A71E223D8D3B074ULL }, /* 5^198 */
+    { 0x85C7056562757456ULL, 0xF6872D5667844E49ULL }, /* 5^199 */
+    { 0xA738C6BEBB12D16CULL, 0xB428F8AC016561DBULL }, /* 5^200 */
+    { 0xD106F86E69D785C7ULL, 0xE13336D701BEBA52ULL }, /* 5^201 */
+    { 0x82A45B450226B39CULL, 0xECC0024661173473ULL }, /* 5^202 */
+    { 0xA34D721642B06084ULL, 0x27F002D7F95D0190ULL }, /* 5^203 */
+    { 0xCC20CE9BD35C78A5ULL, 0x31EC038DF7B441F4ULL }, /* 5^204 */
+    { 0xFF290242C83396CEULL, 0x7E67047175A15271ULL }, /* 5^205 */
+    { 0x9F79A169BD203E41ULL, 0x0F0062C6E984D386ULL }, /* 5^206 */
+    { 0xC75809C42C684DD1ULL, 0x52C07B78A3E60868ULL }, /* 5^207 */
+    { 0xF92E0C3537826145ULL, 0xA7709A56CCDF8A82ULL }, /* 5^208 */
+    { 0x9BBCC7A142B17CCBULL, 0x88A66076400BB691ULL }, /* 5^209 */
+    { 0xC2ABF989935DDBFEULL, 0x6ACFF893D00EA435ULL }, /* 5^210 */
+    { 0xF356F7EBF83552FEULL, 0x0583F6B8C4124D43ULL }, /* 5^211 */
+    { 0x98165AF37B2153DEULL, 0xC3727A337A8B704AULL }, /* 5^212 */
+    { 0xBE1BF1B059E9A8D6ULL, 0x744F18C0592E4C5CULL }, /* 5^213 */
+    { 0xEDA2EE1C7064130CULL, 0x1162DEF06F79DF73ULL }, /* 5^214 */
+    { 0x9485D4D1C63E8BE7ULL, 0x8ADDCB5645AC2BA8ULL }, /* 5^215 */
+    { 0xB9A74A0637CE2EE1ULL, 0x6D953E2BD7173692ULL }, /* 5^216 */
+    { 0xE8111C87C5C1BA99ULL, 0xC8FA8DB6CCDD0437ULL }, /* 5^217 */
+    { 0x910AB1D4DB9914A0ULL, 0x1D9C9892400A22A2ULL }, /* 5^218 */
+    { 0xB54D5E4A127F59C8ULL, 0x2503BEB6D00CAB4BULL }, /* 5^219 */
+    { 0xE2A0B5DC971F303AULL, 0x2E44AE64840FD61DULL }, /* 5^220 */
+    { 0x8DA471A9DE737E24ULL, 0x5CEAECFED289E5D2ULL }, /* 5^221 */
+    { 0xB10D8E1456105DADULL, 0x7425A83E872C5F47ULL }, /* 5^222 */
+    { 0xDD50F1996B947518ULL, 0xD12F124E28F77719ULL }, /* 5^223 */
+    { 0x8A5296FFE33CC92FULL, 0x82BD6B70D99AAA6FULL }, /* 5^224 */
+    { 0xACE73CBFDC0BFB7BULL, 0x636CC64D1001550BULL }, /* 5^225 */
+    { 0xD8210BEFD30EFA5AULL, 0x3C47F7E05401AA4EULL }, /* 5^226 */
+    { 0x8714A775E3E95C78ULL, 0x65ACFAEC34810A71ULL }, /* 5^227 */
+    { 0xA8D9D1535CE3B396ULL, 0x7F1839A741A14D0DULL }, /* 5^228 */
+    { 0xD31045A8341CA07CULL, 0x1EDE48111209A050ULL }, /* 5^229 */
+    { 0x83EA2B892091E44DULL, 0x934AED0AAB460432ULL }, /* 5^230 */
+    { 0xA4E4B66B68B65D60ULL, 0xF81DA84D5617853FULL }, /* 5^231 */
+    { 0xCE1DE40642E3F4B9ULL, 0x36251260AB9D668EULL }, /* 5^232 */
+    { 0x80D2AE83E9CE78F3ULL, 0xC1D72B7C6B426019ULL }, /* 5^233 */
+    { 0xA1075A24E4421730ULL, 0xB24CF65B8612F81FULL }, /* 5^234 */
+    { 0xC94930AE1D529CFCULL, 0xDEE033F26797B627ULL }, /* 5^235 */
+    { 0xFB9B7CD9A4A7443CULL, 0x169840EF017DA3B1ULL }, /* 5^236 */
+    { 0x9D412E0806E88AA5ULL, 0x8E1F289560EE864EULL }, /* 5^237 */
+    { 0xC491798A08A2AD4EULL, 0xF1A6F2BAB92A27E2ULL }, /* 5^238 */
+    { 0xF5B5D7EC8ACB58A2ULL, 0xAE10AF696774B1DBULL }, /* 5^239 */
+    { 0x9991A6F3D6BF1765ULL, 0xACCA6DA1E0A8EF29ULL }, /* 5^240 */
+    { 0xBFF610B0CC6EDD3FULL, 0x17FD090A58D32AF3ULL }, /* 5^241 */
+    { 0xEFF394DCFF8A948EULL, 0xDDFC4B4CEF07F5B0ULL }, /* 5^242 */
+    { 0x95F83D0A1FB69CD9ULL, 0x4ABDAF101564F98EULL }, /* 5^243 */
+    { 0xBB764C4CA7A4440FULL, 0x9D6D1AD41ABE37F1ULL }, /* 5^244 */
+    { 0xEA53DF5FD18D5513ULL, 0x84C86189216DC5EDULL }, /* 5^245 */
+    { 0x92746B9BE2F8552CULL, 0x32FD3CF5B4E49BB4ULL }, /* 5^246 */
+    { 0xB7118682DBB66A77ULL, 0x3FBC8C33221DC2A1ULL }, /* 5^247 */
+    { 0xE4D5E82392A40515ULL, 0x0FABAF3FEAA5334AULL }, /* 5^248 */
+    { 0x8F05B1163BA6832DULL, 0x29CB4D87F2A7400EULL }, /* 5^249 */
+    { 0xB2C71D5BCA9023F8ULL, 0x743E20E9EF511012ULL }, /* 5^250 */
+    { 0xDF78E4B2BD342CF6ULL, 0x914DA9246B255416ULL }, /* 5^251 */
+    { 0x8BAB8EEFB6409C1AULL, 0x1AD089B6C2F7548EULL }, /* 5^252 */
+    { 0xAE9672ABA3D0C320ULL, 0xA184AC2473B529B1ULL }, /* 5^253 */
+    { 0xDA3C0F568CC4F3E8ULL, 0xC9E5D72D90A2741EULL }, /* 5^254 */
+    { 0x8865899617FB1871ULL, 0x7E2FA67C7A658892ULL }, /* 5^255 */
+    { 0xAA7EEBFB9DF9DE8DULL, 0xDDBB901B98FEEAB7ULL }, /* 5^256 */
+    { 0xD51EA6FA85785631ULL, 0x552A74227F3EA565ULL }, /* 5^257 */
+    { 0x8533285C936B35DEULL, 0xD53A88958F87275FULL }, /* 5^258 */
+    { 0xA67FF273B8460356ULL, 0x8A892ABAF368F137ULL }, /* 5^259 */
+    { 0xD01FEF10A657842CULL, 0x2D2B7569B0432D85ULL }, /* 5^260 */
+    { 0x8213F56A67F6B29BULL, 0x9C3B29620E29FC73ULL }, /* 5^261 */
+    { 0xA298F2C501F45F42ULL, 0x8349F3BA91B47B8FULL }, /* 5^262 */
+    { 0xCB3F2F7642717713ULL, 0x241C70A936219A73ULL }, /* 5^263 */
+    { 0xFE0EFB53D30DD4D7ULL, 0xED238CD383AA0110ULL }, /* 5^264 */
+    { 0x9EC95D1463E8A506ULL, 0xF4363804324A40AAULL }, /* 5^265 */
+    { 0xC67BB4597CE2CE48ULL, 0xB143C6053EDCD0D5ULL }, /* 5^266 */
+    { 0xF81AA16FDC1B81DAULL, 0xDD94B7868E94050AULL }, /* 5^267 */
+    { 0x9B10A4E5E9913128ULL, 0xCA7CF2B4191C8326ULL }, /* 5^268 */
+    { 0xC1D4CE1F63F57D72ULL, 0xFD1C2F611F63A3F0ULL }, /* 5^269 */
+    { 0xF24A01A73CF2DCCFULL, 0xBC633B39673C8CECULL }, /* 5^270 */
+    { 0x976E41088617CA01ULL, 0xD5BE0503E085D813ULL }, /* 5^271 */
+    { 0xBD49D14AA79DBC82ULL, 0x4B2D8644D8A74E18ULL }, /* 5^272 */
+    { 0xEC9C459D51852BA2ULL, 0xDDF8E7D60ED1219EULL }, /* 5^273 */
+    { 0x93E1AB8252F33B45ULL, 0xCABB90E5C942B503ULL }, /* 5^274 */
+    { 0xB8DA1662E7B00A17ULL, 0x3D6A751F3B936243ULL }, /* 5^275 */
+    { 0xE7109BFBA19C0C9DULL, 0x0CC512670A783AD4ULL }, /* 5^276 */
+    { 0x906A617D450187E2ULL, 0x27FB2B80668B24C5ULL }, /* 5^277 */
+    { 0xB484F9DC9641E9DAULL, 0xB1F9F660802DEDF6ULL }, /* 5^278 */
+    { 0xE1A63853BBD26451ULL, 0x5E7873F8A0396973ULL }, /* 5^279 */
+    { 0x8D07E33455637EB2ULL, 0xDB0B487B6423E1E8ULL }, /* 5^280 */
+    { 0xB049DC016ABC5E5FULL, 0x91CE1A9A3D2CDA62ULL }, /* 5^281 */
+    { 0xDC5C5301C56B75F7ULL, 0x7641A140CC7810FBULL }, /* 5^282 */
+    { 0x89B9B3E11B6329BAULL, 0xA9E904C87FCB0A9DULL }, /* 5^283 */
+    { 0xAC2820D9623BF429ULL, 0x546345FA9FBDCD44ULL }, /* 5^284 */
+    { 0xD732290FBACAF133ULL, 0xA97C177947AD4095ULL }, /* 5^285 */
+    { 0x867F59A9D4BED6C0ULL, 0x49ED8EABCCCC485DULL }, /* 5^286 */
+    { 0xA81F301449EE8C70ULL, 0x5C68F256BFFF5A74ULL }, /* 5^287 */
+    { 0xD226FC195C6A2F8CULL, 0x73832EEC6FFF3111ULL }, /* 5^288 */
+    { 0x83585D8FD9C25DB7ULL, 0xC831FD53C5FF7EABULL }, /* 5^289 */
+    { 0xA42E74F3D032F525ULL, 0xBA3E7CA8B77F5E55ULL }, /* 5^290 */
+    { 0xCD3A1230C43FB26FULL, 0x28CE1BD2E55F35EBULL }, /* 5^291 */
+    { 0x80444B5E7AA7CF85ULL, 0x7980D163CF5B81B3ULL }, /* 5^292 */
+    { 0xA0555E361951C366ULL, 0xD7E105BCC332621FULL }, /* 5^293 */
+    { 0xC86AB5C39FA63440ULL, 0x8DD9472BF3FEFAA7ULL }, /* 5^294 */
+    { 0xFA856334878FC150ULL, 0xB14F98F6F0FEB951ULL }, /* 5^295 */
+    { 0x9C935E00D4B9D8D2ULL, 0x6ED1BF9A569F33D3ULL }, /* 5^296 */
+    { 0xC3B8358109E84F07ULL, 0x0A862F80EC4700C8ULL }, /* 5^297 */
+    { 0xF4A642E14C6262C8ULL, 0xCD27BB612758C0FAULL }, /* 5^298 */
+    { 0x98E7E9CCCFBD7DBDULL, 0x8038D51CB897789CULL }, /* 5^299 */
+    { 0xBF21E44003ACDD2CULL, 0xE0470A63E6BD56C3ULL }, /* 5^300 */
+    { 0xEEEA5D5004981478ULL, 0x1858CCFCE06CAC74ULL }, /* 5^301 */
+    { 0x95527A5202DF0CCBULL, 0x0F37801E0C43EBC8ULL }, /* 5^302 */
+    { 0xBAA718E68396CFFDULL, 0xD30560258F54E6BAULL }, /* 5^303 */
+    { 0xE950DF20247C83FDULL, 0x47C6B82EF32A2069ULL }, /* 5^304 */
+    { 0x91D28B7416CDD27EULL, 0x4CDC331D57FA5441ULL }, /* 5^305 */
+    { 0xB6472E511C81471DULL, 0xE0133FE4ADF8E952ULL }, /* 5^306 */
+    { 0xE3D8F9E563A198E5ULL, 0x58180FDDD97723A6ULL }, /* 5^307 */
+    { 0x8E679C2F5E44FF8FULL, 0x570F09EAA7EA7648ULL }, /* 5^308 */
+};
+
+/* the high and low 64 bits of a * b */
+static void lept_mul_64x64(uint64_t a, uint64_t b, uint64_t* hi, uint64_t* lo) {
+#if defined(__SIZEOF_INT128__)
+    lept_uint128 r = (lept_uint128)a * b;
+    *hi = (uint64_t)(r >> 64);
+    *lo = (uint64_t)r;
+#else
+    uint64_t a0 = (uint32_t)a, a1 = a >> 32, b0 = (uint32_t)b, b1 = b >> 32;
+    uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+    uint64_t mid = (p00 >> 32) + (uint32_t)p01 + (uint32_t)p10;
+    *hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+    *lo = (mid << 32) | (uint32_t)p00;
+#endif
+}
+
+static int lept_clz64(uint64_t x) {
+#if defined(__GNUC__)
+    return __builtin_clzll(x);
+#else
+    int n = 0;
+    while(!(x & ((uint64_t)1 << 63))) {
+        x <<= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+/* bits of the double nearest to w * 10^q, w != 0, q in [-342, 308] */
+static uint64_t lept_eisel_lemire(uint64_t w, int q) {
+    const uint64_t* pow5 = lept_pow5_128[q + 342];
+    uint64_t hi, lo, hi2, lo2, mantissa;
+    int lz = lept_clz64(w), upperbit, shift, power2;
+
+    w <<= lz;
+    lept_mul_64x64(w, pow5[0], &hi, &lo);
+    if((hi & 0x1FF) == 0x1FF) {
+        /* the truncated product may be off, refine with the low half */
+        lept_mul_64x64(w, pow5[1], &hi2, &lo2);
+        lo += hi2;
+        if(hi2 > lo) {
+            hi++;
+        }
+        if(lo == UINT64_MAX && (q < -27 || q > 55)) {
+            return LEPT_NUMBER_FAIL;
         }
     }
 
-    if(*cur_phase != '-') {
-        /* has frac */
-        if(cur_phase[1] != '\0' && cur_phase[1] == '.') {
-        	/* avoid strings like "1.", "2.xas"... */
-            if(cur_phase[2] == '\0' ||
-              (cur_phase[2] && !isdigit(cur_phase[2]))) {
-                return LEPT_PARSE_INVALID_VALUE;
-            }
+    upperbit = (int)(hi >> 63);
+    shift = upperbit + 64 - 52 - 3;
+    mantissa = hi >> shift;
+    /* floor(q * log2(10)) + 63, the binary exponent of the product */
+    power2 = (int)(((217706 * q) >> 16) + 63 + upperbit - lz + 1023);
+
+    if(power2 <= 0) {
+        /* subnormal, or zero */
+        if(-power2 + 1 >= 64) {
+            return 0;
         }
+        mantissa >>= -power2 + 1;
+        mantissa += (mantissa & 1);
+        mantissa >>= 1;
+        /* rounding may carry into the smallest normal exponent */
+        power2 = (mantissa < ((uint64_t)1 << 52)) ? 0 : 1;
+        return (mantissa & (((uint64_t)1 << 52) - 1)) | ((uint64_t)power2 << 52);
     }
 
-    /** strtod() succeeded,
-     *    if and only if the string starts with a (hex or decimal) number
-     */
-    v->number.v = strtod(cur_phase, &next_phase);
-    if(cur_phase == next_phase) {
-        /* not a number */
-        return LEPT_PARSE_INVALID_VALUE;
-    } else if(errno == ERANGE && (v->number.v == HUGE_VAL || v->number.v == -HUGE_VAL )) {
-        /* out of range */
-        errno = 0;
-        return LEPT_PARSE_NUMBER_TOO_BIG;
+    /* exactly halfway between two doubles: round to even */
+    if(lo <= 1 && q >= -4 && q <= 23 && (mantissa & 3) == 1 && (mantissa << shift) == hi) {
+        mantissa &= ~(uint64_t)1;
+    }
+    mantissa += (mantissa & 1);
+    mantissa >>= 1;
+    if(mantissa >= ((uint64_t)2 << 52)) {
+        mantissa = (uint64_t)1 << 52;
+        power2++;
+    }
+    if(power2 >= 0x7FF) {
+        return (uint64_t)0x7FF << 52; /* infinity */
     }
-    c->json = next_phase;
-    v->type = LEPT_NUMBER;
 
-    return LEPT_PARSE_OK;
+    return (mantissa & (((uint64_t)1 << 52) - 1)) | ((uint64_t)power2 << 52);
 }
 
-/* parse string */
-
-#define PUTC(c, ch) do { LEPT_CONTEXT_PUSH(c, char, ch); } while(0)
-
-#define STRING_ERROR(ret) do { c->top = head; return ret; } while(0)
-
-static const char* lept_parse_hex4(const char* p, unsigned* u) {
-    char temp[5];
+/* w * 10^q when w keeps every significant digit, or w and w + 1 agree */
+static int lept_number_fast(uint64_t w, int64_t q, int truncated, double* d) {
+    uint64_t bits;
 
-    if(!(isxdigit(p[0]) && isxdigit(p[1]) && isxdigit(p[2]) && isxdigit(p[3]))) {
-        return NULL;
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+    if(!truncated && w <= ((uint64_t)1 << 53) && q >= -22 && q <= 22) {
+        *d = (double)w;
+        if(q != 0) {
+            *d = (q < 0) ? *d / lept_pow10_exact[-q] : *d * lept_pow10_exact[q];
+        }
+        return 1;
     }
+#endif
 
-    for(size_t i = 0; i < 4; i ++) {
-        temp[i] = p[i];
+    if(q < -342) {
+        *d = 0.0;
+        return 1;
+    }
+    if(q > 308) {
+        *d = HUGE_VAL;
+        return 1;
     }
-    temp[4] = '\0';
 
-    sscanf(temp, "%x", u);
+    bits = lept_eisel_lemire(w, (int)q);
+    if(bits == LEPT_NUMBER_FAIL ||
+      (truncated && lept_eisel_lemire(w + 1, (int)q) != bits)) {
+        return 0;
+    }
+    memcpy(d, &bits, sizeof(double));
 
-    return p + 4;
+    return 1;
 }
 
-static const char* lept_surrogate_handling(const char* p, unsigned* u) {
-    unsigned u2;
-
-    if(*u < 0xD800 || *u > 0xDBFF) {
-        /* dont need surrogate */
-        return p;
-    }
+/* slow path: exact binary scaling of the decimal digits */
 
-    if(!(p[0] == '\\' && p[1] == 'u')) {
-        /** 0xFFFFFFFF is illegal in UCS, we use it as error:
-          * LEPT_PARSE_INVALID_UNICODE_SURROGATE */
-        *(int*)u = -1;
-        return NULL;
-    }
+#define LEPT_DECIMAL_DIGITS 800
+#define LEPT_DECIMAL_MAX_SHIFT 60
 
-    if((p = lept_parse_hex4(p+2, &u2)) == NULL) {
-        /* LEPT_PARSE_INVALID_UNICODE_HEX */
-        return NULL;
+typedef struct {
+    unsigned char d[LEPT_DECIMAL_DIGITS]; /* digit values, most significant first */
+    int nd;    /* number of digits used */
+    int dp;    /* decimal point: value is 0.d[0]d[1]... * 10^dp */
+    int trunc; /* nonzero digits were dropped */
+} lept_decimal;
+
+static void lept_decimal_trim(lept_decimal* a) {
+    while(a->nd > 0 && a->d[a->nd - 1] == 0) {
+        a->nd--;
     }
-
-    if(u2 < 0xDC00 || u2 > 0xDFFF) {
-        /** 0xFFFFFFFF is illegal in UCS, we use it as error:
-          * LEPT_PARSE_INVALID_UNICODE_SURROGATE */
-        *(int*)u = -1;
-        return NULL;
+    if(a->nd == 0) {
+        a->dp = 0;
     }
+}
 
-    /* save codepoint */
-    *u = 0x10000 + (*u - 0xD800) * 0x400 + (u2 - 0xDC00);
+/* a *= 2^k */
+static void lept_decimal_lshift(lept_decimal* a, unsigned k) {
+    unsigned char rev[LEPT_DECIMAL_DIGITS + 20]; /* least significant first */
+    uint64_t n = 0;
+    int r, w = 0, i;
 
-    return p;
+    for(r = a->nd - 1; r >= 0; r--) {
+        n += (uint64_t)a->d[r] << k;
+        rev[w++] = (unsigned char)(n % 10);
+        n /= 10;
+    }
+    while(n > 0) {
+        rev[w++] = (unsigned char)(n % 10);
+        n /= 10;
+    }
+    a->dp += w - a->nd;
+    a->nd = (w < LEPT_DECIMAL_DIGITS) ? w : LEPT_DECIMAL_DIGITS;
+    for(i = 0; i < w - a->nd; i++) {
+        if(rev[i] != 0) {
+            a->trunc = 1;
+        }
+    }
+    for(i = 0; i < a->nd; i++) {
+        a->d[i] = rev[w - 1 - i];
+    }
+    lept_decimal_trim(a);
 }
 
-static void lept_encode_utf8(lept_context* c, unsigned u) {
-    if(u <= 0x7F) {
-        PUTC(c, (unsigned char)u);
-        return ;
+/* a /= 2^k */
+static void lept_decimal_rshift(lept_decimal* a, unsigned k) {
+    uint64_t n = 0, mask = ((uint64_t)1 << k) - 1;
+    int r = 0, w = 0;
+
+    /* pick up enough leading digits to produce a first quotient digit */
+    for(; (n >> k) == 0; r++) {
+        if(r >= a->nd) {
+            if(n == 0) {
+                a->nd = 0;
+                return;
+            }
+            while((n >> k) == 0) {
+                n *= 10;
+                r++;
+            }
+            break;
+        }
+        n = n * 10 + a->d[r];
     }
+    a->dp -= r - 1;
 
-    if(u <= 0x7FF) {
-        PUTC(c, 0xC0 | (u >> 6));
-        PUTC(c, 0x80 | (u & 0x3F));
-        return ;
+    for(; r < a->nd; r++) {
+        unsigned char dig = (unsigned char)(n >> k);
+        n &= mask;
+        a->d[w++] = dig;
+        n = n * 10 + a->d[r];
     }
-
-    if(u <= 0xFFFF) {
-        PUTC(c, 0xE0 | ((u >> 12) & 0x3F));
-        PUTC(c, 0x80 | ((u >>  6) & 0x3F));
-        PUTC(c, 0x80 | ( u        & 0x3F));
-        return ;
+    while(n > 0) {
+        unsigned char dig = (unsigned char)(n >> k);
+        n &= mask;
+        if(w < LEPT_DECIMAL_DIGITS) {
+            a->d[w++] = dig;
+        } else if(dig > 0) {
+            a->trunc = 1;
+        }
+        n *= 10;
     }
+    a->nd = w;
+    lept_decimal_trim(a);
+}
 
-    if(u <= 0x10FFFF) {
-        PUTC(c, 0xF0 | ((u >> 18) & 0xFF));
-        PUTC(c, 0x80 | ((u >> 12) & 0x3F));
-        PUTC(c, 0x80 | ((u >>  6) & 0x3F));
-        PUTC(c, 0x80 | ( u        & 0x3F));
-        return ;
+static void lept_decimal_shift(lept_decimal* a, int k) {
+    if(a->nd == 0) {
+        return;
     }
+    for(; k > LEPT_DECIMAL_MAX_SHIFT; k -= LEPT_DECIMAL_MAX_SHIFT) {
+        lept_decimal_lshift(a, LEPT_DECIMAL_MAX_SHIFT);
+    }
+    for(; k < -LEPT_DECIMAL_MAX_SHIFT; k += LEPT_DECIMAL_MAX_SHIFT) {
+        lept_decimal_rshift(a, LEPT_DECIMAL_MAX_SHIFT);
+    }
+    if(k > 0) {
+        lept_decimal_lshift(a, (unsigned)k);
+    } else if(k < 0) {
+        lept_decimal_rshift(a, (unsigned)-k);
+    }
+}
 
-    /* never reach here */
-    assert(0);
+/* the integer part of a, rounded half to even */
+static uint64_t lept_decimal_round(const lept_decimal* a) {
+    uint64_t n = 0;
+    int i, up;
+
+    if(a->dp > 20) {
+        return UINT64_MAX;
+    }
+    for(i = 0; i < a->dp && i < a->nd; i++) {
+        n = n * 10 + a->d[i];
+    }
+    for(; i < a->dp; i++) {
+        n *= 10;
+    }
+
+    if(a->dp < 0 || a->dp >= a->nd) {
+        up = 0;
+    } else if(a->d[a->dp] == 5 && a->dp + 1 == a->nd) {
+        up = a->trunc || (a->dp > 0 && (a->d[a->dp - 1] & 1));
+    } else {
+        up = a->d[a->dp] >= 5;
+    }
+
+    return n + up;
 }
 
-static int lept_parse_string(lept_context* c, lept_value* v) {
-    size_t head = c->top, len;
-    const char* p = c->json;
-    unsigned u; /* codepoint */
+static double lept_decimal_to_double(lept_decimal* a) {
+    static const int powtab[] = { 1, 3, 6, 9, 13, 16, 19, 23, 26 };
+    uint64_t mantissa, bits;
+    int exp = 0;
+    double d;
 
-    assert(*p++ == '\"');
+    if(a->nd == 0 || a->dp < -330) {
+        return 0.0;
+    }
+    if(a->dp > 310) {
+        return HUGE_VAL;
+    }
 
-    if(*p == '\"') {
-        lept_set_string(v, "", 0);
-        c->json = ++ p;
-        return LEPT_PARSE_OK;
+    /* scale by powers of two into [0.5, 1) */
+    while(a->dp > 0) {
+        int n = (a->dp >= 9) ? 27 : powtab[a->dp];
+        lept_decimal_shift(a, -n);
+        exp += n;
     }
+    while(a->dp < 0 || (a->dp == 0 && a->d[0] < 5)) {
+        int n = (-a->dp >= 9) ? 27 : powtab[-a->dp];
+        lept_decimal_shift(a, n);
+        exp -= n;
+    }
+    exp--; /* [0.5, 1) -> [1, 2) */
 
-    for(;;) {
-        unsigned char ch = *p++;
-        switch (ch) {
-            case '\"':
-                len = c->top - head;
-                lept_set_string(v, (const char*)lept_context_pop(c, len), len);
-                c->json = p;
-                return LEPT_PARSE_OK;
-            case '\0':
-                STRING_ERROR(LEPT_PARSE_MISS_QUOTATION_MARK);
-            case '\\':
-                ch = *p++;
-                switch(ch) {
-                    case '\"': PUTC(c, '\"'); break;
-                    case '\\': PUTC(c, '\\'); break;
-                    case '/':  PUTC(c, '/'); break;
-                    case 'b':  PUTC(c, '\b'); break;
-                    case 'f':  PUTC(c, '\f'); break;
-                    case 'n':  PUTC(c, '\n'); break;
-                    case 'r':  PUTC(c, '\r'); break;
-                    case 't':  PUTC(c, '\t'); break;
-                    case 'u':
-                        /* convert to codepoint and save it in u */
-                        if((p = lept_parse_hex4(p, &u)) == NULL) {
-                            STRING_ERROR(LEPT_PARSE_INVALID_UNICODE_HEX);
-                        }
-                        /* surrogate handling */
-                        if((p = lept_surrogate_handling(p, &u)) == NULL) {
-                            if((int)u == -1) {
-                                STRING_ERROR(LEPT_PARSE_INVALID_UNICODE_SURROGATE);
-                            } else {
-                                STRING_ERROR(LEPT_PARSE_INVALID_UNICODE_HEX);
-                            }
-                        }
-                        /* convert to utf-8 and save it */
-                        lept_encode_utf8(c, u);
-                        break;
-                    default:
-                        STRING_ERROR(LEPT_PARSE_INVALID_ESCAPE);
-                }
-                break;
-            default:
-                if((ch >= 0x20 && ch <= 0x21) || (ch >= 0x23 && ch <= 0x5B) || (ch >=0x5D)) {
-                    PUTC(c, ch);
-                } else {
-                    STRING_ERROR(LEPT_PARSE_INVALID_STRING_CHAR);
-                }
+    /* below the smallest normal exponent: denormalize */
+    if(exp < -1022) {
+        lept_decimal_shift(a, -(-1022 - exp));
+        exp = -1022;
+    }
+    if(exp + 1023 >= 0x7FF) {
+        return HUGE_VAL;
+    }
+
+    lept_decimal_shift(a, 53);
+    mantissa = lept_decimal_round(a);
+    if(mantissa == ((uint64_t)2 << 52)) {
+        mantissa >>= 1;
+        if(++exp + 1023 >= 0x7FF) {
+            return HUGE_VAL;
         }
     }
+    if(!(mantissa & ((uint64_t)1 << 52))) {
+        exp = -1023; /* denormal */
+    }
+
+    bits = (mantissa & (((uint64_t)1 << 52) - 1)) | ((uint64_t)(exp + 1023) << 52);
+    memcpy(&d, &bits, sizeof(double));
+
+    return d;
 }
 
-/* parse array */
+/* digits of [ib, ie) "." [fb, fe) "e" exp */
+static double lept_number_slow(const char* ib, const char* ie, const char* fb, const char* fe, int64_t exp) {
+    lept_decimal a;
+    int64_t dp = 0;
+    const char* p;
 
-#define PUTV(c, v) do { LEPT_CONTEXT_PUSH(c, lept_value, v); } while(0)
+    a.nd = 0;
+    a.trunc = 0;
+    for(p = ib; p < ie; p++) {
+        if(a.nd == 0 && *p == '0') {
+            continue;
+        }
+        if(a.nd < LEPT_DECIMAL_DIGITS) {
+            a.d[a.nd++] = (unsigned char)(*p - '0');
+        } else if(*p != '0') {
+            a.trunc = 1;
+        }
+        dp++;
+    }
+    for(p = fb; p < fe; p++) {
+        if(a.nd == 0 && *p == '0') {
+            dp--;
+            continue;
+        }
+        if(a.nd < LEPT_DECIMAL_DIGITS) {
+            a.d[a.nd++] = (unsigned char)(*p - '0');
+        } else if(*p != '0') {
+            a.trunc = 1;
+        }
+    }
+    dp += exp;
+    /* anything this far out is 0 or infinity anyway */
+    a.dp = (dp < -100000) ? -100000 : (dp > 100000) ? 100000 : (int)dp;
+    lept_decimal_trim(&a);
 
-#define ARRAY_ERROR(ret) \
-    do { \
-        lept_value* p = (lept_value*)(void*)(c->stack + head); \
-        for(size_t i = 0; i < size; i ++) { \
-            lept_free(&p[i]); \
-        } \
-        c->top = head; \
-        return ret; \
-    } while(0)
+    return lept_decimal_to_double(&a);
+}
 
-static int lept_parse_value(lept_context* c, lept_value* v);
+static int lept_parse_number(lept_context* c) {
+    const char* p = c->json;
+    const char* end = c->end;
+    const char *ib, *ie, *fb = NULL, *fe = NULL;
+    uint64_t w = 0;
+    int64_t q = 0, exp = 0;
+    int neg = 0, nsig = 0, truncated = 0;
+    double d;
+
+    if(p < end && *p == '-') {
+        neg = 1;
+        p++;
+    }
+    /* "00.." and hex numbers are invalid values rather than two tokens */
+    if(LEPT_PEEK(c, p) == '0' && (LEPT_ISDIGIT(LEPT_PEEK(c, p + 1)) || LEPT_PEEK(c, p + 1) == 'x')) {
+        return LEPT_PARSE_INVALID_VALUE;
+    }
+    if(!LEPT_ISDIGIT(LEPT_PEEK(c, p))) {
+        return LEPT_PARSE_INVALID_VALUE;
+    }
 
-static int lept_parse_array(lept_context* c, lept_value* v) {
-    int ret;
-    const char* p;
-    size_t head = c->top, size = 0;
+    /* int */
+    for(ib = p; p < end && LEPT_ISDIGIT(*p); p++) {
+        if(nsig < 19) {
+            w = w * 10 + (unsigned)(*p - '0');
+            nsig += (w != 0);
+        } else {
+            truncated |= (*p != '0');
+            q++;
+        }
+    }
+    ie = p;
 
-    assert(*(c->json)++ == '[');
+    /* frac */
+    if(p < end && *p == '.') {
+        p++;
+        if(!LEPT_ISDIGIT(LEPT_PEEK(c, p))) {
+            return LEPT_PARSE_INVALID_VALUE;
+        }
+        for(fb = p; p < end && LEPT_ISDIGIT(*p); p++) {
+            if(nsig < 19) {
+                w = w * 10 + (unsigned)(*p - '0');
+                nsig += (w != 0);
+                q--;
+            } else {
+                truncated |= (*p != '0');
+            }
+        }
+        fe = p;
+    }
 
-    lept_parse_whitespace(c);
+    /* exp */
+    if(p < end && (*p == 'e' || *p == 'E')) {
+        int eneg = 0;
+        p++;
+        if(p < end && (*p == '+' || *p == '-')) {
+            eneg = (*p++ == '-');
+        }
+        if(!LEPT_ISDIGIT(LEPT_PEEK(c, p))) {
+            return LEPT_PARSE_INVALID_VALUE;
+        }
+        for(; p < end && LEPT_ISDIGIT(*p); p++) {
+            if(exp < 100000) {
+                exp = exp * 10 + (*p - '0');
+            }
+        }
+        if(eneg) {
+            exp = -exp;
+        }
+        q += exp;
+    }
 
-    // empty array
-    if(*(c->json) == ']') {
-        v->type = LEPT_ARRAY;
-        v->array.e = NULL;
-        v->array.size = 0;
-        c->json ++;
-        return LEPT_PARSE_OK;
+    if(w == 0) {
+        d = 0.0;
+    } else if(!lept_number_fast(w, q, truncated, &d)) {
+        d = lept_number_slow(ib, ie, fb, fe, exp);
+    }
+    if(d == HUGE_VAL) {
+        return LEPT_PARSE_NUMBER_TOO_BIG;
     }
 
-    while(1) {
+    c->json = p;
+    LEPT_SAX_CALL(c, number, (c->user, neg ? -d : d));
 
-        lept_value v2;
-        lept_init(&v2);
-        ret = lept_parse_value(c, &v2);
-        if(ret != LEPT_PARSE_OK) {
-            ARRAY_ERROR(ret);
-        }
-        PUTV(c, v2); size ++;
+    return LEPT_PARSE_OK;
+}
 
-        /* handle ws and ',' */
-        lept_parse_whitespace(c);
-        if(*(p = c->json) == ']') {
-            break;
-        } else if(*p != ',') {
-            ARRAY_ERROR(LEPT_PARSE_INVALID_VALUE);
+/* parse string */
+
+#define PUTC(c, ch) do { LEPT_CONTEXT_PUSH(c, char, ch); } while(0)
+
+#define STRING_ERROR(ret) do { c->top = head; return ret; } while(0)
+
+static const char* lept_parse_hex4(const char* p, const char* end, unsigned* u) {
+    if(end - p < 4) {
+        return NULL;
+    }
+
+    *u = 0;
+    for(size_t i = 0; i < 4; i ++) {
+        unsigned char ch = (unsigned char)p[i];
+        *u <<= 4;
+        if(ch >= '0' && ch <= '9') {
+            *u |= ch - '0';
+        } else if(ch >= 'A' && ch <= 'F') {
+            *u |= ch - ('A' - 10);
+        } else if(ch >= 'a' && ch <= 'f') {
+            *u |= ch - ('a' - 10);
         } else {
-            /* continue handling this array */
-            c->json ++;
+            return NULL;
         }
-        lept_parse_whitespace(c);
+    }
+
+    return p + 4;
+}
+
+static const char* lept_surrogate_handling(const char* p, const char* end, unsigned* u) {
+    unsigned u2;
 
+    if(*u < 0xD800 || *u > 0xDBFF) {
+        /* dont need surrogate */
+        return p;
     }
 
-    /* copy to v->array.e */
-    v->type = LEPT_ARRAY;
-    v->array.size = size;
-    v->array.e = (lept_value*)malloc(v->array.size * sizeof(lept_value));
-    memcpy(v->array.e, lept_context_pop(c, v->array.size * sizeof(lept_value)), v->array.size * sizeof(lept_value));
+    if(!(end - p >= 2 && p[0] == '\\' && p[1] == 'u')) {
+        /** 0xFFFFFFFF is illegal in UCS, we use it as error:
+          * LEPT_PARSE_INVALID_UNICODE_SURROGATE */
+        *(int*)u = -1;
+        return NULL;
+    }
 
-    c->json ++;
+    if((p = lept_parse_hex4(p+2, end, &u2)) == NULL) {
+        /* LEPT_PARSE_INVALID_UNICODE_HEX */
+        return NULL;
+    }
 
-    return ret;
+    if(u2 < 0xDC00 || u2 > 0xDFFF) {
+        /** 0xFFFFFFFF is illegal in UCS, we use it as error:
+          * LEPT_PARSE_INVALID_UNICODE_SURROGATE */
+        *(int*)u = -1;
+        return NULL;
+    }
+
+    /* save codepoint */
+    *u = 0x10000 + (*u - 0xD800) * 0x400 + (u2 - 0xDC00);
+
+    return p;
 }
 
-/* parse object */
+/* write u as utf-8 to buf, returns the number of bytes (at most 4) */
+static size_t lept_encode_utf8(char* buf, unsigned u) {
+    if(u <= 0x7F) {
+        buf[0] = (char)u;
+        return 1;
+    }
 
-#define PUTM(c, m) do { LEPT_CONTEXT_PUSH(c, lept_member, m); } while(0)
+    if(u <= 0x7FF) {
+        buf[0] = (char)(0xC0 | (u >> 6));
+        buf[1] = (char)(0x80 | (u & 0x3F));
+        return 2;
+    }
 
-#define OBJECT_ERROR(ret) \
-    do { \
-        lept_member* p = (lept_member*)(void*)(c->stack + head); \
-        for(size_t i = 0; i < size; i ++) { \
-            free(p[i].k.s); \
-            lept_free(&p[i].v); \
-        } \
-        c->top = head; \
-        return ret; \
-    } while(0)
+    if(u <= 0xFFFF) {
+        buf[0] = (char)(0xE0 | ((u >> 12) & 0x3F));
+        buf[1] = (char)(0x80 | ((u >>  6) & 0x3F));
+        buf[2] = (char)(0x80 | ( u        & 0x3F));
+        return 3;
+    }
 
-int lept_parse_object(lept_context* c, lept_value* v) {
-    int ret;
-    size_t head = c->top, size = 0;
+    if(u <= 0x10FFFF) {
+        buf[0] = (char)(0xF0 | ((u >> 18) & 0xFF));
+        buf[1] = (char)(0x80 | ((u >> 12) & 0x3F));
+        buf[2] = (char)(0x80 | ((u >>  6) & 0x3F));
+        buf[3] = (char)(0x80 | ( u        & 0x3F));
+        return 4;
+    }
 
-    assert(*(c->json)++ == '{');
+    /* never reach here */
+    assert(0);
+    return 0;
+}
 
-    lept_parse_whitespace(c);
+/* decode the escape sequence after a backslash at p into buf */
+static const char* lept_parse_escape(const char* p, const char* end, char* buf, size_t* n, int* ret) {
+    unsigned u; /* codepoint */
 
-    // empty object
-    if(*(c->json) == '}') {
-        v->type = LEPT_OBJECT;
-        v->object.m = NULL;
-        v->object.size = 0;
-        c->json ++;
-        return LEPT_PARSE_OK;
+    /* the end of input reads as '\0', an invalid escape */
+    *n = 1;
+    switch(p < end ? *p++ : '\0') {
+        case '\"': buf[0] = '\"'; return p;
+        case '\\': buf[0] = '\\'; return p;
+        case '/':  buf[0] = '/'; return p;
+        case 'b':  buf[0] = '\b'; return p;
+        case 'f':  buf[0] = '\f'; return p;
+        case 'n':  buf[0] = '\n'; return p;
+        case 'r':  buf[0] = '\r'; return p;
+        case 't':  buf[0] = '\t'; return p;
+        case 'u':
+            /* convert to codepoint and save it in u */
+            if((p = lept_parse_hex4(p, end, &u)) == NULL) {
+                *ret = LEPT_PARSE_INVALID_UNICODE_HEX;
+                return NULL;
+            }
+            /* surrogate handling */
+            if((p = lept_surrogate_handling(p, end, &u)) == NULL) {
+                *ret = ((int)u == -1) ? LEPT_PARSE_INVALID_UNICODE_SURROGATE : LEPT_PARSE_INVALID_UNICODE_HEX;
+                return NULL;
+            }
+            /* convert to utf-8 and save it */
+            *n = lept_encode_utf8(buf, u);
+            return p;
+        default:
+            *ret = LEPT_PARSE_INVALID_ESCAPE;
+            return NULL;
     }
+}
 
-    while(1) {
-        lept_member m;
-        lept_value v;
+/**
+  * decode the string at c->json into [*s, *s + *len), which is on top of the
+  * stack (to be popped by the caller), or in place over the input itself
+  * when parsing in situ; decoding never makes a string longer, so the
+  * writes trail the reads and the '\0' fits where the closing quote was
+  */
+static int lept_parse_string_raw(lept_context* c, char** s, size_t* len) {
+    size_t head = c->top;
+    const char* p = c->json;
+    char* w; /* in-situ write position, NULL when decoding onto the stack */
 
-        // key
-        lept_init(&v);
-        if(*(c->json) != '\"') {
-            OBJECT_ERROR(LEPT_PARSE_MISS_KEY);
-        }
-        ret = lept_parse_string(c, &v);
-        if(ret != LEPT_PARSE_OK) {
-            OBJECT_ERROR(ret);
+    assert(*p == '\"');
+    p ++;
+
+    w = c->insitu ? (char*)p : NULL;
+    *s = w;
+
+    if(p < c->end && *p == '\"') {
+        if(w != NULL) {
+            *w = '\0';
+        } else {
+            *s = (char*)"";
         }
-        m.k.s = v.string.s; m.k.len = v.string.len;
-        lept_parse_whitespace(c);
-        if(*(c->json ++) != ':') {
-            OBJECT_ERROR(LEPT_PARSE_MISS_COLON);
+        *len = 0;
+        c->json = ++ p;
+        return LEPT_PARSE_OK;
+    }
+
+    for(;;) {
+        /* copy the run of plain characters at once */
+        const char* q = lept_scan_string(p, c->end);
+        if(q != p) {
+            if(w == NULL) {
+                memcpy(lept_context_push(c, q - p), p, q - p);
+            } else {
+                /* nothing moves until the first escape */
+                if(w != p) {
+                    memmove(w, p, q - p);
+                }
+                w += q - p;
+            }
+            p = q;
         }
-        // value
-        lept_init(&m.v);
-        lept_parse_whitespace(c);
-        ret = lept_parse_value(c, &m.v);
-        if(ret != LEPT_PARSE_OK) {
-            OBJECT_ERROR(ret);
+        if(p == c->end) {
+            STRING_ERROR(LEPT_PARSE_MISS_QUOTATION_MARK);
         }
-        PUTM(c, m); size ++;
 
-        /* handle ws and ',' */
-        const char* p;
-        lept_parse_whitespace(c);
-        if(*(p = c->json) == '}') {
-            break;
-        } else if(*p != ',') {
-            OBJECT_ERROR(LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET);
-        } else {
-            /* continue handling this array */
-            c->json ++;
+        unsigned char ch = *p++;
+        switch (ch) {
+            case '\"':
+                if(w == NULL) {
+                    *len = c->top - head;
+                    *s = (char*)lept_context_pop(c, *len);
+                } else {
+                    *len = w - *s;
+                    *w = '\0';
+                }
+                c->json = p;
+                return LEPT_PARSE_OK;
+            case '\\': {
+                char buf[4];
+                size_t n;
+                int ret;
+                if((p = lept_parse_escape(p, c->end, buf, &n, &ret)) == NULL) {
+                    STRING_ERROR(ret);
+                }
+                if(w == NULL) {
+                    memcpy(lept_context_push(c, n), buf, n);
+                } else {
+                    memcpy(w, buf, n);
+                    w += n;
+                }
+                break;
+            }
+            default:
+                /* lept_scan_string() only stops at control characters here */
+                STRING_ERROR(LEPT_PARSE_INVALID_STRING_CHAR);
         }
-        lept_parse_whitespace(c);
     }
+}
 
-    /* copy to v->object.m */
-    v->type = LEPT_OBJECT;
-    v->object.size = size;
-    v->object.m = (lept_member*)malloc(v->object.size * sizeof(lept_member));
-    memcpy(v->object.m, lept_context_pop(c, v->object.size * sizeof(lept_member)), v->object.size * sizeof(lept_member));
+static int lept_parse_string(lept_context* c) {
+    char* s;
+    size_t len;
+    int ret;
+
+    if((ret = lept_parse_string_raw(c, &s, &len)) != LEPT_PARSE_OK) {
+        return ret;
+    }
+    LEPT_SAX_CALL(c, string, (c->user, s, len));
+    return LEPT_PARSE_OK;
+}
+
+/* parse
+ *
+ * Containers do not recurse: each one entered is pushed on c->levels, and a
+ * single loop alternates between parsing a value and, once it is complete,
+ * stepping past the ',' that starts the next one or the brackets that
+ * close the containers it finished. Nesting costs heap, not C stack, and is
+ * bounded by lept_set_max_depth().
+ */
+
+/* a key, its colon and the whitespace around them */
+static int lept_parse_member_key(lept_context* c) {
+    char* s;
+    size_t len;
+    int ret;
 
+    if(LEPT_PEEK(c, c->json) != '\"') {
+        return LEPT_PARSE_MISS_KEY;
+    }
+    if((ret = lept_parse_string_raw(c, &s, &len)) != LEPT_PARSE_OK) {
+        return ret;
+    }
+    LEPT_SAX_CALL(c, key, (c->user, s, len));
+    lept_parse_whitespace(c);
+    if(LEPT_PEEK(c, c->json) != ':') {
+        return LEPT_PARSE_MISS_COLON;
+    }
     c->json ++;
+    lept_parse_whitespace(c);
 
-    return ret;
+    return LEPT_PARSE_OK;
 }
 
-/* parse */
+static int lept_parse_value(lept_context* c) {
+    size_t base = c->depth; /* containers outside this value */
+    lept_level* l;
+    int ret;
+    char ch;
+
+    for(;;) {
+        /* a value */
+        if(c->json == c->end) {
+            return LEPT_PARSE_EXPECT_VALUE;
+        }
+        switch(ch = *c->json) {
+            case '0': case '1': case '2': case '3': case '4': case '5':
+            case '6': case '7': case '8': case '9': case '-':
+                ret = lept_parse_number(c); break;
+            case 'f':  ret = lept_parse_literal(c, "false", LEPT_FALSE); break;
+            case 't':  ret = lept_parse_literal(c, "true", LEPT_TRUE); break;
+            case 'n':  ret = lept_parse_literal(c, "null", LEPT_NULL); break;
+            case '\"': ret = lept_parse_string(c); break;
+            case '[':
+            case '{':
+                if((ret = lept_context_open(c, ch)) != LEPT_PARSE_OK) {
+                    return ret;
+                }
+                c->json ++;
+                if(ch == '[') {
+                    LEPT_SAX_CALL(c, start_array, (c->user));
+                } else {
+                    LEPT_SAX_CALL(c, start_object, (c->user));
+                }
+                lept_parse_whitespace(c);
+                /* empty, ']' and '}' come two after '[' and '{' */
+                if(LEPT_PEEK(c, c->json) == ch + 2) {
+                    c->json ++;
+                    c->depth --;
+                    if(ch == '[') {
+                        LEPT_SAX_CALL(c, end_array, (c->user, 0));
+                    } else {
+                        LEPT_SAX_CALL(c, end_object, (c->user, 0));
+                    }
+                    ret = LEPT_PARSE_OK;
+                    break;
+                }
+                if(ch == '{' && (ret = lept_parse_member_key(c)) != LEPT_PARSE_OK) {
+                    return ret;
+                }
+                continue; /* with the first element */
+            default:   return LEPT_PARSE_INVALID_VALUE;
+        }
+        if(ret != LEPT_PARSE_OK) {
+            return ret;
+        }
 
-static int lept_parse_value(lept_context* c, lept_value* v) {
-    switch(*c->json) {
-        case '0': case '1': case '2': case '3': case '4': case '5':
-        case '6': case '7': case '8': case '9': case '-':
-            return lept_parse_number(c, v);
-        case 'f':  return lept_parse_literal(c, v, "false", LEPT_FALSE);
-        case 't':  return lept_parse_literal(c, v, "true", LEPT_TRUE);
-        case 'n':  return lept_parse_literal(c, v, "null", LEPT_NULL);
-        case '\"': return lept_parse_string(c, v);
-        case '[':  return lept_parse_array(c, v);
-        case '{':  return lept_parse_object(c, v);
-        case '\0': return LEPT_PARSE_EXPECT_VALUE;
-        default:   return LEPT_PARSE_INVALID_VALUE;
+        /* the value is complete, close whatever it completes */
+        for(;;) {
+            if(c->depth == base) {
+                return LEPT_PARSE_OK;
+            }
+            l = &c->levels[c->depth - 1];
+            l->size ++;
+
+            /* handle ws and ',' */
+            lept_parse_whitespace(c);
+            ch = LEPT_PEEK(c, c->json);
+            if(ch == ',') {
+                c->json ++;
+                lept_parse_whitespace(c);
+                if(l->kind == '{' && (ret = lept_parse_member_key(c)) != LEPT_PARSE_OK) {
+                    return ret;
+                }
+                break; /* on to the next element */
+            }
+            if(ch != l->kind + 2) {
+                return (l->kind == '[') ? LEPT_PARSE_INVALID_VALUE : LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET;
+            }
+            c->json ++;
+            c->depth --;
+            if(l->kind == '[') {
+                LEPT_SAX_CALL(c, end_array, (c->user, l->size));
+            } else {
+                LEPT_SAX_CALL(c, end_object, (c->user, l->size));
+            }
+        }
     }
 }
 
-int lept_parse(lept_value* v, const char* json) {
-    lept_context c;
+static int lept_parse_root(lept_context* c) {
     int ret;
 
-    assert(v != NULL);
-
-    /* initialize */
-    lept_init(v);
-    lept_context_init(&c, json);
-    ret = LEPT_PARSE_INVALID_VALUE;
+    if(c->engine == LEPT_ENGINE_INDEX) {
+        lept_index_build(c);
+    }
 
     /* parse json */
-    lept_parse_whitespace(&c);
-    ret = lept_parse_value(&c, v);
-    lept_parse_whitespace(&c);
+    lept_parse_whitespace(c);
+    ret = lept_parse_value(c);
+    lept_parse_whitespace(c);
 
     /* check end */
-    if(ret == LEPT_PARSE_OK && *(c.json) != '\0') {
+    if(ret == LEPT_PARSE_OK && c->json != c->end) {
         ret = LEPT_PARSE_ROOT_NOT_SINGULAR;
     }
 
-    lept_context_free(&c);
+    free(c->index);
+    c->index = NULL;
+    free(c->levels);
+    c->levels = NULL;
+    c->depth = c->levels_size = 0;
 
     return ret;
 }
 
-lept_type lept_get_type(const lept_value* v) {
-    assert(v != NULL);
-    return v->type;
-}
+int lept_parse_sax(const char* json, size_t len, const lept_sax_handler* h, void* user) {
+    lept_context c;
+    int ret;
 
-/* init && free */
+    assert(h != NULL && (json != NULL || len == 0));
 
-void lept_init(lept_value* v) {
-    memset(v, 0, sizeof(lept_value));
-    v->type = LEPT_NULL;
+    /* initialize */
+    lept_context_init(&c, json, len);
+    c.sax = h;
+    c.user = user;
+
+    ret = lept_parse_root(&c);
+
+    lept_context_free(&c);
+
+    return ret;
 }
 
-void lept_free(lept_value* v) {
-    assert(v != NULL);
-    if(v->type == LEPT_STRING && v->string.len > 0) {
-        free(v->string.s);
-        v->string.s = NULL;
-        v->string.len = 0;
-    } else if(v->type == LEPT_ARRAY && v->array.size > 0) {
-        for(size_t i = 0; i < v->array.size; i ++) {
-            lept_free(&v->array.e[i]);
-        }
-        free(v->array.e);
-        v->array.e = NULL;
-        v->array.size = 0;
-    } else if(v->type == LEPT_OBJECT && v->object.size > 0) {
-        for(size_t i = 0; i < v->object.size; i ++) {
-            free(v->object.m[i].k.s);
-            lept_free(&v->object.m[i].v);
-        }
-        free(v->object.m);
-        v->object.m = NULL;
-        v->object.size = 0;
+/* object hash index
+ *
+ * Objects of LEPT_OBJECT_HASH_MIN members or more get room for an open
+ * addressing table right after their members. The slots hold member index
+ * + 1 (0: empty) and are filled whenever the members are laid out or
+ * moved, so a lookup only reads and one tree can be searched from several
+ * threads at once. Members keep their order, the table only points at them.
+ */
+
+/* number of slots, a power of two at least twice the size, or 0 */
+static size_t lept_object_slots(size_t size) {
+    size_t n = LEPT_OBJECT_HASH_MIN * 2;
+    if(size < LEPT_OBJECT_HASH_MIN) {
+        return 0;
     }
-    /* to avoid double free */
-    v->type = LEPT_NULL;
+    while(n < size * 2) {
+        n <<= 1;
+    }
+    return n;
 }
 
-/* string */
+/* a grown array or object has a power of two of room, a parsed one its size */
+#define LEPT_CAPACITY(v) ((v)->cap ? (size_t)1 << ((v)->cap - 1) : (size_t)(v)->size)
 
-const char* lept_get_string(const lept_value* v) {
-    assert(v != NULL && v->type == LEPT_STRING);
-    return v->string.s;
+/* the table is sized for the capacity, so appending keeps it valid */
+#define LEPT_OBJECT_SLOTS(v) ((uint32_t*)(void*)((v)->m + LEPT_CAPACITY(v)))
+
+/* FNV-1a */
+static uint32_t lept_hash_key(const char* s, size_t len) {
+    uint32_t h = 2166136261u;
+    for(size_t i = 0; i < len; i ++) {
+        h = (h ^ (unsigned char)s[i]) * 16777619u;
+    }
+    return h;
 }
 
-size_t lept_get_string_length(const lept_value* v) {
+/* member i in the table */
+static void lept_object_slot(uint32_t* slots, size_t mask, const char* key, size_t klen, size_t i) {
+    size_t j = lept_hash_key(key, klen) & mask;
+    /* a duplicate key lands behind the first one, which stays found */
+    while(slots[j] != 0) {
+        j = (j + 1) & mask;
+    }
+    slots[j] = (uint32_t)(i + 1);
+}
+
+/* the table of an object with room for one, from its members */
+static void lept_object_index(lept_value* v) {
+    size_t n = lept_object_slots(LEPT_CAPACITY(v));
+    uint32_t* slots;
+
+    if(n == 0) {
+        return ;
+    }
+    slots = LEPT_OBJECT_SLOTS(v);
+    memset(slots, 0, n * sizeof(uint32_t));
+    for(size_t i = 0; i < v->size; i ++) {
+        const lept_value* k = &v->m[i].k;
+        lept_object_slot(slots, n - 1, LEPT_STRING_PTR(k), LEPT_STRING_LEN(k), i);
+    }
+}
+
+/* intern
+ *
+ * An open-addressing set of keys, kept at most half full. The text lives in
+ * an arena of its own, so a key never moves once handed out.
+ */
+
+#ifndef LEPT_INTERN_INIT_SLOTS
+#define LEPT_INTERN_INIT_SLOTS 64
+#endif
+
+typedef struct {
+    const char* s; /* NULL: free slot */
+    uint32_t len, hash;
+} lept_intern_entry;
+
+struct lept_intern {
+    lept_intern_entry* slots;
+    size_t mask, count, bytes;
+    lept_arena text;
+};
+
+lept_intern* lept_intern_new() {
+    lept_intern* t = (lept_intern*)malloc(sizeof(lept_intern));
+    t->slots = (lept_intern_entry*)calloc(LEPT_INTERN_INIT_SLOTS, sizeof(lept_intern_entry));
+    t->mask = LEPT_INTERN_INIT_SLOTS - 1;
+    t->count = t->bytes = 0;
+    lept_arena_init(&t->text, 4096);
+    return t;
+}
+
+void lept_intern_free(lept_intern* t) {
+    if(t != NULL) {
+        free(t->slots);
+        lept_arena_free(&t->text);
+        free(t);
+    }
+}
+
+static void lept_intern_grow(lept_intern* t) {
+    size_t mask = t->mask * 2 + 1;
+    lept_intern_entry* slots = (lept_intern_entry*)calloc(mask + 1, sizeof(lept_intern_entry));
+
+    for(size_t i = 0; i <= t->mask; i ++) {
+        if(t->slots[i].s != NULL) {
+            size_t j = t->slots[i].hash & mask;
+            while(slots[j].s != NULL) {
+                j = (j + 1) & mask;
+            }
+            slots[j] = t->slots[i];
+        }
+    }
+    free(t->slots);
+    t->slots = slots;
+    t->mask = mask;
+}
+
+const char* lept_intern_key(lept_intern* t, const char* key, size_t klen) {
+    uint32_t h;
+    size_t j;
+    char* s;
+
+    assert(t != NULL && (key != NULL || klen == 0) && klen <= UINT32_MAX);
+    h = lept_hash_key(key, klen);
+    for(j = h & t->mask; t->slots[j].s != NULL; j = (j + 1) & t->mask) {
+        if(t->slots[j].hash == h && t->slots[j].len == klen && memcmp(t->slots[j].s, key, klen) == 0) {
+            return t->slots[j].s;
+        }
+    }
+
+    s = (char*)lept_arena_alloc(&t->text, klen + 1);
+    memcpy(s, key, klen);
+    s[klen] = '\0';
+    t->slots[j].s = s;
+    t->slots[j].len = (uint32_t)klen;
+    t->slots[j].hash = h;
+    t->bytes += klen + 1;
+    if(++ t->count * 2 > t->mask + 1) {
+        lept_intern_grow(t);
+    }
+
+    return s;
+}
+
+size_t lept_intern_size(const lept_intern* t) {
+    assert(t != NULL);
+    return t->bytes;
+}
+
+/* build dom
+ *
+ * The tree is one more handler. Finished values are pushed on the context
+ * stack, keys too as string values, and each end event pops the elements
+ * or key/value pairs of its container into one node. After an error the
+ * stack holds nothing but values, so unwinding is a loop of lept_free().
+ */
+
+#define PUTV(c, v) do { LEPT_CONTEXT_PUSH(c, lept_value, v); } while(0)
+
+static int lept_dom_literal(lept_context* c, lept_type type) {
+    lept_value v;
+    lept_init(&v);
+    v.type = type;
+    PUTV(c, v);
+    return 0;
+}
+
+static int lept_dom_null(void* user) {
+    return lept_dom_literal((lept_context*)user, LEPT_NULL);
+}
+
+static int lept_dom_boolean(void* user, int b) {
+    return lept_dom_literal((lept_context*)user, b ? LEPT_TRUE : LEPT_FALSE);
+}
+
+static int lept_dom_number(void* user, double d) {
+    lept_context* c = (lept_context*)user;
+    lept_value v;
+    lept_init(&v);
+    v.n = d;
+    v.type = LEPT_NUMBER;
+    PUTV(c, v);
+    return 0;
+}
+
+static int lept_dom_string(void* user, const char* s, size_t len) {
+    lept_context* c = (lept_context*)user;
+    lept_value v;
+    lept_init(&v);
+    if(len > UINT32_MAX) {
+        /* beyond what a node can hold */
+        c->abort_ret = LEPT_PARSE_TOO_LONG;
+        return 1;
+    }
+    if(c->insitu) {
+        /* borrowed from the input, nothing to copy */
+        v.s = (char*)s;
+        v.size = (uint32_t)len;
+        v.type = LEPT_STRING;
+        v.flags = LEPT_BORROWED;
+    } else {
+        /* s sits just above the stack top, copy it out before pushing */
+        lept_context_set_string(c, &v, s, len);
+    }
+    PUTV(c, v);
+    return 0;
+}
+
+/* a long key is shared through the intern table, if any */
+static int lept_dom_key(void* user, const char* s, size_t len) {
+    lept_context* c = (lept_context*)user;
+    lept_value v;
+
+    if(c->intern == NULL || c->insitu || len <= LEPT_INLINE_MAX || len > UINT32_MAX) {
+        return lept_dom_string(user, s, len);
+    }
+    lept_init(&v);
+    v.s = (char*)lept_intern_key(c->intern, s, len);
+    v.size = (uint32_t)len;
+    v.type = LEPT_STRING;
+    v.flags = LEPT_BORROWED;
+    PUTV(c, v);
+    return 0;
+}
+
+static int lept_dom_start(void* user) {
+    (void)user;
+    return 0;
+}
+
+static int lept_dom_end_array(void* user, size_t size) {
+    lept_context* c = (lept_context*)user;
+    lept_value v;
+
+    if(size > UINT32_MAX) {
+        c->abort_ret = LEPT_PARSE_TOO_LONG;
+        return 1;
+    }
+    /* copy to v.e */
+    lept_init(&v);
+    v.type = LEPT_ARRAY;
+    v.flags = LEPT_CONTEXT_FLAGS(c);
+    v.size = (uint32_t)size;
+    if(size > 0) {
+        v.e = (lept_value*)lept_context_alloc(c, size * sizeof(lept_value));
+        memcpy(v.e, lept_context_pop(c, size * sizeof(lept_value)), size * sizeof(lept_value));
+    }
+    PUTV(c, v);
+    return 0;
+}
+
+static int lept_dom_end_object(void* user, size_t size) {
+    lept_context* c = (lept_context*)user;
+    lept_value v, *p;
+
+    assert(sizeof(lept_member) == 2 * sizeof(lept_value));
+    if(size > UINT32_MAX) {
+        c->abort_ret = LEPT_PARSE_TOO_LONG;
+        return 1;
+    }
+    /* key/value pairs are laid out as members already */
+    lept_init(&v);
+    v.type = LEPT_OBJECT;
+    v.flags = LEPT_CONTEXT_FLAGS(c);
+    v.size = (uint32_t)size;
+    if(size > 0) {
+        v.m = (lept_member*)lept_context_alloc(c,
+            size * sizeof(lept_member) + lept_object_slots(size) * sizeof(uint32_t));
+        p = (lept_value*)lept_context_pop(c, size * 2 * sizeof(lept_value));
+        memcpy(v.m, p, size * sizeof(lept_member));
+        lept_object_index(&v);
+    }
+    PUTV(c, v);
+    return 0;
+}
+
+static const lept_sax_handler lept_dom_handler = {
+    lept_dom_null,
+    lept_dom_boolean,
+    lept_dom_number,
+    lept_dom_string,
+    lept_dom_start,
+    lept_dom_end_array,
+    lept_dom_start,
+    lept_dom_key,
+    lept_dom_end_object
+};
+
+/* on success the root is the one value left on the stack */
+static int lept_parse_dom(lept_context* c, lept_value* v) {
+    int ret;
+
+    c->sax = &lept_dom_handler;
+    c->user = c;
+
+    ret = lept_parse_root(c);
+    if(ret == LEPT_PARSE_OK) {
+        *v = LEPT_CONTEXT_POP(c, lept_value);
+    } else {
+        while(c->top > 0) {
+            lept_free((lept_value*)lept_context_pop(c, sizeof(lept_value)));
+        }
+    }
+
+    return ret;
+}
+
+int lept_parse(lept_value* v, const char* json) {
+    assert(json != NULL);
+    return lept_parse_n(v, json, strlen(json));
+}
+
+int lept_parse_n(lept_value* v, const char* json, size_t len) {
+    lept_context c;
+    int ret;
+
+    assert(v != NULL && (json != NULL || len == 0));
+
+    /* initialize */
+    lept_init(v);
+    lept_context_init(&c, json, len);
+
+    ret = lept_parse_dom(&c, v);
+
+    lept_context_free(&c);
+
+    return ret;
+}
+
+void lept_parse_options_init(lept_parse_options* o) {
+    assert(o != NULL);
+    o->max_depth = lept_parse_max_depth;
+    o->engine = lept_parse_engine;
+}
+
+int lept_parse_ex(lept_value* v, const char* json, size_t len, const lept_parse_options* o) {
+    lept_context c;
+    int ret;
+
+    assert(v != NULL && (json != NULL || len == 0) && o != NULL);
+    assert(o->engine == LEPT_ENGINE_RECURSIVE || o->engine == LEPT_ENGINE_INDEX);
+
+    /* initialize */
+    lept_init(v);
+    lept_context_init(&c, json, len);
+    c.max_depth = o->max_depth;
+    c.engine = o->engine;
+
+    ret = lept_parse_dom(&c, v);
+
+    lept_context_free(&c);
+
+    return ret;
+}
+
+int lept_parse_insitu(lept_value* v, char* json, size_t len) {
+    lept_context c;
+    int ret;
+
+    assert(v != NULL && (json != NULL || len == 0));
+
+    /* initialize */
+    lept_init(v);
+    lept_context_init(&c, json, len);
+    c.insitu = 1;
+
+    ret = lept_parse_dom(&c, v);
+
+    lept_context_free(&c);
+
+    return ret;
+}
+
+int lept_parse_arena(lept_value* v, const char* json, size_t len, lept_arena* a) {
+    lept_context c;
+    int ret;
+
+    assert(v != NULL && (json != NULL || len == 0) && a != NULL);
+
+    /* initialize, borrowing the parse stack kept in the arena */
+    lept_init(v);
+    lept_context_init(&c, json, len);
+    c.arena = a;
+    c.stack = a->stack;
+    c.size = a->stack_size;
+
+    ret = lept_parse_dom(&c, v);
+
+    assert(c.top == 0);
+    a->stack = c.stack;
+    a->stack_size = c.size;
+
+    return ret;
+}
+
+int lept_parse_intern(lept_value* v, const char* json, size_t len, lept_intern* t) {
+    lept_context c;
+    int ret;
+
+    assert(v != NULL && (json != NULL || len == 0) && t != NULL);
+
+    /* initialize */
+    lept_init(v);
+    lept_context_init(&c, json, len);
+    c.intern = t;
+
+    ret = lept_parse_dom(&c, v);
+
+    lept_context_free(&c);
+
+    return ret;
+}
+
+/* threads
+ *
+ * lept_run_jobs() calls fn on each of n jobs, one thread per job, the
+ * first on the calling thread. A job whose thread cannot be created runs
+ * inline instead. The scan kernels are chosen before any thread starts.
+ */
+
+#ifndef LEPT_MAX_THREADS
+#define LEPT_MAX_THREADS 64
+#endif
+
+typedef void (*lept_job_fn)(void* job);
+
+typedef struct {
+    lept_job_fn fn;
+    void* job;
+} lept_thread_arg;
+
+#ifdef _WIN32
+static DWORD WINAPI lept_thread_main(LPVOID arg)
+#else
+static void* lept_thread_main(void* arg)
+#endif
+{
+    lept_thread_arg* a = (lept_thread_arg*)arg;
+    a->fn(a->job);
+    return 0;
+}
+
+static void lept_run_jobs(lept_job_fn fn, void* jobs, size_t job_size, int n) {
+    lept_thread_arg args[LEPT_MAX_THREADS];
+    int t, started = 0;
+#ifdef _WIN32
+    HANDLE threads[LEPT_MAX_THREADS];
+#else
+    pthread_t threads[LEPT_MAX_THREADS];
+#endif
+
+    assert(n >= 1 && n <= LEPT_MAX_THREADS);
+    lept_scan_init();
+    for(t = 1; t < n; t ++) {
+        args[started].fn = fn;
+        args[started].job = (char*)jobs + t * job_size;
+#ifdef _WIN32
+        threads[started] = CreateThread(NULL, 0, lept_thread_main, &args[started], 0, NULL);
+        if(threads[started] != NULL) {
+            started ++;
+            continue;
+        }
+#else
+        if(pthread_create(&threads[started], NULL, lept_thread_main, &args[started]) == 0) {
+            started ++;
+            continue;
+        }
+#endif
+        fn((char*)jobs + t * job_size);
+    }
+    fn(jobs);
+#ifdef _WIN32
+    WaitForMultipleObjects((DWORD)started, threads, TRUE, INFINITE);
+    for(t = 0; t < started; t ++) {
+        CloseHandle(threads[t]);
+    }
+#else
+    for(t = 0; t < started; t ++) {
+        pthread_join(threads[t], NULL);
+    }
+#endif
+}
+
+/* nthreads, 0 for one per online CPU, capped at LEPT_MAX_THREADS and jobs */
+static int lept_threads(int nthreads, size_t jobs) {
+    if(nthreads <= 0) {
+#ifdef _WIN32
+        SYSTEM_INFO si;
+        GetSystemInfo(&si);
+        nthreads = (int)si.dwNumberOfProcessors;
+#else
+        long n = sysconf(_SC_NPROCESSORS_ONLN);
+        nthreads = (n > 0) ? (int)n : 1;
+#endif
+    }
+    if(nthreads > LEPT_MAX_THREADS) {
+        nthreads = LEPT_MAX_THREADS;
+    }
+    if((size_t)nthreads > jobs) {
+        nthreads = (jobs > 0) ? (int)jobs : 1;
+    }
+    return nthreads;
+}
+
+/* lines
+ *
+ * The line breaks are found up front, then each worker takes a contiguous
+ * run of lines holding about the same number of bytes, and parses them with
+ * a context of its own whose stack it keeps from line to line. Values are
+ * malloc()ed as usual.
+ */
+
+typedef struct {
+    const char* json;
+    const size_t* starts; /* line i is [starts[i], starts[i + 1] - 1) */
+    lept_line* lines;
+    size_t first, last;
+} lept_lines_job;
+
+static void lept_lines_worker(void* arg) {
+    lept_lines_job* job = (lept_lines_job*)arg;
+    lept_context c;
+    char* stack = NULL;
+    size_t stack_size = 0;
+
+    for(size_t i = job->first; i < job->last; i ++) {
+        lept_line* l = &job->lines[i];
+        lept_init(&l->v);
+        lept_context_init(&c, job->json + job->starts[i], job->starts[i + 1] - 1 - job->starts[i]);
+        c.stack = stack;
+        c.size = stack_size;
+        l->ret = lept_parse_dom(&c, &l->v);
+        assert(c.top == 0);
+        stack = c.stack;
+        stack_size = c.size;
+    }
+    free(stack);
+}
+
+size_t lept_parse_lines(const char* json, size_t len, lept_line** lines, int nthreads) {
+    lept_lines_job jobs[LEPT_MAX_THREADS];
+    size_t* starts;
+    size_t n = 0, cap = 256, first = 0;
+    const char* p = json;
+    const char* end = json + len;
+
+    assert(lines != NULL && (json != NULL || len == 0));
+
+    /* starts[n] is one past the '\n' ending line n - 1 */
+    starts = (size_t*)malloc(cap * sizeof(size_t));
+    starts[0] = 0;
+    while(p < end) {
+        const char* nl = (const char*)memchr(p, '\n', (size_t)(end - p));
+        if(++ n == cap) {
+            cap += cap >> 1;
+            starts = (size_t*)realloc(starts, cap * sizeof(size_t));
+        }
+        /* as if the last line had one */
+        starts[n] = (nl != NULL) ? (size_t)(nl + 1 - json) : len + 1;
+        p = (nl != NULL) ? nl + 1 : end;
+    }
+    *lines = (lept_line*)malloc((n > 0 ? n : 1) * sizeof(lept_line));
+
+    /* contiguous runs of about len / nthreads bytes */
+    nthreads = lept_threads(nthreads, n);
+    for(int t = 0; t < nthreads; t ++) {
+        size_t last = first;
+        size_t target = (size_t)((double)len * (t + 1) / nthreads);
+        while(last < n && (t == nthreads - 1 || starts[last] < target)) {
+            last ++;
+        }
+        jobs[t].json = json;
+        jobs[t].starts = starts;
+        jobs[t].lines = *lines;
+        jobs[t].first = first;
+        jobs[t].last = last;
+        first = last;
+    }
+    lept_run_jobs(lept_lines_worker, jobs, sizeof(lept_lines_job), nthreads);
+
+    free(starts);
+
+    return n;
+}
+
+void lept_free_lines(lept_line* lines, size_t n) {
+    for(size_t i = 0; i < n; i ++) {
+        lept_free(&lines[i].v);
+    }
+    free(lines);
+}
+
+/* parallel
+ *
+ * A quote and escape aware scan looks for a ',' between top-level elements
+ * after each of nthreads - 1 evenly spaced offsets. Every chunk between two
+ * such commas is a run of elements, parsed by its own worker one level deep
+ * onto its own stack; the runs are then copied into one array in order. A
+ * comma found at the wrong place can only leave some chunk unbalanced, so
+ * whenever a chunk fails, or no split is found, the whole document is
+ * parsed again the usual way, which also gives the usual error.
+ */
+
+#ifndef LEPT_PARALLEL_MIN_CHUNK
+#define LEPT_PARALLEL_MIN_CHUNK 65536 /* smaller documents are not split */
+#endif
+
+typedef struct {
+    const char* json;
+    const char* end;
+    char* stack; /* elements, as lept_values, on success */
+    size_t size;
+    int ret;
+} lept_chunk_job;
+
+static void lept_chunk_worker(void* arg) {
+    lept_chunk_job* job = (lept_chunk_job*)arg;
+    lept_context c;
+    int ret;
+
+    lept_context_init(&c, job->json, (size_t)(job->end - job->json));
+    c.sax = &lept_dom_handler;
+    c.user = &c;
+    if(c.engine == LEPT_ENGINE_INDEX) {
+        lept_index_build(&c);
+    }
+
+    /* inside the top-level array, for the depth limit */
+    ret = lept_context_open(&c, '[');
+    while(ret == LEPT_PARSE_OK) {
+        lept_parse_whitespace(&c);
+        if((ret = lept_parse_value(&c)) != LEPT_PARSE_OK) {
+            break;
+        }
+        lept_parse_whitespace(&c);
+        if(c.json == c.end) {
+            break;
+        }
+        if(*c.json ++ != ',') {
+            ret = LEPT_PARSE_INVALID_VALUE;
+        }
+    }
+
+    free(c.index);
+    free(c.levels);
+    if(ret != LEPT_PARSE_OK) {
+        while(c.top > 0) {
+            lept_free((lept_value*)lept_context_pop(&c, sizeof(lept_value)));
+        }
+    }
+    job->stack = c.stack;
+    job->size = c.top;
+    job->ret = ret;
+}
+
+/* after '\"', the byte past the closing one, or end */
+static const char* lept_skip_string(const char* p, const char* end) {
+    for(;;) {
+        p = lept_scan_string(p, end);
+        if(p == end) {
+            return end;
+        }
+        if(*p == '\"') {
+            return p + 1;
+        }
+        /* step over an escaped byte, or a stray control byte */
+        p += (*p == '\\' && p + 1 < end) ? 2 : 1;
+    }
+}
+
+/* offsets of top-level commas, the k-th at or past (k + 1) * len / n */
+static int lept_array_splits(const char* json, const char* p, const char* end, size_t* splits, int n) {
+    size_t len = (size_t)(end - json);
+    size_t depth = 0;
+    int k = 0;
+
+    while(p < end && k < n - 1) {
+        switch(*p) {
+            case '\"': p = lept_skip_string(p + 1, end); continue;
+            case '[': case '{': depth ++; break;
+            case ']': case '}':
+                if(depth == 0) {
+                    return k; /* the array ends here */
+                }
+                depth --;
+                break;
+            case ',':
+                if(depth == 0 && (size_t)(p - json) >= (size_t)((double)len * (k + 1) / n)) {
+                    splits[k ++] = (size_t)(p - json);
+                }
+                break;
+            default: break;
+        }
+        p ++;
+    }
+    return k;
+}
+
+int lept_parse_parallel(lept_value* v, const char* json, size_t len, int nthreads) {
+    lept_chunk_job jobs[LEPT_MAX_THREADS];
+    size_t splits[LEPT_MAX_THREADS];
+    const char* p = json;
+    const char* end = json + len;
+    const char* last;
+    size_t size = 0;
+    int t, ret = LEPT_PARSE_OK;
+
+    assert(v != NULL && (json != NULL || len == 0));
+
+    nthreads = lept_threads(nthreads, len / LEPT_PARALLEL_MIN_CHUNK);
+    lept_scan_init();
+    while(p < end && LEPT_ISWS(*p)) {
+        p ++;
+    }
+    last = end;
+    while(last > p && LEPT_ISWS(last[-1])) {
+        last --;
+    }
+    if(nthreads < 2 || p == end || *p != '[' || last[-1] != ']') {
+        return lept_parse_n(v, json, len);
+    }
+    if((nthreads = lept_array_splits(json, p + 1, last - 1, splits, nthreads) + 1) < 2) {
+        return lept_parse_n(v, json, len);
+    }
+
+    /* the elements between '[', the splits and ']' */
+    for(t = 0; t < nthreads; t ++) {
+        jobs[t].json = (t == 0) ? p + 1 : json + splits[t - 1] + 1;
+        jobs[t].end = (t == nthreads - 1) ? last - 1 : json + splits[t];
+    }
+    lept_run_jobs(lept_chunk_worker, jobs, sizeof(lept_chunk_job), nthreads);
+
+    for(t = 0; t < nthreads; t ++) {
+        size += jobs[t].size / sizeof(lept_value);
+        if(jobs[t].ret != LEPT_PARSE_OK) {
+            ret = jobs[t].ret;
+        }
+    }
+    if(ret == LEPT_PARSE_OK && size > UINT32_MAX) {
+        ret = LEPT_PARSE_TOO_LONG;
+    }
+
+    lept_init(v);
+    if(ret == LEPT_PARSE_OK) {
+        char* e = (char*)malloc(size * sizeof(lept_value));
+        v->e = (lept_value*)(void*)e;
+        v->size = (uint32_t)size;
+        v->type = LEPT_ARRAY;
+        for(t = 0; t < nthreads; t ++) {
+            memcpy(e, jobs[t].stack, jobs[t].size);
+            e += jobs[t].size;
+        }
+    } else {
+        for(t = 0; t < nthreads; t ++) {
+            for(size_t i = 0; i < jobs[t].size; i += sizeof(lept_value)) {
+                lept_free((lept_value*)(void*)(jobs[t].stack + i));
+            }
+        }
+    }
+    for(t = 0; t < nthreads; t ++) {
+        free(jobs[t].stack);
+    }
+
+    /* the sequential parse finds the first error, which a chunk may not see */
+    return (ret == LEPT_PARSE_OK || ret == LEPT_PARSE_TOO_LONG) ? ret : lept_parse_n(v, json, len);
+}
+
+/* stream
+ *
+ * The push parser keeps everything the recursive parser holds on the C call
+ * stack in the lept_stream instead: one level per open container, and the
+ * state within the innermost one. Structural characters are handled as they
+ * arrive. A string or scalar token is parsed by the usual token parsers once
+ * its end is seen, straight from the chunk when it fits there, otherwise
+ * from a pending copy built up across chunks. Events go to the DOM handler,
+ * so the tree and the error codes are the ones lept_parse_n() gives.
+ */
+
+typedef enum {
+    LEPT_STREAM_VALUE,        /* at the root, after ',' in an array or ':' */
+    LEPT_STREAM_ARRAY_FIRST,  /* after '[' */
+    LEPT_STREAM_OBJECT_FIRST, /* after '{' */
+    LEPT_STREAM_KEY,          /* after ',' in an object */
+    LEPT_STREAM_COLON,        /* after a key */
+    LEPT_STREAM_NEXT          /* after a value */
+} lept_stream_state;
+
+typedef enum {
+    LEPT_TOKEN_NONE,
+    LEPT_TOKEN_SCALAR, /* number or literal */
+    LEPT_TOKEN_STRING,
+    LEPT_TOKEN_KEY
+} lept_stream_token;
+
+struct lept_stream {
+    lept_context c; /* dom values on its stack, open containers in its levels */
+    lept_stream_state state;
+    lept_stream_token token;
+    int escaped;    /* the pending string ends in an unfinished escape */
+    char* pending;  /* token split across chunks */
+    size_t pending_len, pending_size;
+    int ret;        /* first error, sticky until lept_stream_finish() */
+};
+
+/* bytes ending a number or literal: whitespace, '"' and the operators */
+static const unsigned char lept_delim[256] = {
+    ['\t'] = 1, ['\n'] = 1, ['\r'] = 1, [' '] = 1, ['\"'] = 1, [','] = 1, [':'] = 1,
+    ['['] = 1, [']'] = 1, ['{'] = 1, ['}'] = 1
+};
+
+#define LEPT_ISDELIM(ch) (lept_delim[(unsigned char)(ch)])
+
+static void lept_stream_reset(lept_stream* s) {
+    while(s->c.top > 0) {
+        lept_free((lept_value*)lept_context_pop(&s->c, sizeof(lept_value)));
+    }
+    s->c.depth = 0;
+    s->c.max_depth = lept_parse_max_depth; /* the default when a document starts */
+    s->state = LEPT_STREAM_VALUE;
+    s->token = LEPT_TOKEN_NONE;
+    s->escaped = 0;
+    s->pending_len = 0;
+    s->ret = LEPT_PARSE_OK;
+}
+
+lept_stream* lept_stream_new() {
+    lept_stream* s = (lept_stream*)malloc(sizeof(lept_stream));
+    lept_context_init(&s->c, NULL, 0);
+    s->c.sax = &lept_dom_handler;
+    s->c.user = &s->c;
+    s->pending = NULL;
+    s->pending_size = 0;
+    lept_stream_reset(s);
+    return s;
+}
+
+void lept_stream_free(lept_stream* s) {
+    if(s == NULL) {
+        return ;
+    }
+    lept_stream_reset(s);
+    lept_context_free(&s->c);
+    free(s->c.levels);
+    free(s->pending);
+    free(s);
+}
+
+static void lept_stream_pend(lept_stream* s, const char* p, size_t len) {
+    if(s->pending_len + len > s->pending_size) {
+        s->pending_size = s->pending_size > 0 ? s->pending_size : LEPT_PARSE_STACK_INIT_SIZE;
+        while(s->pending_len + len > s->pending_size) {
+            s->pending_size += s->pending_size >> 1;
+        }
+        s->pending = (char*)realloc(s->pending, s->pending_size);
+    }
+    memcpy(s->pending + s->pending_len, p, len);
+    s->pending_len += len;
+}
+
+/* a value is complete, in whichever container is open */
+static void lept_stream_value_done(lept_stream* s) {
+    if(s->c.depth > 0) {
+        s->c.levels[s->c.depth - 1].size ++;
+    }
+    s->state = LEPT_STREAM_NEXT;
+}
+
+static int lept_stream_open(lept_stream* s, char kind) {
+    lept_context* c = &s->c;
+    int ret;
+
+    if((ret = lept_context_open(c, kind)) != LEPT_PARSE_OK) {
+        return ret;
+    }
+    if(kind == '[') {
+        LEPT_SAX_CALL(c, start_array, (c->user));
+    } else {
+        LEPT_SAX_CALL(c, start_object, (c->user));
+    }
+    s->state = (kind == '[') ? LEPT_STREAM_ARRAY_FIRST : LEPT_STREAM_OBJECT_FIRST;
+    return LEPT_PARSE_OK;
+}
+
+static int lept_stream_close(lept_stream* s) {
+    lept_context* c = &s->c;
+    lept_level* l = &c->levels[-- c->depth];
+
+    if(l->kind == '[') {
+        LEPT_SAX_CALL(c, end_array, (c->user, l->size));
+    } else {
+        LEPT_SAX_CALL(c, end_object, (c->user, l->size));
+    }
+    lept_stream_value_done(s);
+    return LEPT_PARSE_OK;
+}
+
+/* one byte outside any token, which is not whitespace */
+static int lept_stream_char(lept_stream* s, char ch) {
+    char kind = (s->c.depth > 0) ? s->c.levels[s->c.depth - 1].kind : '\0';
+
+    switch(s->state) {
+        case LEPT_STREAM_ARRAY_FIRST:
+            if(ch == ']') {
+                return lept_stream_close(s);
+            }
+            /* fall through */
+        case LEPT_STREAM_VALUE:
+            if(ch == '[' || ch == '{') {
+                return lept_stream_open(s, ch);
+            }
+            if(ch == '\"') {
+                s->token = LEPT_TOKEN_STRING;
+                return LEPT_PARSE_OK;
+            }
+            if(LEPT_ISDELIM(ch)) {
+                return LEPT_PARSE_INVALID_VALUE;
+            }
+            s->token = LEPT_TOKEN_SCALAR;
+            return LEPT_PARSE_OK;
+        case LEPT_STREAM_OBJECT_FIRST:
+            if(ch == '}') {
+                return lept_stream_close(s);
+            }
+            /* fall through */
+        case LEPT_STREAM_KEY:
+            if(ch != '\"') {
+                return LEPT_PARSE_MISS_KEY;
+            }
+            s->token = LEPT_TOKEN_KEY;
+            return LEPT_PARSE_OK;
+        case LEPT_STREAM_COLON:
+            if(ch != ':') {
+                return LEPT_PARSE_MISS_COLON;
+            }
+            s->state = LEPT_STREAM_VALUE;
+            return LEPT_PARSE_OK;
+        case LEPT_STREAM_NEXT:
+            if(kind == '\0') {
+                return LEPT_PARSE_ROOT_NOT_SINGULAR;
+            }
+            if(ch == ',') {
+                s->state = (kind == '[') ? LEPT_STREAM_VALUE : LEPT_STREAM_KEY;
+                return LEPT_PARSE_OK;
+            }
+            if(ch == ((kind == '[') ? ']' : '}')) {
+                return lept_stream_close(s);
+            }
+            return (kind == '[') ? LEPT_PARSE_INVALID_VALUE : LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET;
+    }
+    assert(0);
+    return LEPT_PARSE_INVALID_VALUE;
+}
+
+/* the whole token is [p, end) */
+static int lept_stream_token_done(lept_stream* s, const char* p, const char* end) {
+    lept_context* c = &s->c;
+    lept_stream_token token = s->token;
+    int ret;
+
+    c->json = p;
+    c->end = end;
+    s->token = LEPT_TOKEN_NONE;
+    s->pending_len = 0;
+
+    if(token == LEPT_TOKEN_KEY) {
+        char* k;
+        size_t len;
+        if((ret = lept_parse_string_raw(c, &k, &len)) != LEPT_PARSE_OK) {
+            return ret;
+        }
+        LEPT_SAX_CALL(c, key, (c->user, k, len));
+        s->state = LEPT_STREAM_COLON;
+        return LEPT_PARSE_OK;
+    }
+
+    if((ret = lept_parse_value(c)) != LEPT_PARSE_OK) {
+        return ret;
+    }
+    lept_stream_value_done(s);
+    /* "1x", "truex": the rest of the run is what follows the value */
+    return (c->json != end) ? lept_stream_char(s, *c->json) : LEPT_PARSE_OK;
+}
+
+/* the end of the token starting at or continuing from p, or NULL if it goes on past end */
+static const char* lept_stream_token_end(lept_stream* s, const char* p, const char* end) {
+    if(s->token == LEPT_TOKEN_SCALAR) {
+        while(p < end && !LEPT_ISDELIM(*p)) {
+            p++;
+        }
+        return (p < end) ? p : NULL;
+    }
+
+    if(s->escaped) {
+        if(p == end) {
+            return NULL;
+        }
+        p++;
+        s->escaped = 0;
+    }
+    for(;;) {
+        /* a control character stops the scan but not the token, the parser reports it */
+        p = lept_scan_string(p, end);
+        if(p == end) {
+            return NULL;
+        }
+        if(*p == '\"') {
+            return p + 1;
+        }
+        if(*p++ == '\\') {
+            if(p == end) {
+                s->escaped = 1;
+                return NULL;
+            }
+            p++;
+        }
+    }
+}
+
+int lept_stream_feed(lept_stream* s, const char* chunk, size_t len) {
+    const char* p = chunk;
+    const char* end = chunk + len;
+
+    assert(s != NULL && (chunk != NULL || len == 0));
+
+    while(s->ret == LEPT_PARSE_OK && p < end) {
+        if(s->token != LEPT_TOKEN_NONE) {
+            /* a string resumes after its opening quote, a scalar at its first byte */
+            const char* start = (s->pending_len > 0) ? p : p - (s->token != LEPT_TOKEN_SCALAR);
+            const char* q = lept_stream_token_end(s, p, end);
+            if(q == NULL) {
+                lept_stream_pend(s, start, end - start);
+                break;
+            }
+            if(s->pending_len > 0) {
+                lept_stream_pend(s, start, q - start);
+                s->ret = lept_stream_token_done(s, s->pending, s->pending + s->pending_len);
+            } else {
+                s->ret = lept_stream_token_done(s, start, q);
+            }
+            p = q;
+            continue;
+        }
+
+        if(LEPT_ISWS(*p)) {
+            p = lept_skip_whitespace(p + 1, end);
+        }
+        if(p < end) {
+            const char* start = p;
+            s->ret = lept_stream_char(s, *p);
+            if(s->token == LEPT_TOKEN_SCALAR) {
+                continue; /* the first byte belongs to the token */
+            }
+            p++;
+            if(s->token != LEPT_TOKEN_NONE && p == end) {
+                /* the opening quote alone */
+                lept_stream_pend(s, start, 1);
+            }
+        }
+    }
+
+    return s->ret;
+}
+
+int lept_stream_finish(lept_stream* s, lept_value* v) {
+    int ret;
+
+    assert(s != NULL && v != NULL);
+
+    lept_init(v);
+    if(s->ret == LEPT_PARSE_OK && s->token != LEPT_TOKEN_NONE) {
+        /* the input ends inside a token */
+        s->ret = lept_stream_token_done(s, s->pending, s->pending + s->pending_len);
+    }
+    if(s->ret == LEPT_PARSE_OK) {
+        char kind = (s->c.depth > 0) ? s->c.levels[s->c.depth - 1].kind : '\0';
+        switch(s->state) {
+            case LEPT_STREAM_VALUE:
+            case LEPT_STREAM_ARRAY_FIRST:  s->ret = LEPT_PARSE_EXPECT_VALUE; break;
+            case LEPT_STREAM_OBJECT_FIRST:
+            case LEPT_STREAM_KEY:          s->ret = LEPT_PARSE_MISS_KEY; break;
+            case LEPT_STREAM_COLON:        s->ret = LEPT_PARSE_MISS_COLON; break;
+            case LEPT_STREAM_NEXT:
+                if(kind == '[') {
+                    s->ret = LEPT_PARSE_INVALID_VALUE;
+                } else if(kind == '{') {
+                    s->ret = LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET;
+                }
+                break;
+        }
+    }
+    if(s->ret == LEPT_PARSE_OK) {
+        *v = LEPT_CONTEXT_POP(&s->c, lept_value);
+    }
+
+    ret = s->ret;
+    lept_stream_reset(s);
+    return ret;
+}
+
+lept_type lept_get_type(const lept_value* v) {
+    assert(v != NULL);
+    return (lept_type)v->type;
+}
+
+/* init && free */
+
+void lept_init(lept_value* v) {
+    memset(v, 0, sizeof(lept_value));
+    v->type = LEPT_NULL;
+}
+
+void lept_free(lept_value* v) {
+    assert(v != NULL);
+    if(v->type == LEPT_STRING) {
+        if(!(v->flags & (LEPT_BORROWED | LEPT_INLINE))) {
+            free(v->s);
+        }
+    } else if(v->type == LEPT_ARRAY) {
+        for(size_t i = 0; i < v->size; i ++) {
+            lept_free(&v->e[i]);
+        }
+        if(!(v->flags & LEPT_BORROWED)) {
+            free(v->e);
+        }
+    } else if(v->type == LEPT_OBJECT) {
+        for(size_t i = 0; i < v->size; i ++) {
+            lept_free(&v->m[i].k);
+            lept_free(&v->m[i].v);
+        }
+        if(!(v->flags & LEPT_BORROWED)) {
+            free(v->m);
+        }
+    }
+    /* to avoid double free */
+    lept_init(v);
+}
+
+/* string */
+
+const char* lept_get_string(const lept_value* v) {
     assert(v != NULL && v->type == LEPT_STRING);
-    return v->string.len;
+    return LEPT_STRING_PTR(v);
+}
+
+size_t lept_get_string_length(const lept_value* v) {
+    assert(v != NULL && v->type == LEPT_STRING);
+    return LEPT_STRING_LEN(v);
+}
+
+void lept_set_string(lept_value* v, const char* s, size_t len) {
+    assert(v != NULL && (s != NULL || len != 0) && len <= UINT32_MAX);
+    lept_free(v);
+    if(lept_string_inline(v, s, len)) {
+        return ;
+    }
+    v->s = (char*)malloc((len + 1) * sizeof(char));
+    memcpy(v->s, s, len);
+    v->s[len] = '\0';
+    v->size = (uint32_t)len;
+    v->type = LEPT_STRING;
+}
+
+/* boolean */
+
+int lept_get_boolean(const lept_value* v) {
+    assert(v != NULL && (v->type == LEPT_TRUE || v->type == LEPT_FALSE));
+    return v->type == LEPT_TRUE;
+}
+
+void lept_set_boolean(lept_value* v, int b) {
+    lept_free(v);
+    v->type = (b == 0) ? LEPT_FALSE : LEPT_TRUE;
+}
+
+/* number */
+
+double lept_get_number(const lept_value* v) {
+    assert(v != NULL && v->type == LEPT_NUMBER);
+    return v->n;
+}
+
+void lept_set_number(lept_value* v, double d) {
+    lept_free(v);
+    v->n = d;
+    v->type = LEPT_NUMBER;
+}
+
+/* array */
+
+size_t lept_get_array_size(const lept_value* v) {
+    assert(v != NULL && v->type == LEPT_ARRAY);
+    return v->size;
+}
+
+lept_value* lept_get_array_element(const lept_value* v, size_t index) {
+    assert(v != NULL && v->type == LEPT_ARRAY);
+    assert(index < v->size);
+    return &(v->e[index]);
+}
+
+/* building
+ *
+ * The capacity of a grown array or object is a power of two, kept as its
+ * exponent + 1 in lept_value.cap; 0 means it is the size, as after parsing.
+ * Growing moves a borrowed (arena) block to the heap together with copies
+ * of the borrowed strings and blocks in it, so a grown container owns all
+ * it holds and outlives the arena; later blocks are realloc()ed. An object
+ * block also holds the hash table of its capacity.
+ */
+
+/* the block for capacity elements, or members and their table */
+static size_t lept_container_bytes(const lept_value* v, size_t capacity) {
+    return (v->type == LEPT_ARRAY) ? capacity * sizeof(lept_value) :
+        capacity * sizeof(lept_member) + lept_object_slots(capacity) * sizeof(uint32_t);
+}
+
+/* v, if borrowed, and all it holds copied to the heap */
+static void lept_own(lept_value* v) {
+    if(v->type == LEPT_STRING) {
+        if((v->flags & LEPT_BORROWED) && !(v->flags & LEPT_INLINE)) {
+            char* s = (char*)malloc((size_t)v->size + 1);
+            memcpy(s, v->s, v->size);
+            s[v->size] = '\0';
+            v->s = s;
+            v->flags &= ~LEPT_BORROWED;
+        }
+        return ;
+    }
+    if(v->type != LEPT_ARRAY && v->type != LEPT_OBJECT) {
+        return ;
+    }
+    if((v->flags & LEPT_BORROWED) && LEPT_CAPACITY(v) > 0) {
+        size_t bytes = lept_container_bytes(v, LEPT_CAPACITY(v));
+        void* p = malloc(bytes);
+        memcpy(p, v->e, bytes);
+        v->e = (lept_value*)p;
+    }
+    v->flags &= ~LEPT_BORROWED;
+    for(size_t i = 0; i < v->size; i ++) {
+        if(v->type == LEPT_ARRAY) {
+            lept_own(&v->e[i]);
+        } else {
+            lept_own(&v->m[i].k);
+            lept_own(&v->m[i].v);
+        }
+    }
+}
+
+static void lept_container_resize(lept_value* v, size_t capacity, unsigned char cap) {
+    size_t bytes = lept_container_bytes(v, capacity);
+    void* p;
+
+    if(v->flags & LEPT_BORROWED) {
+        p = malloc(bytes);
+        memcpy(p, v->e, v->size * (v->type == LEPT_ARRAY ? sizeof(lept_value) : sizeof(lept_member)));
+        v->flags &= ~LEPT_BORROWED;
+        for(size_t i = 0; i < v->size; i ++) {
+            if(v->type == LEPT_ARRAY) {
+                lept_own(&((lept_value*)p)[i]);
+            } else {
+                lept_own(&((lept_member*)p)[i].k);
+                lept_own(&((lept_member*)p)[i].v);
+            }
+        }
+    } else {
+        p = realloc(v->e, bytes);
+    }
+    v->e = (lept_value*)p;
+    v->cap = cap;
+    if(v->type == LEPT_OBJECT) {
+        lept_object_index(v);
+    }
+}
+
+static void lept_container_reserve(lept_value* v, size_t capacity) {
+    unsigned char cap = 1;
+
+    assert(capacity <= UINT32_MAX);
+    if(capacity <= LEPT_CAPACITY(v)) {
+        return ;
+    }
+    while(((size_t)1 << (cap - 1)) < capacity) {
+        cap ++;
+    }
+    lept_container_resize(v, (size_t)1 << (cap - 1), cap);
+}
+
+static void lept_container_shrink(lept_value* v) {
+    if(v->cap == 0 || (v->flags & LEPT_BORROWED)) {
+        return ; /* already exact */
+    }
+    if(v->size == 0) {
+        free(v->e);
+        v->e = NULL;
+        v->cap = 0;
+        return ;
+    }
+    lept_container_resize(v, v->size, 0);
+}
+
+/* emptied, a parsed block keeps the room of a power of two it has */
+static void lept_container_clear(lept_value* v) {
+    if(v->cap == 0 && v->size > 0) {
+        unsigned char cap = 1;
+        while(((size_t)1 << cap) <= v->size) {
+            cap ++;
+        }
+        v->cap = cap;
+    }
+    v->size = 0;
+    if(v->type == LEPT_OBJECT) {
+        lept_object_index(v);
+    }
+}
+
+void lept_set_array(lept_value* v, size_t capacity) {
+    assert(v != NULL);
+    lept_free(v);
+    v->type = LEPT_ARRAY;
+    lept_container_reserve(v, capacity);
+}
+
+size_t lept_get_array_capacity(const lept_value* v) {
+    assert(v != NULL && v->type == LEPT_ARRAY);
+    return LEPT_CAPACITY(v);
+}
+
+void lept_reserve_array(lept_value* v, size_t capacity) {
+    assert(v != NULL && v->type == LEPT_ARRAY);
+    lept_container_reserve(v, capacity);
+}
+
+void lept_shrink_array(lept_value* v) {
+    assert(v != NULL && v->type == LEPT_ARRAY);
+    lept_container_shrink(v);
+}
+
+void lept_clear_array(lept_value* v) {
+    assert(v != NULL && v->type == LEPT_ARRAY);
+    for(size_t i = 0; i < v->size; i ++) {
+        lept_free(&v->e[i]);
+    }
+    lept_container_clear(v);
+}
+
+lept_value* lept_pushback_array_element(lept_value* v) {
+    assert(v != NULL && v->type == LEPT_ARRAY);
+    lept_container_reserve(v, (size_t)v->size + 1);
+    lept_init(&v->e[v->size]);
+    return &v->e[v->size ++];
+}
+
+void lept_popback_array_element(lept_value* v) {
+    assert(v != NULL && v->type == LEPT_ARRAY && v->size > 0);
+    lept_free(&v->e[-- v->size]);
+}
+
+lept_value* lept_insert_array_element(lept_value* v, size_t index) {
+    assert(v != NULL && v->type == LEPT_ARRAY && index <= v->size);
+    lept_container_reserve(v, (size_t)v->size + 1);
+    memmove(&v->e[index + 1], &v->e[index], (v->size - index) * sizeof(lept_value));
+    v->size ++;
+    lept_init(&v->e[index]);
+    return &v->e[index];
+}
+
+void lept_erase_array_element(lept_value* v, size_t index, size_t count) {
+    assert(v != NULL && v->type == LEPT_ARRAY && index + count <= v->size);
+    for(size_t i = index; i < index + count; i ++) {
+        lept_free(&v->e[i]);
+    }
+    memmove(&v->e[index], &v->e[index + count], (v->size - index - count) * sizeof(lept_value));
+    v->size -= (uint32_t)count;
+}
+
+/* object */
+
+size_t lept_get_object_size(const lept_value* v) {
+    assert(v != NULL && v->type == LEPT_OBJECT);
+    return v->size;
+}
+
+const char* lept_get_object_key(const lept_value* v, size_t index) {
+    assert(v != NULL && v->type == LEPT_OBJECT);
+    assert(index < v->size);
+    return LEPT_STRING_PTR(&v->m[index].k);
+}
+
+size_t lept_get_object_key_length(const lept_value* v, size_t index) {
+    assert(v != NULL && v->type == LEPT_OBJECT);
+    assert(index < v->size);
+    return LEPT_STRING_LEN(&v->m[index].k);
+}
+
+lept_value* lept_get_object_value(const lept_value* v, size_t index) {
+    assert(v != NULL && v->type == LEPT_OBJECT);
+    assert(index < v->size);
+    return &v->m[index].v;
+}
+
+/* an interned key is found by address, without looking at the bytes */
+#define LEPT_KEY_EQ(k, key, klen) (LEPT_STRING_LEN(k) == (klen) && \
+    (LEPT_STRING_PTR(k) == (key) || memcmp(LEPT_STRING_PTR(k), (key), (klen)) == 0))
+
+/* hash is lept_hash_key() of key, which a compiled query has at hand */
+static size_t lept_object_find(const lept_value* v, const char* key, size_t klen, uint32_t hash) {
+    if(v->size < LEPT_OBJECT_HASH_MIN) {
+        for(size_t i = 0; i < v->size; i ++) {
+            const lept_value* k = &v->m[i].k;
+            if(LEPT_KEY_EQ(k, key, klen)) {
+                return i;
+            }
+        }
+        return LEPT_KEY_NOT_EXIST;
+    }
+
+    size_t mask = lept_object_slots(LEPT_CAPACITY(v)) - 1;
+    const uint32_t* slots = LEPT_OBJECT_SLOTS(v);
+    for(size_t j = hash & mask; slots[j] != 0; j = (j + 1) & mask) {
+        const lept_value* k = &v->m[slots[j] - 1].k;
+        if(LEPT_KEY_EQ(k, key, klen)) {
+            return slots[j] - 1;
+        }
+    }
+    return LEPT_KEY_NOT_EXIST;
+}
+
+size_t lept_find_object_index(const lept_value* v, const char* key, size_t klen) {
+    assert(v != NULL && v->type == LEPT_OBJECT && (key != NULL || klen == 0));
+    return lept_object_find(v, key, klen, (v->size < LEPT_OBJECT_HASH_MIN) ? 0 : lept_hash_key(key, klen));
+}
+
+lept_value* lept_find_object_value(const lept_value* v, const char* key, size_t klen) {
+    size_t index = lept_find_object_index(v, key, klen);
+    return (index != LEPT_KEY_NOT_EXIST) ? &v->m[index].v : NULL;
+}
+
+void lept_set_object(lept_value* v, size_t capacity) {
+    assert(v != NULL);
+    lept_free(v);
+    v->type = LEPT_OBJECT;
+    lept_container_reserve(v, capacity);
+}
+
+size_t lept_get_object_capacity(const lept_value* v) {
+    assert(v != NULL && v->type == LEPT_OBJECT);
+    return LEPT_CAPACITY(v);
+}
+
+void lept_reserve_object(lept_value* v, size_t capacity) {
+    assert(v != NULL && v->type == LEPT_OBJECT);
+    lept_container_reserve(v, capacity);
+}
+
+void lept_shrink_object(lept_value* v) {
+    assert(v != NULL && v->type == LEPT_OBJECT);
+    lept_container_shrink(v);
+}
+
+void lept_clear_object(lept_value* v) {
+    assert(v != NULL && v->type == LEPT_OBJECT);
+    for(size_t i = 0; i < v->size; i ++) {
+        lept_free(&v->m[i].k);
+        lept_free(&v->m[i].v);
+    }
+    lept_container_clear(v);
+}
+
+lept_value* lept_set_object_value(lept_value* v, const char* key, size_t klen) {
+    size_t index = lept_find_object_index(v, key, klen);
+    lept_member* m;
+
+    if(index != LEPT_KEY_NOT_EXIST) {
+        return &v->m[index].v;
+    }
+    lept_container_reserve(v, (size_t)v->size + 1);
+    index = v->size ++;
+    m = &v->m[index];
+    lept_init(&m->k);
+    lept_set_string(&m->k, key, klen);
+    lept_init(&m->v);
+
+    /* the table takes the new key, which keeps appending O(1) */
+    if(lept_object_slots(LEPT_CAPACITY(v)) > 0) {
+        lept_object_slot(LEPT_OBJECT_SLOTS(v), lept_object_slots(LEPT_CAPACITY(v)) - 1, key, klen, index);
+    }
+    return &m->v;
+}
+
+void lept_remove_object_value(lept_value* v, size_t index) {
+    assert(v != NULL && v->type == LEPT_OBJECT && index < v->size);
+    lept_free(&v->m[index].k);
+    lept_free(&v->m[index].v);
+    memmove(&v->m[index], &v->m[index + 1], (v->size - index - 1) * sizeof(lept_member));
+    v->size --;
+    lept_object_index(v);
+}
+
+/* stringify number
+ *
+ * Ryu (Adams, "Ryu: Fast Float-to-String Conversion") finds the shortest
+ * digit string that parses back to the same double, picking the closest
+ * one when several have that length. Whole numbers below 2^53 skip it and
+ * are printed as integers. The layout follows %.17g: plain notation for
+ * decimal exponents in [-4, 17), 'e' notation otherwise.
+ */
+
+/* floor(2^j / 5^q) + 1 with j = bitlength(5^q) - 1 + 125, as { low, high } */
+static const uint64_t lept_ryu_pow5_inv[][2] = {
+    { 0x0000000000000001ULL, 0x2000000000000000ULL },
+    { 0x999999999999999AULL, 0x1999999999999999ULL },
+    { 0x47AE147AE147AE15ULL, 0x147AE147AE147AE1ULL },
+    { 0x6C8B4395810624DEULL, 0x10624DD2F1A9FBE7ULL },
+    { 0x7A786C226809D496ULL, 0x1A36E2EB1C432CA5ULL },
+    { 0x61F9F01B866E43ABULL, 0x14F8B588E368F084ULL },
+    { 0xB4C7F34938583622ULL, 0x10C6F7A0B5ED8D36ULL },
+    { 0x87A6520EC08D236AULL, 0x1AD7F29ABCAF4857ULL },
+    { 0x9FB841A566D74F88ULL, 0x15798EE2308C39DFULL },
+    { 0xE62D01511F12A607ULL, 0x112E0BE826D694B2ULL },
+    { 0xD6AE6881CB5109A4ULL, 0x1B7CDFD9D7BDBAB7ULL },
+    { 0xDEF1ED34A2A73AEAULL, 0x15FD7FE17964955FULL },
+    { 0x7F27F0F6E885C8BBULL, 0x119799812DEA1119ULL },
+    { 0x650CB4BE40D60DF8ULL, 0x1C25C268497681C2ULL },
+    { 0xEA70909833DE7193ULL, 0x16849B86A12B9B01ULL },
+    { 0x21F3A6E0297EC143ULL, 0x1203AF9EE756159BULL },
+    { 0x6985D7CD0F313537ULL, 0x1CD2B297D889BC2BULL },
+    { 0x2137DFD73F5A90F9ULL, 0x170EF54646D49689ULL },
+    { 0xE75FE645CC4873FAULL, 0x12725DD1D243ABA0ULL },
+    { 0xA5663D3C7A0D865DULL, 0x1D83C94FB6D2AC34ULL },
+    { 0x511E976394D79EB1ULL, 0x179CA10C9242235DULL },
+    { 0xDA7EDF82DD794BC1ULL, 0x12E3B40A0E9B4F7DULL },
+    { 0x2A6498D1625BAC68ULL, 0x1E392010175EE596ULL },
+    { 0xEEB6E0A781E2F053ULL, 0x182DB34012B25144ULL },
+    { 0x58924D52CE4F26A9ULL, 0x1357C299A88EA76AULL },
+    { 0x27507BB7B07EA441ULL, 0x1EF2D0F5DA7DD8AAULL },
+    { 0x52A6C95FC0655034ULL, 0x18C240C4AECB13BBULL },
+    { 0x0EEBD44C99EAA690ULL, 0x13CE9A36F23C0FC9ULL },
+    { 0xB17953ADC3110A80ULL, 0x1FB0F6BE50601941ULL },
+    { 0xC12DDC8B02740867ULL, 0x195A5EFEA6B34767ULL },
+    { 0x3424B06F3529A052ULL, 0x14484BFEEBC29F86ULL },
+    { 0x901D59F290EE19DBULL, 0x1039D66589687F9EULL },
+    { 0x4CFBC31DB4B0295FULL, 0x19F623D5A8A73297ULL },
+    { 0x3D9635B15D59BAB2ULL, 0x14C4E977BA1F5BACULL },
+    { 0x97AB5E277DE16228ULL, 0x109D8792FB4C4956ULL },
+    { 0xF2ABC9D8C9689D0DULL, 0x1A95A5B7F87A0EF0ULL },
+    { 0x5BBCA17A3ABA173EULL, 0x154484932D2E725AULL },
+    { 0xAFCA1AC82EFB45CBULL, 0x11039D428A8B8EAEULL },
+    { 0xB2DCF7A6B1920945ULL, 0x1B38FB9DAA78E44AULL },
+    { 0xF57D92EBC141A104ULL, 0x15C72FB1552D836EULL },
+    { 0xC46475896767B403ULL, 0x116C262777579C58ULL },
+    { 0x6D6D88DBD8A5ECD2ULL, 0x1BE03D0BF225C6F4ULL },
+    { 0x8ABE071646EB23DBULL, 0x164CFDA3281E38C3ULL },
+    { 0x6EFE6C11D255B649ULL, 0x11D7314F534B609CULL },
+    { 0xB197134FB6EF8A0EULL, 0x1C8B821885456760ULL },
+    { 0x27AC0F72F8BFA1A5ULL, 0x16D601AD376AB91AULL },
+    { 0xB95672C260994E1EULL, 0x1244CE242C5560E1ULL },
+    { 0xF5571E03CDC21695ULL, 0x1D3AE36D13BBCE35ULL },
+    { 0x2AAC18030B01ABABULL, 0x17624F8A762FD82BULL },
+    { 0xBBBCE0026F348956ULL, 0x12B50C6EC4F31355ULL },
+    { 0x92C7CCD0B1EDA889ULL, 0x1DEE7A4AD4B81EEFULL },
+    { 0xDBD30A408E57BA07ULL, 0x17F1FB6F10934BF2ULL },
+    { 0x7CA8D50071DFC806ULL, 0x1327FC58DA0F6FF5ULL },
+    { 0xFAA7BB33E9660CD6ULL, 0x1EA6608E29B24CBBULL },
+    { 0x9552FC298784D711ULL, 0x18851A0B548EA3C9ULL },
+    { 0xAAA8C9BAD2D0AC0EULL, 0x139DAE6F76D88307ULL },
+    { 0xDDDADC5E1E1AACE3ULL, 0x1F62B0B257C0D1A5ULL },
+    { 0x7E48B04B4B488A4FULL, 0x191BC08EAC9A4151ULL },
+    { 0xCB6D59D5D5D3A1D9ULL, 0x141633A556E1CDDAULL },
+    { 0x3C577B1177DC817BULL, 0x1011C2EAABE7D7E2ULL },
+    { 0xC6F25E825960CF2AULL, 0x19B604AAACA62636ULL },
+    { 0x6BF518684780A5BBULL, 0x14919D5556EB51C5ULL },
+    { 0x232A79ED06008496ULL, 0x10747DDDDF22A7D1ULL },
+    { 0xD1DD8FE1A3340756ULL, 0x1A53FC9631D10C81ULL },
+    { 0xA7E4731AE8F66C45ULL, 0x150FFD44F4A73D34ULL },
+    { 0x531D28E253F8569EULL, 0x10D9976A5D52975DULL },
+    { 0xEB61DB03B98D5762ULL, 0x1AF5BF109550F22EULL },
+    { 0xBC4E48CFC7A445E8ULL, 0x159165A6DDDA5B58ULL },
+    { 0x6371D3D96C836B20ULL, 0x11411E1F17E1E2ADULL },
+    { 0x9F1C8628AD9F11CDULL, 0x1B9B6364F3030448ULL },
+    { 0xE5B06B53BE18DB0BULL, 0x1615E91D8F359D06ULL },
+    { 0xEAF3890FCB4715A2ULL, 0x11AB20E472914A6BULL },
+    { 0x44B8DB4C7871BC37ULL, 0x1C45016D841BAA46ULL },
+    { 0x03C715D6C6C1635FULL, 0x169D9ABE03495505ULL },
+    { 0x3638DE456BCDE919ULL, 0x1217AEFE69077737ULL },
+    { 0x56C163A2461641C1ULL, 0x1CF2B1970E725858ULL },
+    { 0xDF011C81D1AB67CEULL, 0x17288E1271F51379ULL },
+    { 0x7F3416CE4155ECA5ULL, 0x1286D80EC190DC61ULL },
+    { 0x6520247D3556476EULL, 0x1DA48CE468E7C702ULL },
+    { 0xEA801D30F7783925ULL, 0x17B6D71D20B96C01ULL },
+    { 0xBB99B0F3F92CFA84ULL, 0x12F8AC174D612334ULL },
+    { 0x5F5C4E532847F739ULL, 0x1E5AACF215683854ULL },
+    { 0x7F7D0B75B9D32C2EULL, 0x18488A5B44536043ULL },
+    { 0x9930D5F7C7DC2358ULL, 0x136D3B7C36A919CFULL },
+    { 0x8EB4898C72F9D226ULL, 0x1F152BF9F10E8FB2ULL },
+    { 0x722A07A38F2E41B8ULL, 0x18DDBCC7F40BA628ULL },
+    { 0xC1BB394FA5BE9AFAULL, 0x13E497065CD61E86ULL },
+    { 0x9C5EC2190930F7F6ULL, 0x1FD424D6FAF030D7ULL },
+    { 0x49E56814075A5FF8ULL, 0x197683DF2F268D79ULL },
+    { 0x6E51201005E1E660ULL, 0x145ECFE5BF520AC7ULL },
+    { 0xF1DA800CD181851AULL, 0x104BD984990E6F05ULL },
+    { 0x4FC400148268D4F5ULL, 0x1A12F5A0F4E3E4D6ULL },
+    { 0xD96999AA01ED772BULL, 0x14DBF7B3F71CB711ULL },
+    { 0xADEE1488018AC5BCULL, 0x10AFF95CC5B09274ULL },
+    { 0x497CEDA668DE092CULL, 0x1AB328946F80EA54ULL },
+    { 0x3ACA57B853E4D424ULL, 0x155C2076BF9A5510ULL },
+    { 0x623B7960431D7683ULL, 0x1116805EFFAEAA73ULL },
+    { 0x9D2BF566D1C8BD9EULL, 0x1B5733CB32B110B8ULL },
+    { 0x7DBCC452416D647FULL, 0x15DF5CA28EF40D60ULL },
+    { 0xCAFD69DB678AB6CCULL, 0x117F7D4ED8C33DE6ULL },
+    { 0xAB2F0FC572778ADFULL, 0x1BFF2EE48E052FD7ULL },
+    { 0x88F273045B92D580ULL, 0x1665BF1D3E6A8CACULL },
+    { 0xD3F528D049424466ULL, 0x11EAFF4A98553D56ULL },
+    { 0xB988414D4203A0A3ULL, 0x1CAB3210F3BB9557ULL },
+    { 0x6139CDD76802E6E9ULL, 0x16EF5B40C2FC7779ULL },
+    { 0xE761717920025254ULL, 0x125915CD68C9F92DULL },
+    { 0xA568B58E999D5086ULL, 0x1D5B561574765B7CULL },
+    { 0x5120913EE14AA6D2ULL, 0x177C44DDF6C515FDULL },
+    { 0xA74D40FF1AA21F0EULL, 0x12C9D0B1923744CAULL },
+    { 0x0BAECE64F769CB4AULL, 0x1E0FB44F50586E11ULL },
+    { 0x3C8BD850C5EE3C3BULL, 0x180C903F7379F1A7ULL },
+    { 0xCA0979DA37F1C9C9ULL, 0x133D4032C2C7F485ULL },
+    { 0xA9A8C2F6BFE942DBULL, 0x1EC866B79E0CBA6FULL },
+    { 0x2153CF2BCCBA9BE3ULL, 0x18A0522C7E709526ULL },
+    { 0x1AA9728970954982ULL, 0x13B374F06526DDB8ULL },
+    { 0xF775840F1A88759DULL, 0x1F8587E7083E2F8CULL },
+    { 0x5F9136727BA05E17ULL, 0x19379FEC0698260AULL },
+    { 0x1940F85B9619E4DFULL, 0x142C7FF0054684D5ULL },
+    { 0xE100C6AFAB47EA4CULL, 0x1023998CD1053710ULL },
+    { 0xCE67A44C453FDD47ULL, 0x19D28F47B4D524E7ULL },
+    { 0xD852E9D69DCCB106ULL, 0x14A8729FC3DDB71FULL },
+    { 0x79DBEE454B0A2738ULL, 0x1086C219697E2C19ULL },
+    { 0x295FE3A211A9D859ULL, 0x1A71368F0F30468FULL },
+    { 0xBAB31C81A7BB137AULL, 0x15275ED8D8F36BA5ULL },
+    { 0x6228E39AEC95A92FULL, 0x10EC4BE0AD8F8951ULL },
+    { 0x9D0E38F7E0EF7517ULL, 0x1B13AC9AAF4C0EE8ULL },
+    { 0xB0D82D931A592A79ULL, 0x15A956E225D67253ULL },
+    { 0x8D79BE0F4847552EULL, 0x11544581B7DEC1DCULL },
+    { 0x158F967EDA0BBB7CULL, 0x1BBA08CF8C979C94ULL },
+    { 0x77A611FF14D62F97ULL, 0x162E6D72D6DFB076ULL },
+    { 0xF951A7FF43DE8C79ULL, 0x11BEBDF578B2F391ULL },
+    { 0xC21C3FFED2FDAD8EULL, 0x1C6463225AB7EC1CULL },
+    { 0x01B0333242648AD8ULL, 0x16B6B5B5155FF017ULL },
+    { 0x0159C28E9B83A246ULL, 0x122BC490DDE659ACULL },
+    { 0xCEF604175F3903A3ULL, 0x1D12D41AFCA3C2ACULL },
+    { 0x725E69AC4C2D9C83ULL, 0x17424348CA1C9BBDULL },
+    { 0xF5185489D68AE39CULL, 0x129B69070816E2FDULL },
+    { 0xEE8D540FBDAB05C6ULL, 0x1DC574D80CF16B2FULL },
+    { 0xBED77672FE226B05ULL, 0x17D12A4670C1228CULL },
+    { 0xFF12C528CB4EBC04ULL, 0x130DBB6B8D674ED6ULL },
+    { 0xCB513B74787DF9A0ULL, 0x1E7C5F127BD87E24ULL },
+    { 0x090DC929F9FE614DULL, 0x18637F41FCAD31B7ULL },
+    { 0xA0D7D42194CB810AULL, 0x1382CC34CA2427C5ULL },
+    { 0x67BFB9CF5478CE77ULL, 0x1F37AD21436D0C6FULL },
+    { 0x1FCC94A5DD2D71F9ULL, 0x18F9574DCF8A7059ULL },
+    { 0x7FD6DD517DBDF4C7ULL, 0x13FAAC3E3FA1F37AULL },
+    { 0xFFBE2EE8C92FEE0BULL, 0x1FF779FD329CB8C3ULL },
+    { 0x6631BF20A0F324D6ULL, 0x1992C7FDC216FA36ULL },
+    { 0xB827CC1A1A5C1D78ULL, 0x14756CCB01ABFB5EULL },
+    { 0x935309AE7B7CE460ULL, 0x105DF0A267BCC918ULL },
+    { 0x1EEB42B0C594A099ULL, 0x1A2FE76A3F9474F4ULL },
+    { 0xE58902270476E6E1ULL, 0x14F31F8832DD2A5CULL },
+    { 0xB7A0CE859D2BEBE7ULL, 0x10C27FA028B0EEB0ULL },
+    { 0x59014A6F61DFDFD8ULL, 0x1AD0CC33744E4AB4ULL },
+    { 0xE0CDD525E7E64CADULL, 0x1573D68F903EA229ULL },
+    { 0x4D7177518651D6F1ULL, 0x11297872D9CBB4EEULL },
+    { 0x7BE8BEE8D6E957E8ULL, 0x1B758D848FAC54B0ULL },
+    { 0xFCBA3253DF211320ULL, 0x15F7A46A0C89DD59ULL },
+    { 0x63C8284318E74280ULL, 0x1192E9EE706E4AAEULL },
+    { 0x060D0D3827D86A66ULL, 0x1C1E43171A4A1117ULL },
+    { 0x6B3DA42CECAD21EBULL, 0x167E9C127B6E7412ULL },
+    { 0x88FE1CF0BD574E56ULL, 0x11FEE341FC585CDBULL },
+    { 0x419694B462254A23ULL, 0x1CCB0536608D615FULL },
+    { 0x67ABAA29E81DD4E9ULL, 0x1708D0F84D3DE77FULL },
+    { 0xB95621BB2017DD87ULL, 0x126D73F9D764B932ULL },
+    { 0xC223692B668C95A5ULL, 0x1D7BECC2F23AC1EAULL },
+    { 0xCE82BA891ED6DE1DULL, 0x179657025B6234BBULL },
+    { 0xA53562074BDF1818ULL, 0x12DEAC01E2B4F6FCULL },
+    { 0x3B889CD87964F359ULL, 0x1E3113363787F194ULL },
+    { 0xFC6D4A46C783F5E1ULL, 0x18274291C6065ADCULL },
+    { 0x30576E9F06032B1AULL, 0x13529BA7D19EAF17ULL },
+    { 0x1A257DCB3CD1DE90ULL, 0x1EEA92A61C311825ULL },
+    { 0x481DFE3C30A7E540ULL, 0x18BBA884E35A79B7ULL },
+    { 0xD34B31C9C0865100ULL, 0x13C9539D82AEC7C5ULL },
+    { 0x5211E942CDA3B4CDULL, 0x1FA885C8D117A609ULL },
+    { 0x74DB21023E1C90A4ULL, 0x19539E3A40DFB807ULL },
+    { 0xF715B401CB4A0D50ULL, 0x1442E4FB67196005ULL },
+    { 0xF8DE299B09080AA7ULL, 0x103583FC527AB337ULL },
+    { 0x8E304291A80CDDD7ULL, 0x19EF3993B72AB859ULL },
+    { 0x3E8D020E200A4B13ULL, 0x14BF6142F8EEF9E1ULL },
+    { 0x653D9B3E80083C0FULL, 0x10991A9BFA58C7E7ULL },
+    { 0x6EC8F864000D2CE4ULL, 0x1A8E90F9908E0CA5ULL },
+    { 0x8BD3F9E999A423EAULL, 0x153EDA614071A3B7ULL },
+    { 0x3CA994BAE1501CBBULL, 0x10FF151A99F482F9ULL },
+    { 0xC775BAC49BB3612BULL, 0x1B31BB5DC320D18EULL },
+    { 0xD2C4956A16291A89ULL, 0x15C162B168E70E0BULL },
+    { 0xDBD0778811BA7BA1ULL, 0x11678227871F3E6FULL },
+    { 0x2C80BF401C5D929BULL, 0x1BD8D03F3E9863E6ULL },
+    { 0xBD33CC3349E47549ULL, 0x16470CFF6546B651ULL },
+    { 0xCA8FD68F6E505DD4ULL, 0x11D270CC51055EA7ULL },
+    { 0x4419574BE3B3C953ULL, 0x1C83E7AD4E6EFDD9ULL },
+    { 0x0347790982F63AA9ULL, 0x16CFEC8AA52597E1ULL },
+    { 0xCF6C60D468C4FBBAULL, 0x123FF06EEA847980ULL },
+    { 0xE57A34870E07F92AULL, 0x1D331A4B10D3F59AULL },
+    { 0x512E906C0B399422ULL, 0x175C1508DA432AE2ULL },
+    { 0xDA8BA6BCD5C7A9B5ULL, 0x12B010D3E1CF5581ULL },
+    { 0x90DF712E22D90F87ULL, 0x1DE6815302E5559CULL },
+    { 0xDA4C5A8B4F140C6CULL, 0x17EB9AA8CF1DDE16ULL },
+    { 0xAEA37BA2A5A9A38AULL, 0x1322E220A5B17E78ULL },
+    { 0x7DD25F6AA2A905A9ULL, 0x1E9E369AA2B59727ULL },
+    { 0x97DB7F888220D154ULL, 0x187E92154EF7AC1FULL },
+    { 0x797C6606CE80A777ULL, 0x139874DDD8C6234CULL },
+    { 0x8F2D700AE4010BF1ULL, 0x1F5A549627A36BADULL },
+    { 0x0C2459A25000D65AULL, 0x191510781FB5EFBEULL },
+    { 0x701D1481D99A4515ULL, 0x1410D9F9B2F7F2FEULL },
+    { 0xC017439B147B6A77ULL, 0x100D7B2E28C65BFEULL },
+    { 0xCCF205C4ED9243F2ULL, 0x19AF2B7D0E0A2CCAULL },
+    { 0x0A5B37D0BE0E9CC2ULL, 0x148C22CA71A1BD6FULL },
+    { 0x0848F973CB3EE3CEULL, 0x10701BD527B4978CULL },
+    { 0xDA0E5BEC78649FB0ULL, 0x1A4CF9550C5425ACULL },
+    { 0x7B3EAFF060507FC0ULL, 0x150A6110D6A9B7BDULL },
+    { 0x95CBBFF380406633ULL, 0x10D51A73DEEE2C97ULL },
+    { 0xEFAC665266CD7052ULL, 0x1AEE90B964B04758ULL },
+    { 0x2623850EB8A459DBULL, 0x158BA6FAB6F36C47ULL },
+    { 0x1E82D0D893B6AE49ULL, 0x113C85955F29236CULL },
+    { 0xFD9E1AF41F8AB075ULL, 0x1B9408EEFEA838ACULL },
+    { 0x97B1AF29B2D559F7ULL, 0x16100725988693BDULL },
+    { 0xAC8E25BAF5777B2CULL, 0x11A66C1E139EDC97ULL },
+    { 0x7A7D092B2258C513ULL, 0x1C3D79C9B8FE2DBFULL },
+    { 0x61FDA0EF4EAD6A76ULL, 0x169794A160CB57CCULL },
+    { 0xE7FE1A590BBDEEC5ULL, 0x1212DD4DE7091309ULL },
+    { 0xA6635D5B45FCB13AULL, 0x1CEAFBAFD80E84DCULL },
+    { 0x851C4AAF6B308DC8ULL, 0x172262F3133ED0B0ULL },
+    { 0xD0E36EF2BC26D7D4ULL, 0x1281E8C275CBDA26ULL },
+    { 0xB49F17EAC6A48C86ULL, 0x1D9CA79D894629D7ULL },
+    { 0x2A18DFEF0550706BULL, 0x17B08617A104EE46ULL },
+    { 0x54E0B3259DD9F389ULL, 0x12F39E794D9D8B6BULL },
+    { 0x87CDEB6F62F65274ULL, 0x1E5297287C2F4578ULL },
+    { 0xD30B22BF825EA85DULL, 0x18421286C9BF6AC6ULL },
+    { 0x0F3C1BCC684BB9E4ULL, 0x13680ED23AFF889FULL },
+    { 0x18602C7A4079296DULL, 0x1F0CE4839198DA98ULL },
+    { 0x46B356C833942124ULL, 0x18D71D360E13E213ULL },
+    { 0x388F78A029434DB6ULL, 0x13DF4A91A4DCB4DCULL },
+    { 0x5A7F2766A86BAF8AULL, 0x1FCBAA82A1612160ULL },
+    { 0x153285EBB9EFBFA2ULL, 0x196FBB9BB44DB44DULL },
+    { 0xAA8ED189618C994EULL, 0x145962E2F6A4903DULL },
+    { 0xEED8A7A11AD6E10CULL, 0x1047824F2BB6D9CAULL },
+    { 0x7E27729B5E249B45ULL, 0x1A0C03B1DF8AF611ULL },
+    { 0xFE85F549181D4904ULL, 0x14D6695B193BF80DULL },
+    { 0xCB9E5DD4134AA0D0ULL, 0x10AB877C142FF9A4ULL },
+    { 0xDF63C9535211014DULL, 0x1AAC0BF9B9E65C3AULL },
+    { 0x191CA10F74DA6771ULL, 0x15566FFAFB1EB02FULL },
+    { 0xADB080D92A4852C1ULL, 0x1111F32F2F4BC025ULL },
+    { 0x15E7348EAA0D5134ULL, 0x1B4FEB7EB212CD09ULL },
+    { 0xAB1F5D3EEE710DC4ULL, 0x15D98932280F0A6DULL },
+    { 0xBC1917658B8DA49DULL, 0x117AD428200C0857ULL },
+    { 0x2CF4F23C127C3A94ULL, 0x1BF7B9D9CCE00D59ULL },
+    { 0xF0C3F4FCDB969543ULL, 0x165FC7E170B33DE0ULL },
+    { 0x5A365D9716121103ULL, 0x11E6398126F5CB1AULL },
+    { 0x9056FC24F01CE804ULL, 0x1CA38F350B22DE90ULL },
+    { 0xD9DF301D8CE3ECD0ULL, 0x16E93F5DA2824BA6ULL },
+    { 0xE17F59B13D8323DAULL, 0x125432B14ECEA2EBULL },
+    { 0x68CBC2B52F38395CULL, 0x1D53844EE47DD179ULL },
+    { 0x53D6355DBF602DE3ULL, 0x177603725064A794ULL },
+    { 0xA9782AB165E68B1CULL, 0x12C4CF8EA6B6EC76ULL },
+    { 0x0F26AAB56FD744FAULL, 0x1E07B27DD78B13F1ULL },
+    { 0x3F52222ABFDF6A62ULL, 0x18062864AC6F4327ULL },
+    { 0x65DB4E88997F884EULL, 0x1338205089F29C1FULL },
+    { 0x6FC54A7428CC0D4AULL, 0x1EC033B40FEA9365ULL },
+    { 0x596AA1F68709A43BULL, 0x1899C2F673220F84ULL },
+    { 0xADEEE7F86C07B696ULL, 0x13AE3591F5B4D936ULL },
+    { 0x497E3FF3E00C5756ULL, 0x1F7D228322BAF524ULL },
+    { 0xD464FFF64CD6AC45ULL, 0x1930E868E89590E9ULL },
+    { 0x4383FFF83D7889D1ULL, 0x14272053ED4473EEULL },
+    { 0xCF9CCCC69793A174ULL, 0x101F4D0FF1038FF1ULL },
+    { 0x7F6147A425B90252ULL, 0x19CBAE7FE805B31CULL },
+    { 0xCC4DD2E9B7C7350FULL, 0x14A2F1FFECD15C16ULL },
+    { 0x3D0B0F215FD290D9ULL, 0x10825B3323DAB012ULL },
+    { 0x61AB4B689950E7C1ULL, 0x1A6A2B85062AB350ULL },
+    { 0x4E22A2BA1440B967ULL, 0x1521BC6A6B555C40ULL },
+    { 0x0B4EE894DD009453ULL, 0x10E7C9EEBC4449CDULL },
+    { 0x1217DA87C800ED51ULL, 0x1B0C764AC6D3A948ULL },
+    { 0xDB46486CA000BDDAULL, 0x15A391D56BDC876CULL },
+    { 0x490506BD4CCD64AFULL, 0x114FA7DDEFE39F8AULL },
+    { 0xA8080AC87AE23AB1ULL, 0x1BB2A62FE638FF43ULL },
+    { 0x5339A239FBE82EF4ULL, 0x162884F31E93FF69ULL },
+    { 0x75C7B4FB2FECF25DULL, 0x11BA03F5B20FFF87ULL },
+    { 0x22D92191E647EA2EULL, 0x1C5CD322B67FFF3FULL },
+    { 0xB57A8141850654F2ULL, 0x16B0A8E891FFFF65ULL },
+    { 0xC4620101373843F5ULL, 0x1226ED86DB3332B7ULL },
+    { 0x3A366801F1F39FEEULL, 0x1D0B15A491EB8459ULL },
+    { 0xFB5EB99B27F6198BULL, 0x173C115074BC69E0ULL },
+    { 0x2F7EFAE2865E7AD6ULL, 0x129674405D6387E7ULL },
+    { 0xE597F7D0D6FD9156ULL, 0x1DBD86CD6238D971ULL },
+    { 0x8479930D78CADAABULL, 0x17CAD23DE82D7AC1ULL },
+    { 0xD06142712D6F1556ULL, 0x1308A831868AC89AULL },
+    { 0x4D686A4EAF182222ULL, 0x1E74404F3DAADA91ULL },
+    { 0xA453883EF279B4E8ULL, 0x185D003F6488AEDAULL },
+    { 0xE9DC6CFF28615D87ULL, 0x137D99CC506D58AEULL },
+    { 0xA960AE650D6895A4ULL, 0x1F2F5C7A1A488DE4ULL },
+    { 0xBAB3BEB73DED4483ULL, 0x18F2B061AEA07183ULL },
+    { 0x2EF6322C318A9D36ULL, 0x13F559E7BEE6C136ULL },
+    { 0xE4BD1D13827761F0ULL, 0x1FEEF63F97D79B89ULL },
+    { 0x83CA7DA9352C4E5AULL, 0x198BF832DFDFAFA1ULL },
+    { 0x9CA1FE20F756A515ULL, 0x146FF9C24CB2F2E7ULL },
+    { 0x4A1B31B3F9121DAAULL, 0x1059949B708F28B9ULL },
+    { 0x435EB5ECC1B695DDULL, 0x1A28EDC580E50DF5ULL },
+    { 0x35E55E57015EDE4AULL, 0x14ED8B04671DA4C4ULL },
+    { 0xC4B77EAC0118B1D5ULL, 0x10BE08D0527E1D69ULL },
+    { 0xA12597799B5AB622ULL, 0x1AC9A7B3B7302F0FULL },
+    { 0x4DB7AC6149155E81ULL, 0x156E1FC2F8F358D9ULL },
+    { 0xD7C6238107444B9BULL, 0x1124E63593F5E0ADULL },
+    { 0x593D059B3ED3AC2BULL, 0x1B6E3D2286563449ULL },
+    { 0xE0FD9E15CBDC89BCULL, 0x15F1CA820511C36DULL },
+    { 0xB3FE18116FE3A163ULL, 0x118E3B9B37416924ULL },
+    { 0x866359B57FD29BD1ULL, 0x1C16C5C525357507ULL },
+    { 0xD1E91491330EE30EULL, 0x16789E3750F790D2ULL },
+    { 0x74BA76DA8F3F1C0BULL, 0x11FA182C40C60D75ULL },
+    { 0xEDF72490E531C678ULL, 0x1CC359E067A348BBULL },
+    { 0x8B2C1D40B75B052DULL, 0x1702AE4D1FB5D3C9ULL },
+    { 0x6F567DCD5F7C0424ULL, 0x12688B70E62B0FD4ULL },
+    { 0x7EF0C94898C66D06ULL, 0x1D74124E3D11B2EDULL },
+    { 0x98C0A106E09EBD9FULL, 0x17900EA4FDA7C257ULL },
+    { 0x470080D24D4BCAE6ULL, 0x12D9A550CAEC9B79ULL },
+    { 0xD800CE1D487944A2ULL, 0x1E29088144ADC58EULL },
+    { 0x1333D8176D2DD082ULL, 0x1820D39A9D57D13FULL },
+    { 0xA8F646792424A6CEULL, 0x134D76154AACA765ULL },
+    { 0x74BD3D8EA03AA47DULL, 0x1EE25688777AA56FULL },
+    { 0x5D64313EE6955064ULL, 0x18B51206C5FBB78CULL },
+    { 0x4AB68DCBEBAAA6B7ULL, 0x13C40E6BD1962C70ULL },
+    { 0x1124161312AAA457ULL, 0x1FA01712E8F0471AULL },
+    { 0xDA8344DC0EEEE9DFULL, 0x194CDF4253F36C14ULL },
+    { 0xE2029D7CD8BF2180ULL, 0x143D7F6843292343ULL },
+    { 0x4E687DFD7A328133ULL, 0x103132B9CF541C36ULL },
+    { 0x4A40C9959050CEB8ULL, 0x19E851294BB9C6BDULL },
+    { 0x0833D477A6A70BC6ULL, 0x14B9DA876FC7D231ULL },
+    { 0xA02976C61EEC096BULL, 0x1094AED2BFD30E8DULL },
+    { 0x004257A364ACDBDFULL, 0x1A877E1DFFB81749ULL },
+    { 0xCD01DFB5EA23E319ULL, 0x153931B1996012A0ULL },
+    { 0x70CE4C91881CB5AEULL, 0x10FA8E27ADE6754DULL },
+    { 0x1AE3ADB5A69455E2ULL, 0x1B2A7D0C4970BBAFULL },
+    { 0x7BE957C4854377E8ULL, 0x15BB973D078D62F2ULL },
+    { 0xC987796A0435F987ULL, 0x1162DF64060AB58EULL },
+    { 0x75A58F1006BCC271ULL, 0x1BD1656CD67788E4ULL },
+    { 0xF7B7A5A66BCA3527ULL, 0x16411DF0AB92D3E9ULL },
+    { 0x5FC61E1EBCA1C41FULL, 0x11CDB18D560F0FEEULL },
+    { 0xFFA363646102D365ULL, 0x1C7C4F4889B1B316ULL },
+    { 0x32E91C504D9BDC51ULL, 0x16C9D906D48E28DFULL },
+    { 0x8F20E37371497D0EULL, 0x123B140576D820B2ULL },
+    { 0x7E9B0585820F2E7CULL, 0x1D2B533BF159CDEAULL },
+    { 0xCBAF379E01A5BECAULL, 0x1755DC2FF447D7EEULL },
+    { 0x0958F94B348498A1ULL, 0x12AB168CC36CACBFULL },
+};
+
+/* 5^i truncated to its top 125 bits, as { low, high } */
+static const uint64_t lept_ryu_pow5[][2] = {
+    { 0x0000000000000000ULL, 0x1000000000000000ULL },
+    { 0x0000000000000000ULL, 0x1400000000000000ULL },
+    { 0x0000000000000000ULL, 0x1900000000000000ULL },
+    { 0x0000000000000000ULL, 0x1F40000000000000ULL },
+    { 0x0000000000000000ULL, 0x1388000000000000ULL },
+    { 0x0000000000000000ULL, 0x186A000000000000ULL },
+    { 0x0000000000000000ULL, 0x1E84800000000000ULL },
+    { 0x0000000000000000ULL, 0x1312D00000000000ULL },
+    { 0x0000000000000000ULL, 0x17D7840000000000ULL },
+    { 0x0000000000000000ULL, 0x1DCD650000000000ULL },
+    { 0x0000000000000000ULL, 0x12A05F2000000000ULL },
+    { 0x0000000000000000ULL, 0x174876E800000000ULL },
+    { 0x0000000000000000ULL, 0x1D1A94A200000000ULL },
+    { 0x0000000000000000ULL, 0x12309CE540000000ULL },
+    { 0x0000000000000000ULL, 0x16BCC41E90000000ULL },
+    { 0x0000000000000000ULL, 0x1C6BF52634000000ULL },
+    { 0x0000000000000000ULL, 0x11C37937E0800000ULL },
+    { 0x0000000000000000ULL, 0x16345785D8A00000ULL },
+    { 0x0000000000000000ULL, 0x1BC16D674EC80000ULL },
+    { 0x0000000000000000ULL, 0x1158E460913D0000ULL },
+    { 0x0000000000000000ULL, 0x15AF1D78B58C4000ULL },
+    { 0x0000000000000000ULL, 0x1B1AE4D6E2EF5000ULL },
+    { 0x0000000000000000ULL, 0x10F0CF064DD59200ULL },
+    { 0x0000000000000000ULL, 0x152D02C7E14AF680ULL },
+    { 0x0000000000000000ULL, 0x1A784379D99DB420ULL },
+    { 0x0000000000000000ULL, 0x108B2A2C28029094ULL },
+    { 0x0000000000000000ULL, 0x14ADF4B7320334B9ULL },
+    { 0x4000000000000000ULL, 0x19D971E4FE8401E7ULL },
+    { 0x8800000000000000ULL, 0x1027E72F1F128130ULL },
+    { 0xAA00000000000000ULL, 0x1431E0FAE6D7217CULL },
+    { 0xD480000000000000ULL, 0x193E5939A08CE9DBULL },
+    { 0xC9A0000000000000ULL, 0x1F8DEF8808B02452ULL },
+    { 0xBE04000000000000ULL, 0x13B8B5B5056E16B3ULL },
+    { 0xAD85000000000000ULL, 0x18A6E32246C99C60ULL },
+    { 0xD8E6400000000000ULL, 0x1ED09BEAD87C0378ULL },
+    { 0x878FE80000000000ULL, 0x13426172C74D822BULL },
+    { 0x6973E20000000000ULL, 0x1812F9CF7920E2B6ULL },
+    { 0x03D0DA8000000000ULL, 0x1E17B84357691B64ULL },
+    { 0x8262889000000000ULL, 0x12CED32A16A1B11EULL },
+    { 0x22FB2AB400000000ULL, 0x178287F49C4A1D66ULL },
+    { 0xABB9F56100000000ULL, 0x1D6329F1C35CA4BFULL },
+    { 0xCB54395CA0000000ULL, 0x125DFA371A19E6F7ULL },
+    { 0xBE2947B3C8000000ULL, 0x16F578C4E0A060B5ULL },
+    { 0x2DB399A0BA000000ULL, 0x1CB2D6F618C878E3ULL },
+    { 0xFC90400474400000ULL, 0x11EFC659CF7D4B8DULL },
+    { 0x7BB4500591500000ULL, 0x166BB7F0435C9E71ULL },
+    { 0xDAA16406F5A40000ULL, 0x1C06A5EC5433C60DULL },
+    { 0xA8A4DE8459868000ULL, 0x118427B3B4A05BC8ULL },
+    { 0xD2CE16256FE82000ULL, 0x15E531A0A1C872BAULL },
+    { 0x87819BAECBE22800ULL, 0x1B5E7E08CA3A8F69ULL },
+    { 0xF4B1014D3F6D5900ULL, 0x111B0EC57E6499A1ULL },
+    { 0x71DD41A08F48AF40ULL, 0x1561D276DDFDC00AULL },
+    { 0x0E549208B31ADB10ULL, 0x1ABA4714957D300DULL },
+    { 0x28F4DB456FF0C8EAULL, 0x10B46C6CDD6E3E08ULL },
+    { 0x33321216CBECFB24ULL, 0x14E1878814C9CD8AULL },
+    { 0xBFFE969C7EE839EDULL, 0x1A19E96A19FC40ECULL },
+    { 0xF7FF1E21CF512434ULL, 0x105031E2503DA893ULL },
+    { 0xF5FEE5AA43256D41ULL, 0x14643E5AE44D12B8ULL },
+    { 0x337E9F14D3EEC892ULL, 0x197D4DF19D605767ULL },
+    { 0x005E46DA08EA7AB6ULL, 0x1FDCA16E04B86D41ULL },
+    { 0xA03AEC4845928CB2ULL, 0x13E9E4E4C2F34448ULL },
+    { 0xC849A75A56F72FDEULL, 0x18E45E1DF3B0155AULL },
+    { 0x7A5C1130ECB4FBD6ULL, 0x1F1D75A5709C1AB1ULL },
+    { 0xEC798ABE93F11D65ULL, 0x13726987666190AEULL },
+    { 0xA797ED6E38ED64BFULL, 0x184F03E93FF9F4DAULL },
+    { 0x517DE8C9C728BDEFULL, 0x1E62C4E38FF87211ULL },
+    { 0xD2EEB17E1C7976B5ULL, 0x12FDBB0E39FB474AULL },
+    { 0x87AA5DDDA397D462ULL, 0x17BD29D1C87A191DULL },
+    { 0xE994F5550C7DC97BULL, 0x1DAC74463A989F64ULL },
+    { 0x11FD195527CE9DEDULL, 0x128BC8ABE49F639FULL },
+    { 0xD67C5FAA71C24568ULL, 0x172EBAD6DDC73C86ULL },
+    { 0x8C1B77950E32D6C2ULL, 0x1CFA698C95390BA8ULL },
+    { 0x57912ABD28DFC639ULL, 0x121C81F7DD43A749ULL },
+    { 0xAD75756C7317B7C8ULL, 0x16A3A275D494911BULL },
+    { 0x98D2D2C78FDDA5BAULL, 0x1C4C8B1349B9B562ULL },
+    { 0x9F83C3BCB9EA8794ULL, 0x11AFD6EC0E14115DULL },
+    { 0x0764B4ABE8652979ULL, 0x161BCCA7119915B5ULL },
+    { 0x493DE1D6E27E73D7ULL, 0x1BA2BFD0D5FF5B22ULL },
+    { 0x6DC6AD264D8F0866ULL, 0x1145B7E285BF98F5ULL },
+    { 0xC938586FE0F2CA80ULL, 0x159725DB272F7F32ULL },
+    { 0x7B866E8BD92F7D20ULL, 0x1AFCEF51F0FB5EFFULL },
+    { 0xAD34051767BDAE34ULL, 0x10DE1593369D1B5FULL },
+    { 0x9881065D41AD19C1ULL, 0x15159AF804446237ULL },
+    { 0x7EA147F492186032ULL, 0x1A5B01B605557AC5ULL },
+    { 0x6F24CCF8DB4F3C1FULL, 0x1078E111C3556CBBULL },
+    { 0x4AEE003712230B27ULL, 0x14971956342AC7EAULL },
+    { 0xDDA98044D6ABCDF0ULL, 0x19BCDFABC13579E4ULL },
+    { 0x0A89F02B062B60B6ULL, 0x10160BCB58C16C2FULL },
+    { 0xCD2C6C35C7B638E4ULL, 0x141B8EBE2EF1C73AULL },
+    { 0x8077874339A3C71DULL, 0x1922726DBAAE3909ULL },
+    { 0xE0956914080CB8E4ULL, 0x1F6B0F092959C74BULL },
+    { 0x6C5D61AC8507F38EULL, 0x13A2E965B9D81C8FULL },
+    { 0x4774BA17A649F072ULL, 0x188BA3BF284E23B3ULL },
+    { 0x1951E89D8FDC6C8FULL, 0x1EAE8CAEF261ACA0ULL },
+    { 0x0FD3316279E9C3D9ULL, 0x132D17ED577D0BE4ULL },
+    { 0x13C7FDBB186434CFULL, 0x17F85DE8AD5C4EDDULL },
+    { 0x58B9FD29DE7D4203ULL, 0x1DF67562D8B36294ULL },
+    { 0xB7743E3A2B0E4942ULL, 0x12BA095DC7701D9CULL },
+    { 0xE5514DC8B5D1DB92ULL, 0x17688BB5394C2503ULL },
+    { 0xDEA5A13AE3465277ULL, 0x1D42AEA2879F2E44ULL },
+    { 0x0B2784C4CE0BF38AULL, 0x1249AD2594C37CEBULL },
+    { 0xCDF165F6018EF06DULL, 0x16DC186EF9F45C25ULL },
+    { 0x416DBF7381F2AC88ULL, 0x1C931E8AB871732FULL },
+    { 0x88E497A83137ABD5ULL, 0x11DBF316B346E7FDULL },
+    { 0xEB1DBD923D8596CAULL, 0x1652EFDC6018A1FCULL },
+    { 0x25E52CF6CCE6FC7DULL, 0x1BE7ABD3781ECA7CULL },
+    { 0x97AF3C1A40105DCEULL, 0x1170CB642B133E8DULL },
+    { 0xFD9B0B20D0147542ULL, 0x15CCFE3D35D80E30ULL },
+    { 0x3D01CDE904199292ULL, 0x1B403DCC834E11BDULL },
+    { 0x462120B1A28FFB9BULL, 0x1108269FD210CB16ULL },
+    { 0xD7A968DE0B33FA82ULL, 0x154A3047C694FDDBULL },
+    { 0xCD93C3158E00F923ULL, 0x1A9CBC59B83A3D52ULL },
+    { 0xC07C59ED78C09BB6ULL, 0x10A1F5B813246653ULL },
+    { 0xB09B7068D6F0C2A3ULL, 0x14CA732617ED7FE8ULL },
+    { 0xDCC24C830CACF34CULL, 0x19FD0FEF9DE8DFE2ULL },
+    { 0xC9F96FD1E7EC180FULL, 0x103E29F5C2B18BEDULL },
+    { 0x3C77CBC661E71E13ULL, 0x144DB473335DEEE9ULL },
+    { 0x8B95BEB7FA60E598ULL, 0x1961219000356AA3ULL },
+    { 0x6E7B2E65F8F91EFEULL, 0x1FB969F40042C54CULL },
+    { 0xC50CFCFFBB9BB35FULL, 0x13D3E2388029BB4FULL },
+    { 0xB6503C3FAA82A037ULL, 0x18C8DAC6A0342A23ULL },
+    { 0xA3E44B4F95234844ULL, 0x1EFB1178484134ACULL },
+    { 0xE66EAF11BD360D2BULL, 0x135CEAEB2D28C0EBULL },
+    { 0xE00A5AD62C839075ULL, 0x183425A5F872F126ULL },
+    { 0x980CF18BB7A47493ULL, 0x1E412F0F768FAD70ULL },
+    { 0x5F0816F752C6C8DCULL, 0x12E8BD69AA19CC66ULL },
+    { 0xF6CA1CB527787B13ULL, 0x17A2ECC414A03F7FULL },
+    { 0xF47CA3E2715699D7ULL, 0x1D8BA7F519C84F5FULL },
+    { 0xF8CDE66D86D62026ULL, 0x127748F9301D319BULL },
+    { 0xF7016008E88BA830ULL, 0x17151B377C247E02ULL },
+    { 0xB4C1B80B22AE923CULL, 0x1CDA62055B2D9D83ULL },
+    { 0x50F91306F5AD1B65ULL, 0x12087D4358FC8272ULL },
+    { 0xE53757C8B318623FULL, 0x168A9C942F3BA30EULL },
+    { 0x9E852DBADFDE7ACFULL, 0x1C2D43B93B0A8BD2ULL },
+    { 0xA3133C94CBEB0CC1ULL, 0x119C4A53C4E69763ULL },
+    { 0x8BD80BB9FEE5CFF1ULL, 0x16035CE8B6203D3CULL },
+    { 0xAECE0EA87E9F43EEULL, 0x1B843422E3A84C8BULL },
+    { 0x4D40C9294F238A75ULL, 0x1132A095CE492FD7ULL },
+    { 0x2090FB73A2EC6D12ULL, 0x157F48BB41DB7BCDULL },
+    { 0x68B53A508BA78856ULL, 0x1ADF1AEA12525AC0ULL },
+    { 0x417144725748B536ULL, 0x10CB70D24B7378B8ULL },
+    { 0x51CD958EED1AE283ULL, 0x14FE4D06DE5056E6ULL },
+    { 0xE640FAF2A8619B24ULL, 0x1A3DE04895E46C9FULL },
+    { 0xEFE89CD7A93D00F7ULL, 0x1066AC2D5DAEC3E3ULL },
+    { 0xEBE2C40D938C4134ULL, 0x14805738B51A74DCULL },
+    { 0x26DB7510F86F5181ULL, 0x19A06D06E2611214ULL },
+    { 0x9849292A9B4592F1ULL, 0x100444244D7CAB4CULL },
+    { 0xBE5B73754216F7ADULL, 0x1405552D60DBD61FULL },
+    { 0xADF25052929CB598ULL, 0x1906AA78B912CBA7ULL },
+    { 0x996EE4673743E2FFULL, 0x1F485516E7577E91ULL },
+    { 0xFFE54EC0828A6DDFULL, 0x138D352E5096AF1AULL },
+    { 0xBFDEA270A32D0957ULL, 0x18708279E4BC5AE1ULL },
+    { 0x2FD64B0CCBF84BADULL, 0x1E8CA3185DEB719AULL },
+    { 0x5DE5EEE7FF7B2F4CULL, 0x1317E5EF3AB32700ULL },
+    { 0x755F6AA1FF59FB1FULL, 0x17DDDF6B095FF0C0ULL },
+    { 0x92B7454A7F3079E7ULL, 0x1DD55745CBB7ECF0ULL },
+    { 0x5BB28B4E8F7E4C30ULL, 0x12A5568B9F52F416ULL },
+    { 0xF29F2E22335DDF3CULL, 0x174EAC2E8727B11BULL },
+    { 0xEF46F9AAC035570BULL, 0x1D22573A28F19D62ULL },
+    { 0xD58C5C0AB8215667ULL, 0x123576845997025DULL },
+    { 0x4AEF730D6629AC01ULL, 0x16C2D4256FFCC2F5ULL },
+    { 0x9DAB4FD0BFB41701ULL, 0x1C73892ECBFBF3B2ULL },
+    { 0xA28B11E277D08E60ULL, 0x11C835BD3F7D784FULL },
+    { 0x8B2DD65B15C4B1F9ULL, 0x163A432C8F5CD663ULL },
+    { 0x6DF94BF1DB35DE77ULL, 0x1BC8D3F7B3340BFCULL },
+    { 0xC4BBCF772901AB0AULL, 0x115D847AD000877DULL },
+    { 0x35EAC354F34215CDULL, 0x15B4E5998400A95DULL },
+    { 0x8365742A30129B40ULL, 0x1B221EFFE500D3B4ULL },
+    { 0xD21F689A5E0BA108ULL, 0x10F5535FEF208450ULL },
+    { 0x06A742C0F58E894AULL, 0x1532A837EAE8A565ULL },
+    { 0x4851137132F22B9DULL, 0x1A7F5245E5A2CEBEULL },
+    { 0xED32AC26BFD75B42ULL, 0x108F936BAF85C136ULL },
+    { 0xA87F57306FCD3212ULL, 0x14B378469B673184ULL },
+    { 0xD29F2CFC8BC07E97ULL, 0x19E056584240FDE5ULL },
+    { 0xA3A37C1DD7584F1EULL, 0x102C35F729689EAFULL },
+    { 0x8C8C5B254D2E62E6ULL, 0x14374374F3C2C65BULL },
+    { 0x6FAF71EEA079FB9FULL, 0x1945145230B377F2ULL },
+    { 0x0B9B4E6A48987A87ULL, 0x1F965966BCE055EFULL },
+    { 0x674111026D5F4C94ULL, 0x13BDF7E0360C35B5ULL },
+    { 0xC111554308B71FBAULL, 0x18AD75D8438F4322ULL },
+    { 0x7155AA93CAE4E7A8ULL, 0x1ED8D34E547313EBULL },
+    { 0x26D58A9C5ECF10C9ULL, 0x13478410F4C7EC73ULL },
+    { 0xF08AED437682D4FBULL, 0x1819651531F9E78FULL },
+    { 0xECADA89454238A3AULL, 0x1E1FBE5A7E786173ULL },
+    { 0x73EC895CB4963664ULL, 0x12D3D6F88F0B3CE8ULL },
+    { 0x90E7ABB3E1BBC3FDULL, 0x1788CCB6B2CE0C22ULL },
+    { 0x352196A0DA2AB4FDULL, 0x1D6AFFE45F818F2BULL },
+    { 0x0134FE24885AB11EULL, 0x1262DFEEBBB0F97BULL },
+    { 0xC1823DADAA715D65ULL, 0x16FB97EA6A9D37D9ULL },
+    { 0x31E2CD19150DB4BFULL, 0x1CBA7DE5054485D0ULL },
+    { 0x1F2DC02FAD2890F7ULL, 0x11F48EAF234AD3A2ULL },
+    { 0xA6F9303B9872B535ULL, 0x1671B25AEC1D888AULL },
+    { 0x50B77C4A7E8F6282ULL, 0x1C0E1EF1A724EAADULL },
+    { 0x5272ADAE8F199D91ULL, 0x1188D357087712ACULL },
+    { 0x670F591A32E004F6ULL, 0x15EB082CCA94D757ULL },
+    { 0x40D32F60BF980633ULL, 0x1B65CA37FD3A0D2DULL },
+    { 0x4883FD9C77BF03E0ULL, 0x111F9E62FE44483CULL },
+    { 0x5AA4FD0395AEC4D8ULL, 0x156785FBBDD55A4BULL },
+    { 0x314E3C447B1A760EULL, 0x1AC1677AAD4AB0DEULL },
+    { 0xDED0E5AACCF089C9ULL, 0x10B8E0ACAC4EAE8AULL },
+    { 0x96851F15802CAC3BULL, 0x14E718D7D7625A2DULL },
+    { 0xFC2666DAE037D74AULL, 0x1A20DF0DCD3AF0B8ULL },
+    { 0x9D980048CC22E68EULL, 0x10548B68A044D673ULL },
+    { 0x84FE005AFF2BA032ULL, 0x1469AE42C8560C10ULL },
+    { 0xA63D8071BEF6883EULL, 0x198419D37A6B8F14ULL },
+    { 0xCFCCE08E2EB42A4EULL, 0x1FE52048590672D9ULL },
+    { 0x21E00C58DD309A70ULL, 0x13EF342D37A407C8ULL },
+    { 0x2A580F6F147CC10DULL, 0x18EB0138858D09BAULL },
+    { 0xB4EE134AD99BF150ULL, 0x1F25C186A6F04C28ULL },
+    { 0x7114CC0EC80176D2ULL, 0x137798F428562F99ULL },
+    { 0xCD59FF127A01D486ULL, 0x18557F31326BBB7FULL },
+    { 0xC0B07ED7188249A8ULL, 0x1E6ADEFD7F06AA5FULL },
+    { 0xD86E4F466F516E09ULL, 0x1302CB5E6F642A7BULL },
+    { 0xCE89E3180B25C98BULL, 0x17C37E360B3D351AULL },
+    { 0x822C5BDE0DEF3BEEULL, 0x1DB45DC38E0C8261ULL },
+    { 0xF15BB96AC8B58575ULL, 0x1290BA9A38C7D17CULL },
+    { 0x2DB2A7C57AE2E6D2ULL, 0x1734E940C6F9C5DCULL },
+    { 0x391F51B6D99BA086ULL, 0x1D022390F8B83753ULL },
+    { 0x03B3931248014454ULL, 0x1221563A9B732294ULL },
+    { 0x04A077D6DA019569ULL, 0x16A9ABC9424FEB39ULL },
+    { 0x45C895CC9081FAC3ULL, 0x1C5416BB92E3E607ULL },
+    { 0x8B9D5D9FDA513CBAULL, 0x11B48E353BCE6FC4ULL },
+    { 0xAE84B507D0E58BE8ULL, 0x1621B1C28AC20BB5ULL },
+    { 0x1A25E249C51EEEE3ULL, 0x1BAA1E332D728EA3ULL },
+    { 0xF057AD6E1B33554DULL, 0x114A52DFFC679925ULL },
+    { 0x6C6D98C9A2002AA1ULL, 0x159CE797FB817F6FULL },
+    { 0x4788FEFC0A803549ULL, 0x1B04217DFA61DF4BULL },
+    { 0x0CB59F5D8690214EULL, 0x10E294EEBC7D2B8FULL },
+    { 0xCFE30734E83429A1ULL, 0x151B3A2A6B9C7672ULL },
+    { 0x83DBC9022241340AULL, 0x1A6208B50683940FULL },
+    { 0xB2695DA15568C086ULL, 0x107D457124123C89ULL },
+    { 0x1F03B509AAC2F0A7ULL, 0x149C96CD6D16CBACULL },
+    { 0x26C4A24C1573ACD1ULL, 0x19C3BC80C85C7E97ULL },
+    { 0x783AE56F8D684C03ULL, 0x101A55D07D39CF1EULL },
+    { 0x16499ECB70C25F03ULL, 0x1420EB449C8842E6ULL },
+    { 0x9BDC067E4CF2F6C4ULL, 0x19292615C3AA539FULL },
+    { 0x82D3081DE02FB476ULL, 0x1F736F9B3494E887ULL },
+    { 0xB1C3E512AC1DD0C9ULL, 0x13A825C100DD1154ULL },
+    { 0xDE34DE57572544FCULL, 0x18922F31411455A9ULL },
+    { 0x55C215ED2CEE963BULL, 0x1EB6BAFD91596B14ULL },
+    { 0xB5994DB43C151DE5ULL, 0x133234DE7AD7E2ECULL },
+    { 0xE2FFA1214B1A655EULL, 0x17FEC216198DDBA7ULL },
+    { 0xDBBF89699DE0FEB6ULL, 0x1DFE729B9FF15291ULL },
+    { 0x2957B5E202AC9F31ULL, 0x12BF07A143F6D39BULL },
+    { 0xF3ADA35A8357C6FEULL, 0x176EC98994F48881ULL },
+    { 0x70990C31242DB8BDULL, 0x1D4A7BEBFA31AAA2ULL },
+    { 0x865FA79EB69C9376ULL, 0x124E8D737C5F0AA5ULL },
+    { 0xE7F791866443B854ULL, 0x16E230D05B76CD4EULL },
+    { 0xA1F575E7FD54A669ULL, 0x1C9ABD04725480A2ULL },
+    { 0xA53969B0FE54E801ULL, 0x11E0B622C774D065ULL },
+    { 0x0E87C41D3DEA2202ULL, 0x1658E3AB7952047FULL },
+    { 0xD229B5248D64AA82ULL, 0x1BEF1C9657A6859EULL },
+    { 0x435A1136D85EEA91ULL, 0x117571DDF6C81383ULL },
+    { 0x143095848E76A536ULL, 0x15D2CE55747A1864ULL },
+    { 0x193CBAE5B2144E83ULL, 0x1B4781EAD1989E7DULL },
+    { 0x2FC5F4CF8F4CB112ULL, 0x110CB132C2FF630EULL },
+    { 0xBBB77203731FDD56ULL, 0x154FDD7F73BF3BD1ULL },
+    { 0x2AA54E844FE7D4ACULL, 0x1AA3D4DF50AF0AC6ULL },
+    { 0xDAA75112B1F0E4EBULL, 0x10A6650B926D66BBULL },
+    { 0xD15125575E6D1E26ULL, 0x14CFFE4E7708C06AULL },
+    { 0x85A56EAD360865B0ULL, 0x1A03FDE214CAF085ULL },
+    { 0x7387652C41C53F8EULL, 0x10427EAD4CFED653ULL },
+    { 0x50693E7752368F71ULL, 0x14531E58A03E8BE8ULL },
+    { 0x64838E1526C4334EULL, 0x1967E5EEC84E2EE2ULL },
+    { 0xFDA4719A70754022ULL, 0x1FC1DF6A7A61BA9AULL },
+    { 0xDE86C70086494815ULL, 0x13D92BA28C7D14A0ULL },
+    { 0x162878C0A7DB9A1AULL, 0x18CF768B2F9C59C9ULL },
+    { 0x5BB296F0D1D280A1ULL, 0x1F03542DFB83703BULL },
+    { 0x194F9E5683239064ULL, 0x1362149CBD322625ULL },
+    { 0x5FA385EC23EC747EULL, 0x183A99C3EC7EAFAEULL },
+    { 0xF78C67672CE7919DULL, 0x1E494034E79E5B99ULL },
+    { 0x3AB7C0A07C10BB02ULL, 0x12EDC82110C2F940ULL },
+    { 0x4965B0C89B14E9C3ULL, 0x17A93A2954F3B790ULL },
+    { 0x5BBF1CFAC1DA2433ULL, 0x1D9388B3AA30A574ULL },
+    { 0xB957721CB92856A0ULL, 0x127C35704A5E6768ULL },
+    { 0xE7AD4EA3E7726C48ULL, 0x171B42CC5CF60142ULL },
+    { 0xA198A24CE14F075AULL, 0x1CE2137F74338193ULL },
+    { 0x44FF65700CD16498ULL, 0x120D4C2FA8A030FCULL },
+    { 0x563F3ECC1005BDBEULL, 0x16909F3B92C83D3BULL },
+    { 0x2BCF0E7F14072D2EULL, 0x1C34C70A777A4C8AULL },
+    { 0x5B61690F6C847C3DULL, 0x11A0FC668AAC6FD6ULL },
+    { 0xF239C35347A59B4CULL, 0x16093B802D578BCBULL },
+    { 0xEEC83428198F021FULL, 0x1B8B8A6038AD6EBEULL },
+    { 0x553D20990FF96153ULL, 0x1137367C236C6537ULL },
+    { 0x2A8C68BF53F7B9A8ULL, 0x1585041B2C477E85ULL },
+    { 0x752F82EF28F5A812ULL, 0x1AE64521F7595E26ULL },
+    { 0x093DB1D57999890BULL, 0x10CFEB353A97DAD8ULL },
+    { 0x0B8D1E4AD7FFEB4EULL, 0x1503E602893DD18EULL },
+    { 0x8E7065DD8DFFE622ULL, 0x1A44DF832B8D45F1ULL },
+    { 0xF9063FAA78BFEFD5ULL, 0x106B0BB1FB384BB6ULL },
+    { 0xB747CF9516EFEBCAULL, 0x1485CE9E7A065EA4ULL },
+    { 0xE519C37A5CABE6BDULL, 0x19A742461887F64DULL },
+    { 0xAF301A2C79EB7036ULL, 0x1008896BCF54F9F0ULL },
+    { 0xDAFC20B798664C43ULL, 0x140AABC6C32A386CULL },
+    { 0x11BB28E57E7FDF54ULL, 0x190D56B873F4C688ULL },
+    { 0x1629F31EDE1FD72AULL, 0x1F50AC6690F1F82AULL },
+    { 0x4DDA37F34AD3E67AULL, 0x13926BC01A973B1AULL },
+    { 0xE150C5F01D88E019ULL, 0x187706B0213D09E0ULL },
+    { 0x19A4F76C24EB181FULL, 0x1E94C85C298C4C59ULL },
+    { 0xB0071AA39712EF13ULL, 0x131CFD3999F7AFB7ULL },
+    { 0x9C08E14C7CD7AAD8ULL, 0x17E43C8800759BA5ULL },
+    { 0x030B199F9C0D958EULL, 0x1DDD4BAA0093028FULL },
+    { 0x61E6F003C1887D79ULL, 0x12AA4F4A405BE199ULL },
+    { 0xBA60AC04B1EA9CD7ULL, 0x1754E31CD072D9FFULL },
+    { 0xA8F8D705DE65440DULL, 0x1D2A1BE4048F907FULL },
+    { 0xC99B8663AAFF4A88ULL, 0x123A516E82D9BA4FULL },
+    { 0xBC0267FC95BF1D2AULL, 0x16C8E5CA239028E3ULL },
+    { 0xAB0301FBBB2EE474ULL, 0x1C7B1F3CAC74331CULL },
+    { 0xEAE1E13D54FD4EC9ULL, 0x11CCF385EBC89FF1ULL },
+    { 0x659A598CAA3CA27BULL, 0x1640306766BAC7EEULL },
+    { 0xFF00EFEFD4CBCB1AULL, 0x1BD03C81406979E9ULL },
+    { 0x3F6095F5E4FF5EF0ULL, 0x116225D0C841EC32ULL },
+    { 0xCF38BB735E3F36ACULL, 0x15BAAF44FA52673EULL },
+    { 0x8306EA5035CF0457ULL, 0x1B295B1638E7010EULL },
+    { 0x11E4527221A162B6ULL, 0x10F9D8EDE39060A9ULL },
+    { 0x565D670EAA09BB64ULL, 0x15384F295C7478D3ULL },
+    { 0x2BF4C0D2548C2A3DULL, 0x1A8662F3B3919708ULL },
+    { 0x1B78F88374D79A66ULL, 0x1093FDD8503AFE65ULL },
+    { 0x625736A4520D8100ULL, 0x14B8FD4E6449BDFEULL },
+    { 0xFAED044D6690E140ULL, 0x19E73CA1FD5C2D7DULL },
+    { 0xBCD422B0601A8CC8ULL, 0x103085E53E599C6EULL },
+    { 0x6C092B5C78212FFAULL, 0x143CA75E8DF0038AULL },
+    { 0x070B763396297BF8ULL, 0x194BD136316C046DULL },
+    { 0x48CE53C07BB3DAF6ULL, 0x1F9EC583BDC70588ULL },
+    { 0x2D80F4584D5068DAULL, 0x13C33B72569C6375ULL },
+    { 0x78E1316E60A48310ULL, 0x18B40A4EEC437C52ULL },
+};
+
+/* ceil(log2(5^e)), or 1 for e == 0 */
+static int lept_pow5bits(int e) {
+    return (int)((((uint32_t)e * 1217359) >> 19) + 1);
+}
+
+/* floor(log10(2^e)) */
+static uint32_t lept_log10_pow2(int e) {
+    return ((uint32_t)e * 78913) >> 18;
+}
+
+/* floor(log10(5^e)) */
+static uint32_t lept_log10_pow5(int e) {
+    return ((uint32_t)e * 732923) >> 20;
+}
+
+static int lept_multiple_of_pow5(uint64_t value, uint32_t p) {
+    uint32_t count = 0;
+    while(value % 5 == 0) {
+        value /= 5;
+        count++;
+    }
+    return count >= p;
+}
+
+static int lept_multiple_of_pow2(uint64_t value, uint32_t p) {
+    return (value & (((uint64_t)1 << p) - 1)) == 0;
+}
+
+/* (m * mul) >> j for a 128-bit mul and j in [64, 128) */
+static uint64_t lept_mul_shift64(uint64_t m, const uint64_t* mul, int j) {
+    uint64_t hi0, lo0, hi2, lo2, lo, hi;
+    int s = j - 64;
+
+    lept_mul_64x64(m, mul[0], &hi0, &lo0);
+    lept_mul_64x64(m, mul[1], &hi2, &lo2);
+    lo = hi0 + lo2;
+    hi = hi2 + (lo < hi0);
+
+    return (s == 0) ? lo : (hi << (64 - s)) | (lo >> s);
+}
+
+/* the shortest decimal in the rounding interval of d > 0: output * 10^exp */
+static uint64_t lept_ryu(double d, int* exp) {
+    uint64_t bits, ieee_mantissa, m2, mv, vr, vp, vm, output;
+    uint32_t ieee_exponent, mm_shift;
+    int e2, e10, removed = 0, accept_bounds;
+    int vm_is_trailing_zeros = 0, vr_is_trailing_zeros = 0;
+    unsigned last_removed_digit = 0;
+
+    memcpy(&bits, &d, sizeof(double));
+    ieee_mantissa = bits & (((uint64_t)1 << 52) - 1);
+    ieee_exponent = (uint32_t)((bits >> 52) & 0x7FF);
+
+    /* two extra bits for the bounds */
+    if(ieee_exponent == 0) {
+        e2 = 1 - 1023 - 52 - 2;
+        m2 = ieee_mantissa;
+    } else {
+        e2 = (int)ieee_exponent - 1023 - 52 - 2;
+        m2 = ((uint64_t)1 << 52) | ieee_mantissa;
+    }
+    accept_bounds = (m2 & 1) == 0;
+
+    /* the interval is [mm, mp] = [mv - 1 - mm_shift, mv + 2] scaled by 2^e2 */
+    mv = 4 * m2;
+    mm_shift = (ieee_mantissa != 0 || ieee_exponent <= 1);
+
+    /* convert to a decimal power base */
+    if(e2 >= 0) {
+        uint32_t q = lept_log10_pow2(e2) - (e2 > 3);
+        int k = 125 + lept_pow5bits((int)q) - 1;
+        int i = -e2 + (int)q + k;
+        e10 = (int)q;
+        vr = lept_mul_shift64(4 * m2, lept_ryu_pow5_inv[q], i);
+        vp = lept_mul_shift64(4 * m2 + 2, lept_ryu_pow5_inv[q], i);
+        vm = lept_mul_shift64(4 * m2 - 1 - mm_shift, lept_ryu_pow5_inv[q], i);
+        if(q <= 21) {
+            /* only one of mp, mv and mm can be a multiple of 5, if any */
+            if(mv % 5 == 0) {
+                vr_is_trailing_zeros = lept_multiple_of_pow5(mv, q);
+            } else if(accept_bounds) {
+                vm_is_trailing_zeros = lept_multiple_of_pow5(mv - 1 - mm_shift, q);
+            } else {
+                vp -= lept_multiple_of_pow5(mv + 2, q);
+            }
+        }
+    } else {
+        uint32_t q = lept_log10_pow5(-e2) - (-e2 > 1);
+        int i = -e2 - (int)q;
+        int k = lept_pow5bits(i) - 125;
+        int j = (int)q - k;
+        e10 = (int)q + e2;
+        vr = lept_mul_shift64(4 * m2, lept_ryu_pow5[i], j);
+        vp = lept_mul_shift64(4 * m2 + 2, lept_ryu_pow5[i], j);
+        vm = lept_mul_shift64(4 * m2 - 1 - mm_shift, lept_ryu_pow5[i], j);
+        if(q <= 1) {
+            /* mv = 4 * m2 always has at least two trailing 0 bits */
+            vr_is_trailing_zeros = 1;
+            if(accept_bounds) {
+                vm_is_trailing_zeros = (mm_shift == 1);
+            } else {
+                --vp;
+            }
+        } else if(q < 63) {
+            vr_is_trailing_zeros = lept_multiple_of_pow2(mv, q);
+        }
+    }
+
+    /* drop digits while the interval still holds a shorter number */
+    if(vm_is_trailing_zeros || vr_is_trailing_zeros) {
+        /* rare: exact ties and interval ends need tracking */
+        while(vp / 10 > vm / 10) {
+            vm_is_trailing_zeros &= (vm % 10 == 0);
+            vr_is_trailing_zeros &= (last_removed_digit == 0);
+            last_removed_digit = (unsigned)(vr % 10);
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+        if(vm_is_trailing_zeros) {
+            while(vm % 10 == 0) {
+                vr_is_trailing_zeros &= (last_removed_digit == 0);
+                last_removed_digit = (unsigned)(vr % 10);
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                removed++;
+            }
+        }
+        if(vr_is_trailing_zeros && last_removed_digit == 5 && vr % 2 == 0) {
+            /* exactly .5: round to even */
+            last_removed_digit = 4;
+        }
+        output = vr + ((vr == vm && (!accept_bounds || !vm_is_trailing_zeros)) || last_removed_digit >= 5);
+    } else {
+        int round_up = 0;
+        if(vp / 100 > vm / 100) {
+            round_up = (vr % 100 >= 50);
+            vr /= 100;
+            vp /= 100;
+            vm /= 100;
+            removed += 2;
+        }
+        while(vp / 10 > vm / 10) {
+            round_up = (vr % 10 >= 5);
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+        output = vr + (vr == vm || round_up);
+    }
+
+    *exp = e10 + removed;
+    return output;
+}
+
+static int lept_u64toa(uint64_t n, char* buffer) {
+    char tmp[20];
+    int len = 0, i;
+
+    do {
+        tmp[len++] = (char)('0' + n % 10);
+        n /= 10;
+    } while(n > 0);
+    for(i = 0; i < len; i++) {
+        buffer[i] = tmp[len - 1 - i];
+    }
+
+    return len;
+}
+
+/* lay out len digits worth digits * 10^k, returns the new length */
+static int lept_prettify(char* buffer, int len, int k) {
+    int kk = len + k; /* 10^(kk-1) <= v < 10^kk */
+    int i;
+
+    if(len <= kk && kk <= 17) {
+        /* 1234e7 -> 12340000000 */
+        for(i = len; i < kk; i++) {
+            buffer[i] = '0';
+        }
+        return kk;
+    }
+    if(0 < kk && kk <= 17) {
+        /* 1234e-2 -> 12.34 */
+        memmove(&buffer[kk + 1], &buffer[kk], len - kk);
+        buffer[kk] = '.';
+        return len + 1;
+    }
+    if(-4 < kk && kk <= 0) {
+        /* 1234e-6 -> 0.001234 */
+        int offset = 2 - kk;
+        memmove(&buffer[offset], &buffer[0], len);
+        buffer[0] = '0';
+        buffer[1] = '.';
+        for(i = 2; i < offset; i++) {
+            buffer[i] = '0';
+        }
+        return len + offset;
+    }
+
+    /* 1234e30 -> 1.234e+33 */
+    if(len > 1) {
+        memmove(&buffer[2], &buffer[1], len - 1);
+        buffer[1] = '.';
+        len++;
+    }
+    buffer[len++] = 'e';
+    k = kk - 1;
+    buffer[len++] = (k < 0) ? '-' : '+';
+    if(k < 0) {
+        k = -k;
+    }
+    if(k < 10) {
+        buffer[len++] = '0';
+    }
+    return len + lept_u64toa((uint64_t)k, &buffer[len]);
+}
+
+/* write d into buffer (at least 32 bytes), returns the length */
+static int lept_dtoa(double d, char* buffer) {
+    char* p = buffer;
+    int len, exp;
+
+    if(d != d || d - d != d - d) {
+        /* nan and inf have no JSON form, keep the printf spelling */
+        return sprintf(buffer, "%.17g", d);
+    }
+    if(signbit(d)) {
+        *p++ = '-';
+        d = -d;
+    }
+    if(d == 0.0) {
+        *p = '0';
+        return (int)(p - buffer) + 1;
+    }
+    if(d < 9007199254740992.0 && d == (double)(uint64_t)d) {
+        return (int)(p - buffer) + lept_u64toa((uint64_t)d, p);
+    }
+
+    len = lept_u64toa(lept_ryu(d, &exp), p);
+    return (int)(p - buffer) + lept_prettify(p, len, exp);
+}
+
+/* stringify
+ *
+ * Output is built on the context stack. With a sink, the stack is handed
+ * over and emptied whenever it reaches LEPT_STRINGIFY_BUFFER_SIZE bytes:
+ * every push checks first and raw runs are cut at the mark, so it never
+ * holds more than that plus one token (at most 32 bytes, a number); after
+ * a failed write the rest of the output is dropped.
+ */
+
+static void lept_stringify_flush(lept_context* c) {
+    if(c->top > 0 && c->write_ret == LEPT_STRINGIFY_OK && c->write(c->user, c->stack, c->top) != 0) {
+        c->write_ret = LEPT_STRINGIFY_WRITE_FAILED;
+    }
+    c->top = 0;
+}
+
+#define LEPT_STRINGIFY_CHECK(c) \
+    do { \
+        if((c)->top >= (c)->flush_at) { \
+            lept_stringify_flush(c); \
+        } \
+    } while(0)
+
+#define LEPT_STRINGIFY_PUTC(c, ch) \
+    do { \
+        LEPT_STRINGIFY_CHECK(c); \
+        PUTC(c, ch); \
+    } while(0)
+
+#define PUTRAWS(c, s, len) \
+    do { \
+        LEPT_STRINGIFY_CHECK(c); \
+        memcpy(lept_context_push(c, len), s, len); \
+    } while(0)
+
+/* the letter after the backslash for each byte that needs one, 'u' meaning \u00xx */
+static const char lept_escape[256] = {
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'b', 't', 'n', 'u', 'f', 'r', 'u', 'u',
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u',
+    ['\"'] = '\"', ['\\'] = '\\'
+};
+
+/* append [s, s + len), cut to the sink's buffer size */
+static void lept_stringify_raw(lept_context* c, const char* s, size_t len) {
+    if(c->spill != NULL && c->top + len >= c->size) {
+        /* too long to go over the spill area */
+        lept_context_overflow(c);
+        return ;
+    }
+    while(c->top + len > c->flush_at) {
+        size_t n = (c->top < c->flush_at) ? c->flush_at - c->top : 0;
+        if(n > 0) {
+            memcpy(lept_context_push(c, n), s, n);
+            s += n;
+            len -= n;
+        }
+        lept_stringify_flush(c);
+    }
+    if(len > 0) {
+        memcpy(lept_context_push(c, len), s, len);
+    }
+}
+
+/* clean runs are found by the vector scan kernels and copied at once */
+static void lept_stringify_string(lept_context* c, const char* s, size_t len) {
+    static const char hex[] = "0123456789abcdef";
+    const char* end = s + len;
+
+    LEPT_STRINGIFY_PUTC(c, '\"');
+    while(s < end) {
+        const char* q = lept_scan_string(s, end);
+        if(q != s) {
+            lept_stringify_raw(c, s, q - s);
+            s = q;
+            if(s == end) {
+                break;
+            }
+        }
+        LEPT_STRINGIFY_CHECK(c);
+        char e = lept_escape[(unsigned char)*s];
+        char* p = (char*)lept_context_push(c, (e == 'u') ? 6 : 2);
+        p[0] = '\\';
+        p[1] = e;
+        if(e == 'u') {
+            p[2] = '0';
+            p[3] = '0';
+            p[4] = hex[(unsigned char)*s >> 4];
+            p[5] = hex[*s & 0xF];
+        }
+        s++;
+    }
+    LEPT_STRINGIFY_PUTC(c, '\"');
+}
+
+#define PUTKV(c, v, i) \
+    do { \
+        const char* s = lept_get_object_key((v), (i)); \
+        size_t len = lept_get_object_key_length((v), (i)); \
+        lept_stringify_string((c), s, len); \
+        LEPT_STRINGIFY_PUTC((c), ':'); \
+        lept_stringify_value((c), lept_get_object_value((v), (i))); \
+    } while(0)
+
+
+static int lept_stringify_value(lept_context* c, lept_value* v) {
+    int ret = LEPT_STRINGIFY_OK;
+
+    LEPT_STRINGIFY_CHECK(c);
+
+    switch(v->type) {
+
+    case LEPT_NULL: PUTRAWS(c, "null", 4); break;
+
+    case LEPT_TRUE: PUTRAWS(c, "true", 4); break;
+
+    case LEPT_FALSE: PUTRAWS(c, "false", 5); break;
+
+    case LEPT_NUMBER: {
+        if(c->spill != NULL) {
+            /* a fixed buffer may have room for the digits but not all 32 */
+            char buf[32];
+            lept_stringify_raw(c, buf, lept_dtoa(lept_get_number(v), buf));
+        } else {
+            c->top -= (32 - lept_dtoa(lept_get_number(v), lept_context_push(c, 32)));
+        }
+        break;
+    }
+
+    case LEPT_STRING: {
+        const char* s = lept_get_string(v);
+        size_t len = lept_get_string_length(v);
+        lept_stringify_string(c, s, len);
+        break;
+    }
+
+    case LEPT_ARRAY: {
+        size_t size = lept_get_array_size(v);
+        LEPT_STRINGIFY_PUTC(c, '[');
+        for(size_t i = 0; (size > 0) && (i < size - 1); i ++) {
+            lept_stringify_value(c, lept_get_array_element(v, i));
+            LEPT_STRINGIFY_PUTC(c, ',');
+        }
+        if(size >= 1) {
+            lept_stringify_value(c, lept_get_array_element(v, size - 1));
+        }
+        LEPT_STRINGIFY_PUTC(c, ']');
+        break;
+    }
+
+    case LEPT_OBJECT: {
+        size_t size = lept_get_object_size(v);
+        LEPT_STRINGIFY_PUTC(c, '{');
+        for(size_t i = 0; (size > 0) && (i < size - 1); i ++) {
+            PUTKV(c, v, i);
+            LEPT_STRINGIFY_PUTC(c, ',');
+        }
+        if(size >= 1) {
+            PUTKV(c, v, size - 1);
+        }
+        LEPT_STRINGIFY_PUTC(c, '}');
+        break;
+    }
+
+    default: ret = LEPT_STRINGIFY_UNKNOWN_TYPE; break;
+
+    }
+
+    return ret;
+}
+
+int lept_stringify(lept_value* v, char** json, size_t* len) {
+    assert(v != NULL); assert(json != NULL);
+
+    int ret;
+
+    lept_context c;
+    lept_context_init(&c, NULL, 0);
+
+    ret = lept_stringify_value(&c, v);
+
+    if(ret != LEPT_STRINGIFY_OK) {
+        lept_context_free(&c);
+        *json = NULL;
+    } else {
+        if(len != NULL) {
+            *len = c.top;
+        }
+
+        PUTC(&c, '\0');
+        *json = c.stack;
+    }
+
+    return ret;
+}
+
+int lept_stringify_to(lept_value* v, lept_write_fn write, void* user) {
+    assert(v != NULL); assert(write != NULL);
+
+    int ret;
+
+    lept_context c;
+    lept_context_init(&c, NULL, 0);
+    c.write = write;
+    c.user = user;
+    c.flush_at = LEPT_STRINGIFY_BUFFER_SIZE;
+    /* sized for a full buffer and the token that fills it, so it never grows */
+    c.size = LEPT_STRINGIFY_BUFFER_SIZE + LEPT_PARSE_STACK_INIT_SIZE;
+    c.stack = (char*)malloc(c.size);
+
+    ret = lept_stringify_value(&c, v);
+    lept_stringify_flush(&c);
+    if(ret == LEPT_STRINGIFY_OK) {
+        ret = c.write_ret;
+    }
+
+    lept_context_free(&c);
+
+    return ret;
+}
+
+static int lept_write_file(void* user, const char* s, size_t len) {
+    return fwrite(s, 1, len, (FILE*)user) != len;
+}
+
+int lept_stringify_file(lept_value* v, FILE* fp) {
+    assert(fp != NULL);
+    return lept_stringify_to(v, lept_write_file, fp);
+}
+
+static int lept_write_fd(void* user, const char* s, size_t len) {
+    int fd = *(const int*)user;
+
+    while(len > 0) {
+#ifdef _WIN32
+        int n = _write(fd, s, (unsigned)len);
+#else
+        ssize_t n = write(fd, s, len);
+#endif
+        if(n < 0) {
+            if(errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        s += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+int lept_stringify_fd(lept_value* v, int fd) {
+    return lept_stringify_to(v, lept_write_fd, &fd);
+}
+
+/* parallel
+ *
+ * A root array or object of many elements is cut into equal runs of
+ * elements, each written by its own worker into a buffer of its own; the
+ * runs are then joined, with the brackets and commas between them, into
+ * one allocation of the exact size. Smaller values, and everything below
+ * the root, are written by lept_stringify() on the calling thread.
+ */
+
+#ifndef LEPT_PARALLEL_MIN_ELEMENTS
+#define LEPT_PARALLEL_MIN_ELEMENTS 1024 /* fewer per thread are not split */
+#endif
+
+typedef struct {
+    lept_value* v;
+    size_t first, last;
+    char* s;
+    size_t len;
+    int ret;
+} lept_stringify_job;
+
+static void lept_stringify_worker(void* arg) {
+    lept_stringify_job* job = (lept_stringify_job*)arg;
+    lept_context c;
+    int ret = LEPT_STRINGIFY_OK;
+
+    lept_context_init(&c, NULL, 0);
+    for(size_t i = job->first; i < job->last && ret == LEPT_STRINGIFY_OK; i ++) {
+        if(i > job->first) {
+            PUTC(&c, ',');
+        }
+        if(job->v->type == LEPT_ARRAY) {
+            ret = lept_stringify_value(&c, &job->v->e[i]);
+        } else {
+            PUTKV(&c, job->v, i);
+        }
+    }
+    job->s = c.stack;
+    job->len = c.top;
+    job->ret = ret;
+}
+
+int lept_stringify_parallel(lept_value* v, char** json, size_t* len, int nthreads) {
+    lept_stringify_job jobs[LEPT_MAX_THREADS];
+    size_t size, total = 2;
+    int t, ret = LEPT_STRINGIFY_OK;
+    char* p;
+
+    assert(v != NULL); assert(json != NULL);
+
+    size = (v->type == LEPT_ARRAY || v->type == LEPT_OBJECT) ? v->size : 0;
+    nthreads = lept_threads(nthreads, size / LEPT_PARALLEL_MIN_ELEMENTS);
+    if(nthreads < 2) {
+        return lept_stringify(v, json, len);
+    }
+
+    for(t = 0; t < nthreads; t ++) {
+        jobs[t].v = v;
+        jobs[t].first = size * t / nthreads;
+        jobs[t].last = size * (t + 1) / nthreads;
+    }
+    lept_run_jobs(lept_stringify_worker, jobs, sizeof(lept_stringify_job), nthreads);
+
+    for(t = 0; t < nthreads; t ++) {
+        total += jobs[t].len + (t > 0);
+        if(jobs[t].ret != LEPT_STRINGIFY_OK) {
+            ret = jobs[t].ret;
+        }
+    }
+    *json = NULL;
+    if(ret == LEPT_STRINGIFY_OK) {
+        *json = p = (char*)malloc(total + 1);
+        *p ++ = (v->type == LEPT_ARRAY) ? '[' : '{';
+        for(t = 0; t < nthreads; t ++) {
+            if(t > 0) {
+                *p ++ = ',';
+            }
+            memcpy(p, jobs[t].s, jobs[t].len);
+            p += jobs[t].len;
+        }
+        *p ++ = (v->type == LEPT_ARRAY) ? ']' : '}';
+        *p = '\0';
+        if(len != NULL) {
+            *len = total;
+        }
+    }
+    for(t = 0; t < nthreads; t ++) {
+        free(jobs[t].s);
+    }
+
+    return ret;
+}
+
+/* length
+ *
+ * The measuring pass follows lept_stringify_value() without writing:
+ * numbers are formatted into a scratch buffer, strings are scanned for the
+ * bytes that expand into escapes.
+ */
+
+static size_t lept_stringify_string_length(const char* s, size_t len) {
+    size_t n = 2; /* quotes */
+
+    for(size_t i = 0; i < len; i ++) {
+        char e = lept_escape[(unsigned char)s[i]];
+        n += (e == 0) ? 1 : (e == 'u') ? 6 : 2;
+    }
+
+    return n;
+}
+
+/* decimal digits of n */
+static size_t lept_u64len(uint64_t n) {
+    size_t len = 1;
+    for(; n >= 10000; n /= 10000) {
+        len += 4;
+    }
+    for(; n >= 10; n /= 10) {
+        len ++;
+    }
+    return len;
+}
+
+static size_t lept_number_length(double d) {
+    char buffer[32];
+    double a = (d < 0) ? -d : d;
+
+    /* integers print as their digits, the rest goes through lept_dtoa() */
+    if(a < 9007199254740992.0 && a == (double)(uint64_t)a && !(a == 0.0 && signbit(d))) {
+        return (d < 0) + lept_u64len((uint64_t)a);
+    }
+    return (size_t)lept_dtoa(d, buffer);
+}
+
+size_t lept_stringify_length(lept_value* v) {
+    size_t n;
+
+    assert(v != NULL);
+
+    switch(v->type) {
+        case LEPT_NULL:
+        case LEPT_TRUE:   return 4;
+        case LEPT_FALSE:  return 5;
+        case LEPT_NUMBER: return lept_number_length(v->n);
+        case LEPT_STRING: return lept_stringify_string_length(LEPT_STRING_PTR(v), LEPT_STRING_LEN(v));
+        case LEPT_ARRAY:
+            /* brackets and commas */
+            n = (v->size > 0) ? v->size + 1 : 2;
+            for(size_t i = 0; i < v->size; i ++) {
+                n += lept_stringify_length(&v->e[i]);
+            }
+            return n;
+        case LEPT_OBJECT:
+            /* braces, commas and colons */
+            n = (v->size > 0) ? 2 * (size_t)v->size + 1 : 2;
+            for(size_t i = 0; i < v->size; i ++) {
+                const lept_value* k = &v->m[i].k;
+                n += lept_stringify_string_length(LEPT_STRING_PTR(k), LEPT_STRING_LEN(k));
+                n += lept_stringify_length(&v->m[i].v);
+            }
+            return n;
+        default:
+            return 0;
+    }
+}
+
+int lept_stringify_into(lept_value* v, char* buf, size_t cap, size_t* len) {
+    char spill[LEPT_CONTEXT_SPILL_SIZE];
+    lept_context c;
+    int ret;
+
+    assert(v != NULL && (buf != NULL || cap == 0));
+
+    /* the stack is buf itself, one byte is always left for the '\0' */
+    lept_context_init(&c, NULL, 0);
+    c.stack = buf;
+    c.size = cap;
+    c.spill = spill;
+
+    ret = lept_stringify_value(&c, v);
+    if(ret == LEPT_STRINGIFY_OK) {
+        ret = c.write_ret;
+    }
+    if(ret == LEPT_STRINGIFY_OK) {
+        buf[c.top] = '\0';
+        if(len != NULL) {
+            *len = c.top;
+        }
+    }
+
+    return ret;
+}
+
+/* binary
+ *
+ * A CBOR or MessagePack document is read one item header at a time by
+ * lept_cbor_item() or lept_msgpack_item(). The loop they share keeps the
+ * open containers on c->levels, counting items (a member is two) against
+ * the number announced, and sends the events to the DOM handler as the
+ * text parser does, so the tree, the depth limit and the unwinding after
+ * an error are the same. Strings are passed straight from the input, but
+ * CBOR strings sent in chunks are joined on the stack first.
+ *
+ * The encoders write to the context stack as lept_stringify() does. Whole
+ * numbers take the shortest integer form, others float32 when that is
+ * exact, else float64.
+ */
+
+#define LEPT_INDEFINITE ((size_t)-1) /* CBOR container ended by a break */
+
+typedef struct {
+    char kind;      /* 'n' number, 's' string, 'l' literal, '[' '{' open, ']' break */
+    lept_type type; /* 'l' */
+    double n;       /* 'n' */
+    const char* s;  /* 's' */
+    size_t len;     /* 's': bytes, '[': elements, '{': members, or LEPT_INDEFINITE */
+} lept_item;
+
+typedef int (*lept_item_fn)(lept_context* c, lept_item* it);
+
+/* w big-endian bytes */
+static int lept_bin_read(lept_context* c, int w, uint64_t* n) {
+    const unsigned char* p = (const unsigned char*)c->json;
+
+    if(c->end - c->json < w) {
+        return LEPT_PARSE_EXPECT_VALUE;
+    }
+    *n = 0;
+    for(int i = 0; i < w; i ++) {
+        *n = (*n << 8) | p[i];
+    }
+    c->json += w;
+    return LEPT_PARSE_OK;
+}
+
+static int lept_bin_string(lept_context* c, lept_item* it, uint64_t len) {
+    if(len > (uint64_t)(c->end - c->json)) {
+        return LEPT_PARSE_EXPECT_VALUE;
+    }
+    it->kind = 's';
+    it->s = c->json;
+    it->len = (size_t)len;
+    c->json += len;
+    return LEPT_PARSE_OK;
+}
+
+static int lept_bin_container(lept_item* it, char kind, uint64_t n) {
+    if(n > UINT32_MAX) {
+        return LEPT_PARSE_TOO_LONG;
+    }
+    it->kind = kind;
+    it->len = (size_t)n;
+    return LEPT_PARSE_OK;
+}
+
+/* NaN and infinity have no JSON form */
+static int lept_bin_number(lept_item* it, double d) {
+    uint64_t u;
+    memcpy(&u, &d, sizeof(d));
+    if((u & 0x7FF0000000000000ull) == 0x7FF0000000000000ull) {
+        return LEPT_PARSE_INVALID_VALUE;
+    }
+    it->kind = 'n';
+    it->n = d;
+    return LEPT_PARSE_OK;
+}
+
+static double lept_bin_float(uint64_t u, int w) {
+    if(w == 4) {
+        uint32_t b = (uint32_t)u;
+        float f;
+        memcpy(&f, &b, sizeof(f));
+        return f;
+    } else {
+        double d;
+        memcpy(&d, &u, sizeof(d));
+        return d;
+    }
+}
+
+/* IEEE 754 binary16, widened bit by bit */
+static double lept_half(unsigned h) {
+    unsigned e = (h >> 10) & 31, m = h & 1023;
+    uint64_t u;
+    double d;
+
+    if(e == 0) {
+        d = m / 16777216.0; /* subnormal, m * 2^-24 */
+    } else {
+        u = ((uint64_t)(e == 31 ? 2047 : e - 15 + 1023) << 52) | ((uint64_t)m << 42);
+        memcpy(&d, &u, sizeof(d));
+    }
+    return (h & 0x8000) ? -d : d;
+}
+
+static int lept_literal_item(lept_item* it, lept_type type) {
+    it->kind = 'l';
+    it->type = type;
+    return LEPT_PARSE_OK;
+}
+
+/* the argument of an initial byte, info < 28 */
+static int lept_cbor_arg(lept_context* c, unsigned info, uint64_t* n) {
+    if(info < 24) {
+        *n = info;
+        return LEPT_PARSE_OK;
+    }
+    if(info > 27) {
+        return LEPT_PARSE_INVALID_VALUE; /* reserved */
+    }
+    return lept_bin_read(c, 1 << (info - 24), n);
+}
+
+/* definite chunks of the same major type up to a break, joined */
+static int lept_cbor_chunks(lept_context* c, lept_item* it, unsigned major) {
+    size_t head = c->top;
+    uint64_t n;
+    int ret;
+
+    for(;;) {
+        unsigned char b;
+        if(c->json == c->end) {
+            c->top = head;
+            return LEPT_PARSE_EXPECT_VALUE;
+        }
+        b = (unsigned char)*c->json ++;
+        if(b == 0xFF) {
+            break;
+        }
+        if((b >> 5) != major || (b & 31) == 31) {
+            c->top = head;
+            return LEPT_PARSE_INVALID_VALUE;
+        }
+        if((ret = lept_cbor_arg(c, b & 31, &n)) != LEPT_PARSE_OK ||
+            (ret = lept_bin_string(c, it, n)) != LEPT_PARSE_OK) {
+            c->top = head;
+            return ret;
+        }
+        if(it->len > 0) {
+            memcpy(lept_context_push(c, it->len), it->s, it->len);
+        }
+    }
+    it->kind = 's';
+    it->len = c->top - head;
+    it->s = (it->len > 0) ? (const char*)lept_context_pop(c, it->len) : c->json;
+    return LEPT_PARSE_OK;
+}
+
+static int lept_cbor_item(lept_context* c, lept_item* it) {
+    int tagged = 0;
+
+    for(;;) {
+        unsigned char b;
+        unsigned major, info;
+        uint64_t n = 0;
+        int ret;
+
+        if(c->json == c->end) {
+            return LEPT_PARSE_EXPECT_VALUE;
+        }
+        b = (unsigned char)*c->json ++;
+        major = b >> 5;
+        info = b & 31;
+        if(info == 31) {
+            switch(major) {
+                case 2: case 3: return lept_cbor_chunks(c, it, major);
+                case 4: it->kind = '['; it->len = LEPT_INDEFINITE; return LEPT_PARSE_OK;
+                case 5: it->kind = '{'; it->len = LEPT_INDEFINITE; return LEPT_PARSE_OK;
+                case 7: /* a break ends a container, it is no item for a tag */
+                    if(tagged) {
+                        return LEPT_PARSE_INVALID_VALUE;
+                    }
+                    it->kind = ']';
+                    return LEPT_PARSE_OK;
+                default: return LEPT_PARSE_INVALID_VALUE;
+            }
+        }
+        if((ret = lept_cbor_arg(c, info, &n)) != LEPT_PARSE_OK) {
+            return ret;
+        }
+        switch(major) {
+            case 0: return lept_bin_number(it, (double)n);
+            case 1: return lept_bin_number(it, -1.0 - (double)n);
+            case 2:
+            case 3: return lept_bin_string(c, it, n);
+            case 4: return lept_bin_container(it, '[', n);
+            case 5: return lept_bin_container(it, '{', n);
+            case 6: tagged = 1; continue; /* a tag, the item it applies to follows */
+            default:
+                switch(info) {
+                    case 20: return lept_literal_item(it, LEPT_FALSE);
+                    case 21: return lept_literal_item(it, LEPT_TRUE);
+                    case 22:
+                    case 23: return lept_literal_item(it, LEPT_NULL); /* null, undefined */
+                    case 25: return lept_bin_number(it, lept_half((unsigned)n));
+                    case 26: return lept_bin_number(it, lept_bin_float(n, 4));
+                    case 27: return lept_bin_number(it, lept_bin_float(n, 8));
+                    default: return LEPT_PARSE_INVALID_VALUE; /* other simple values */
+                }
+        }
+    }
+}
+
+static int lept_msgpack_item(lept_context* c, lept_item* it) {
+    unsigned char b;
+    uint64_t n;
+    int ret;
+
+    if(c->json == c->end) {
+        return LEPT_PARSE_EXPECT_VALUE;
+    }
+    b = (unsigned char)*c->json ++;
+    if(b <= 0x7F) {
+        return lept_bin_number(it, b);                   /* positive fixint */
+    } else if(b <= 0x8F) {
+        return lept_bin_container(it, '{', b & 0x0F);    /* fixmap */
+    } else if(b <= 0x9F) {
+        return lept_bin_container(it, '[', b & 0x0F);    /* fixarray */
+    } else if(b <= 0xBF) {
+        return lept_bin_string(c, it, b & 0x1F);         /* fixstr */
+    } else if(b >= 0xE0) {
+        return lept_bin_number(it, (signed char)b);      /* negative fixint */
+    }
+
+    switch(b) {
+        case 0xC0: return lept_literal_item(it, LEPT_NULL);
+        case 0xC2: return lept_literal_item(it, LEPT_FALSE);
+        case 0xC3: return lept_literal_item(it, LEPT_TRUE);
+        default: break;
+    }
+    /* the rest carry 1, 2, 4 or 8 bytes after the type byte */
+    switch(b) {
+        case 0xC4: case 0xCC: case 0xD0: case 0xD9: ret = lept_bin_read(c, 1, &n); break;
+        case 0xC5: case 0xCD: case 0xD1: case 0xDA: case 0xDC: case 0xDE: ret = lept_bin_read(c, 2, &n); break;
+        case 0xC6: case 0xCA: case 0xCE: case 0xD2: case 0xDB: case 0xDD: case 0xDF: ret = lept_bin_read(c, 4, &n); break;
+        case 0xCB: case 0xCF: case 0xD3: ret = lept_bin_read(c, 8, &n); break;
+        default: return LEPT_PARSE_INVALID_VALUE; /* never used, ext */
+    }
+    if(ret != LEPT_PARSE_OK) {
+        return ret;
+    }
+    switch(b) {
+        case 0xC4: case 0xC5: case 0xC6:                     /* bin */
+        case 0xD9: case 0xDA: case 0xDB: return lept_bin_string(c, it, n);
+        case 0xCA: return lept_bin_number(it, lept_bin_float(n, 4));
+        case 0xCB: return lept_bin_number(it, lept_bin_float(n, 8));
+        case 0xCC: case 0xCD: case 0xCE: case 0xCF: return lept_bin_number(it, (double)n);
+        case 0xD0: return lept_bin_number(it, (int8_t)(uint8_t)n);
+        case 0xD1: return lept_bin_number(it, (int16_t)(uint16_t)n);
+        case 0xD2: return lept_bin_number(it, (int32_t)(uint32_t)n);
+        case 0xD3: return lept_bin_number(it, (double)(int64_t)n);
+        case 0xDC: case 0xDD: return lept_bin_container(it, '[', n);
+        default: return lept_bin_container(it, '{', n);     /* 0xDE, 0xDF */
+    }
+}
+
+static int lept_decode_value(lept_context* c, lept_item_fn read) {
+    lept_level* l;
+    lept_item it;
+    int ret, close;
+
+    for(;;) {
+        if((ret = read(c, &it)) != LEPT_PARSE_OK) {
+            return ret;
+        }
+        l = (c->depth > 0) ? &c->levels[c->depth - 1] : NULL;
+        close = 0;
+        if(it.kind == ']') {
+            /* a break ends an indefinite container, between members */
+            if(l == NULL || l->count != LEPT_INDEFINITE || (l->kind == '{' && (l->size & 1))) {
+                return LEPT_PARSE_INVALID_VALUE;
+            }
+            close = 1;
+        } else if(l != NULL && l->kind == '{' && !(l->size & 1)) {
+            if(it.kind != 's') {
+                return LEPT_PARSE_MISS_KEY;
+            }
+            LEPT_SAX_CALL(c, key, (c->user, it.s, it.len));
+            l->size ++;
+            continue;
+        } else if(it.kind == '[' || it.kind == '{') {
+            if((ret = lept_context_open(c, it.kind)) != LEPT_PARSE_OK) {
+                return ret;
+            }
+            l = &c->levels[c->depth - 1];
+            l->count = (it.len == LEPT_INDEFINITE || it.kind == '[') ? it.len : it.len * 2;
+            if(it.kind == '[') {
+                LEPT_SAX_CALL(c, start_array, (c->user));
+            } else {
+                LEPT_SAX_CALL(c, start_object, (c->user));
+            }
+            if(l->count != 0) {
+                continue;
+            }
+            close = 1;
+        } else if(it.kind == 'n') {
+            LEPT_SAX_CALL(c, number, (c->user, it.n));
+        } else if(it.kind == 's') {
+            LEPT_SAX_CALL(c, string, (c->user, it.s, it.len));
+        } else if(it.type == LEPT_NULL) {
+            LEPT_SAX_CALL(c, null, (c->user));
+        } else {
+            LEPT_SAX_CALL(c, boolean, (c->user, it.type == LEPT_TRUE));
+        }
+
+        /* the value is complete, close whatever it completes */
+        for(;;) {
+            if(close) {
+                l = &c->levels[-- c->depth];
+                if(l->kind == '[') {
+                    LEPT_SAX_CALL(c, end_array, (c->user, l->size));
+                } else {
+                    LEPT_SAX_CALL(c, end_object, (c->user, l->size / 2));
+                }
+            }
+            if(c->depth == 0) {
+                return LEPT_PARSE_OK;
+            }
+            l = &c->levels[c->depth - 1];
+            l->size ++;
+            if(!(close = (l->count != LEPT_INDEFINITE && l->size == l->count))) {
+                break;
+            }
+        }
+    }
+}
+
+static int lept_decode(lept_value* v, const char* buf, size_t len, lept_item_fn read) {
+    lept_context c;
+    int ret;
+
+    assert(v != NULL && (buf != NULL || len == 0));
+
+    /* initialize */
+    lept_init(v);
+    lept_context_init(&c, buf, len);
+    c.sax = &lept_dom_handler;
+    c.user = &c;
+
+    ret = lept_decode_value(&c, read);
+    if(ret == LEPT_PARSE_OK && c.json != c.end) {
+        ret = LEPT_PARSE_ROOT_NOT_SINGULAR;
+    }
+    free(c.levels);
+
+    if(ret == LEPT_PARSE_OK) {
+        *v = LEPT_CONTEXT_POP(&c, lept_value);
+    } else {
+        while(c.top > 0) {
+            lept_free((lept_value*)lept_context_pop(&c, sizeof(lept_value)));
+        }
+    }
+    lept_context_free(&c);
+
+    return ret;
+}
+
+int lept_decode_cbor(lept_value* v, const char* buf, size_t len) {
+    return lept_decode(v, buf, len, lept_cbor_item);
+}
+
+int lept_decode_msgpack(lept_value* v, const char* buf, size_t len) {
+    return lept_decode(v, buf, len, lept_msgpack_item);
+}
+
+/* a type byte, then the low w bytes of n big-endian */
+static void lept_bin_put(lept_context* c, unsigned char b, uint64_t n, int w) {
+    unsigned char* p = (unsigned char*)lept_context_push(c, 1 + (size_t)w);
+    p[0] = b;
+    for(int i = w; i > 0; i --) {
+        p[i] = (unsigned char)n;
+        n >>= 8;
+    }
+}
+
+/* 1 if d is a whole number in [-2^63, 2^64), as its magnitude and sign */
+static int lept_bin_integer(double d, uint64_t* mag, int* neg) {
+    uint64_t u;
+
+    memcpy(&u, &d, sizeof(d));
+    if(d >= 0.0 && d < 18446744073709551616.0 && !(u >> 63)) {
+        *mag = (uint64_t)d;
+        *neg = 0;
+        return (double)*mag == d;
+    }
+    if(d < 0.0 && d >= -9223372036854775808.0) {
+        int64_t i = (int64_t)d;
+        *mag = (uint64_t)0 - (uint64_t)i;
+        *neg = 1;
+        return (double)i == d;
+    }
+    return 0; /* -0, too large, NaN */
+}
+
+/* b4 for float32 or b8 for float64 */
+static void lept_bin_put_float(lept_context* c, double d, unsigned char b4, unsigned char b8) {
+    if(d >= -FLT_MAX && d <= FLT_MAX && (double)(float)d == d) {
+        float f = (float)d;
+        uint32_t u;
+        memcpy(&u, &f, sizeof(f));
+        lept_bin_put(c, b4, u, 4);
+    } else {
+        uint64_t u;
+        memcpy(&u, &d, sizeof(d));
+        lept_bin_put(c, b8, u, 8);
+    }
+}
+
+static void lept_cbor_head(lept_context* c, unsigned major, uint64_t n) {
+    unsigned char b = (unsigned char)(major << 5);
+    if(n < 24) {
+        lept_bin_put(c, b | (unsigned char)n, 0, 0);
+    } else if(n <= 0xFF) {
+        lept_bin_put(c, b | 24, n, 1);
+    } else if(n <= 0xFFFF) {
+        lept_bin_put(c, b | 25, n, 2);
+    } else if(n <= 0xFFFFFFFF) {
+        lept_bin_put(c, b | 26, n, 4);
+    } else {
+        lept_bin_put(c, b | 27, n, 8);
+    }
+}
+
+static void lept_cbor_string(lept_context* c, const char* s, size_t len) {
+    lept_cbor_head(c, 3, len);
+    if(len > 0) {
+        PUTRAWS(c, s, len);
+    }
+}
+
+static int lept_cbor_encode(lept_context* c, const lept_value* v) {
+    uint64_t mag;
+    int neg;
+
+    switch(v->type) {
+        case LEPT_NULL:  PUTC(c, (char)0xF6); break;
+        case LEPT_FALSE: PUTC(c, (char)0xF4); break;
+        case LEPT_TRUE:  PUTC(c, (char)0xF5); break;
+        case LEPT_NUMBER:
+            if(lept_bin_integer(v->n, &mag, &neg)) {
+                lept_cbor_head(c, neg, neg ? mag - 1 : mag);
+            } else {
+                lept_bin_put_float(c, v->n, 0xFA, 0xFB);
+            }
+            break;
+        case LEPT_STRING: lept_cbor_string(c, LEPT_STRING_PTR(v), LEPT_STRING_LEN(v)); break;
+        case LEPT_ARRAY:
+            lept_cbor_head(c, 4, v->size);
+            for(size_t i = 0; i < v->size; i ++) {
+                lept_cbor_encode(c, &v->e[i]);
+            }
+            break;
+        case LEPT_OBJECT:
+            lept_cbor_head(c, 5, v->size);
+            for(size_t i = 0; i < v->size; i ++) {
+                lept_cbor_string(c, LEPT_STRING_PTR(&v->m[i].k), LEPT_STRING_LEN(&v->m[i].k));
+                lept_cbor_encode(c, &v->m[i].v);
+            }
+            break;
+        default: return LEPT_STRINGIFY_UNKNOWN_TYPE;
+    }
+    return LEPT_STRINGIFY_OK;
+}
+
+/* fix is the one-byte form for n < limit, then 16 and 32 bit forms, or 8 bit first if b8 */
+static void lept_msgpack_head(lept_context* c, unsigned char fix, size_t limit,
+    unsigned char b8, unsigned char b16, uint64_t n) {
+    if(n < limit) {
+        lept_bin_put(c, fix | (unsigned char)n, 0, 0);
+    } else if(b8 != 0 && n <= 0xFF) {
+        lept_bin_put(c, b8, n, 1);
+    } else if(n <= 0xFFFF) {
+        lept_bin_put(c, b16, n, 2);
+    } else {
+        lept_bin_put(c, b16 + 1, n, 4);
+    }
+}
+
+static void lept_msgpack_string(lept_context* c, const char* s, size_t len) {
+    lept_msgpack_head(c, 0xA0, 32, 0xD9, 0xDA, len);
+    if(len > 0) {
+        PUTRAWS(c, s, len);
+    }
+}
+
+static void lept_msgpack_integer(lept_context* c, uint64_t mag, int neg) {
+    if(!neg) {
+        if(mag < 0x80) {
+            lept_bin_put(c, (unsigned char)mag, 0, 0);
+        } else {
+            lept_bin_put(c, mag <= 0xFF ? 0xCC : mag <= 0xFFFF ? 0xCD : mag <= 0xFFFFFFFF ? 0xCE : 0xCF, mag,
+                mag <= 0xFF ? 1 : mag <= 0xFFFF ? 2 : mag <= 0xFFFFFFFF ? 4 : 8);
+        }
+    } else {
+        /* two's complement, only the low bytes are written */
+        uint64_t n = (uint64_t)0 - mag;
+        if(mag <= 32) {
+            lept_bin_put(c, (unsigned char)n, 0, 0);
+        } else if(mag <= 0x80) {
+            lept_bin_put(c, 0xD0, n, 1);
+        } else if(mag <= 0x8000) {
+            lept_bin_put(c, 0xD1, n, 2);
+        } else if(mag <= 0x80000000) {
+            lept_bin_put(c, 0xD2, n, 4);
+        } else {
+            lept_bin_put(c, 0xD3, n, 8);
+        }
+    }
+}
+
+static int lept_msgpack_encode(lept_context* c, const lept_value* v) {
+    uint64_t mag;
+    int neg;
+
+    switch(v->type) {
+        case LEPT_NULL:  PUTC(c, (char)0xC0); break;
+        case LEPT_FALSE: PUTC(c, (char)0xC2); break;
+        case LEPT_TRUE:  PUTC(c, (char)0xC3); break;
+        case LEPT_NUMBER:
+            if(lept_bin_integer(v->n, &mag, &neg)) {
+                lept_msgpack_integer(c, mag, neg);
+            } else {
+                lept_bin_put_float(c, v->n, 0xCA, 0xCB);
+            }
+            break;
+        case LEPT_STRING: lept_msgpack_string(c, LEPT_STRING_PTR(v), LEPT_STRING_LEN(v)); break;
+        case LEPT_ARRAY:
+            lept_msgpack_head(c, 0x90, 16, 0, 0xDC, v->size);
+            for(size_t i = 0; i < v->size; i ++) {
+                lept_msgpack_encode(c, &v->e[i]);
+            }
+            break;
+        case LEPT_OBJECT:
+            lept_msgpack_head(c, 0x80, 16, 0, 0xDE, v->size);
+            for(size_t i = 0; i < v->size; i ++) {
+                lept_msgpack_string(c, LEPT_STRING_PTR(&v->m[i].k), LEPT_STRING_LEN(&v->m[i].k));
+                lept_msgpack_encode(c, &v->m[i].v);
+            }
+            break;
+        default: return LEPT_STRINGIFY_UNKNOWN_TYPE;
+    }
+    return LEPT_STRINGIFY_OK;
+}
+
+static int lept_encode(const lept_value* v, char** buf, size_t* len, int (*encode)(lept_context*, const lept_value*)) {
+    lept_context c;
+    int ret;
+
+    assert(v != NULL); assert(buf != NULL);
+
+    lept_context_init(&c, NULL, 0);
+    ret = encode(&c, v);
+    if(ret != LEPT_STRINGIFY_OK) {
+        c.top = 0;
+        lept_context_free(&c);
+        *buf = NULL;
+    } else {
+        if(len != NULL) {
+            *len = c.top;
+        }
+        *buf = c.stack;
+    }
+
+    return ret;
+}
+
+int lept_encode_cbor(const lept_value* v, char** buf, size_t* len) {
+    return lept_encode(v, buf, len, lept_cbor_encode);
+}
+
+int lept_encode_msgpack(const lept_value* v, char** buf, size_t* len) {
+    return lept_encode(v, buf, len, lept_msgpack_encode);
+}
+
+/* snapshot
+ *
+ * The file is a header holding the root node, then blocks of nodes and
+ * text laid out depth first, each block 8-byte aligned. A node is the
+ * number or the offset of its payload: a string's text and '\0', unless
+ * short enough to sit in the node instead, an array's elements, or an
+ * object's key and value nodes, followed for
+ * objects of LEPT_OBJECT_HASH_MIN members or more by the same hash table
+ * a lept_value object builds, filled in when written.
+ */
+
+#define LEPT_SNAPSHOT_MAGIC "LEPTSNAP"
+#define LEPT_SNAPSHOT_VERSION 1
+#define LEPT_SNAPSHOT_ORDER 0x01020304u /* reads differently in another byte order */
+
+#define LEPT_SNAP_INLINE_MAX 7
+
+typedef struct {
+    union {
+        double n;    /* number */
+        uint64_t at; /* offset of the text, elements or members */
+        char small[LEPT_SNAP_INLINE_MAX + 1]; /* a short string and its '\0' */
+    };
+    uint32_t size;   /* string length, array or object size */
+    unsigned char type;  /* lept_type */
+    unsigned char flags; /* LEPT_INLINE */
+    unsigned char spare[2];
+} lept_snap_node;
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t order;
+    uint64_t size;   /* of the file */
+    lept_snap_node root;
+} lept_snap_header;
+
+struct lept_snapshot {
+    const char* base;
+    size_t len;
+};
+
+/* a zeroed block at the end of the file, its offset */
+static uint64_t lept_snap_alloc(lept_context* c, size_t len) {
+    size_t at = c->top;
+    len = (len + 7) & ~(size_t)7;
+    memset(lept_context_push(c, len), 0, len);
+    return at;
+}
+
+/* the payload of v, then its node at offset at */
+static void lept_snap_put(lept_context* c, uint64_t at, const lept_value* v) {
+    lept_snap_node n;
+
+    memset(&n, 0, sizeof(n));
+    n.type = v->type;
+    switch(v->type) {
+        case LEPT_NUMBER: n.n = v->n; break;
+        case LEPT_STRING:
+            n.size = (uint32_t)LEPT_STRING_LEN(v);
+            if(n.size <= LEPT_SNAP_INLINE_MAX) {
+                memcpy(n.small, LEPT_STRING_PTR(v), n.size);
+                n.flags = LEPT_INLINE;
+            } else {
+                n.at = lept_snap_alloc(c, n.size + 1);
+                memcpy(c->stack + n.at, LEPT_STRING_PTR(v), n.size);
+            }
+            break;
+        case LEPT_ARRAY:
+            n.size = v->size;
+            if(n.size > 0) {
+                n.at = lept_snap_alloc(c, n.size * sizeof(lept_snap_node));
+                for(size_t i = 0; i < n.size; i ++) {
+                    lept_snap_put(c, n.at + i * sizeof(lept_snap_node), &v->e[i]);
+                }
+            }
+            break;
+        case LEPT_OBJECT: {
+            size_t slots = lept_object_slots(v->size), mask = slots - 1;
+            n.size = v->size;
+            if(n.size > 0) {
+                n.at = lept_snap_alloc(c, n.size * 2 * sizeof(lept_snap_node) + slots * sizeof(uint32_t));
+                for(size_t i = 0; i < n.size; i ++) {
+                    lept_snap_put(c, n.at + (2 * i) * sizeof(lept_snap_node), &v->m[i].k);
+                    lept_snap_put(c, n.at + (2 * i + 1) * sizeof(lept_snap_node), &v->m[i].v);
+                }
+            }
+            for(size_t i = 0; i < (slots > 0 ? n.size : 0); i ++) {
+                uint32_t* t = (uint32_t*)(void*)(c->stack + n.at + n.size * 2 * sizeof(lept_snap_node));
+                const lept_value* k = &v->m[i].k;
+                size_t j = lept_hash_key(LEPT_STRING_PTR(k), LEPT_STRING_LEN(k)) & mask;
+                while(t[j] != 0) {
+                    j = (j + 1) & mask;
+                }
+                t[j] = (uint32_t)(i + 1);
+            }
+            break;
+        }
+        default: break;
+    }
+    memcpy(c->stack + at, &n, sizeof(n));
+}
+
+int lept_snapshot_write(const lept_value* v, const char* path) {
+    lept_context c;
+    lept_snap_header* h;
+    FILE* fp;
+    int ret = LEPT_STRINGIFY_WRITE_FAILED;
+
+    assert(v != NULL && path != NULL);
+
+    lept_context_init(&c, NULL, 0);
+    lept_snap_alloc(&c, sizeof(lept_snap_header));
+    lept_snap_put(&c, offsetof(lept_snap_header, root), v);
+    h = (lept_snap_header*)(void*)c.stack;
+    memcpy(h->magic, LEPT_SNAPSHOT_MAGIC, sizeof(h->magic));
+    h->version = LEPT_SNAPSHOT_VERSION;
+    h->order = LEPT_SNAPSHOT_ORDER;
+    h->size = c.top;
+
+    if((fp = fopen(path, "wb")) != NULL) {
+        if(fwrite(c.stack, 1, c.top, fp) == c.top) {
+            ret = LEPT_STRINGIFY_OK;
+        }
+        if(fclose(fp) != 0) {
+            ret = LEPT_STRINGIFY_WRITE_FAILED;
+        }
+    }
+    c.top = 0;
+    lept_context_free(&c);
+
+    return ret;
+}
+
+static void lept_snapshot_unmap(const char* base, size_t len) {
+#ifdef _WIN32
+    (void)len;
+    UnmapViewOfFile(base);
+#else
+    munmap((void*)base, len);
+#endif
+}
+
+lept_snapshot* lept_snapshot_open(const char* path) {
+    const char* base = NULL;
+    size_t len = 0;
+    const lept_snap_header* h;
+    lept_snapshot* s;
+
+    assert(path != NULL);
+
+#ifdef _WIN32
+    HANDLE file, map;
+    LARGE_INTEGER size;
+    file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if(file == INVALID_HANDLE_VALUE) {
+        return NULL;
+    }
+    if(GetFileSizeEx(file, &size) && (uint64_t)size.QuadPart >= sizeof(lept_snap_header) && (uint64_t)size.QuadPart <= SIZE_MAX) {
+        len = (size_t)size.QuadPart;
+        if((map = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL)) != NULL) {
+            base = (const char*)MapViewOfFile(map, FILE_MAP_READ, 0, 0, len);
+            CloseHandle(map);
+        }
+    }
+    CloseHandle(file);
+#else
+    struct stat st;
+    int fd = open(path, O_RDONLY);
+    if(fd < 0) {
+        return NULL;
+    }
+    if(fstat(fd, &st) == 0 && (uint64_t)st.st_size >= sizeof(lept_snap_header) && (uint64_t)st.st_size <= SIZE_MAX) {
+        void* p;
+        len = (size_t)st.st_size;
+        if((p = mmap(NULL, len, PROT_READ, MAP_SHARED, fd, 0)) != MAP_FAILED) {
+            base = (const char*)p;
+        }
+    }
+    close(fd);
+#endif
+    if(base == NULL) {
+        return NULL;
+    }
+
+    h = (const lept_snap_header*)(const void*)base;
+    if(memcmp(h->magic, LEPT_SNAPSHOT_MAGIC, sizeof(h->magic)) != 0 || h->version != LEPT_SNAPSHOT_VERSION ||
+        h->order != LEPT_SNAPSHOT_ORDER || h->size != len) {
+        lept_snapshot_unmap(base, len);
+        return NULL;
+    }
+    s = (lept_snapshot*)malloc(sizeof(lept_snapshot));
+    s->base = base;
+    s->len = len;
+    return s;
+}
+
+void lept_snapshot_close(lept_snapshot* s) {
+    if(s != NULL) {
+        lept_snapshot_unmap(s->base, s->len);
+        free(s);
+    }
+}
+
+lept_view lept_snapshot_root(const lept_snapshot* s) {
+    lept_view v;
+    assert(s != NULL);
+    v.base = s->base;
+    v.at = offsetof(lept_snap_header, root);
+    return v;
+}
+
+#define LEPT_VIEW_NODE(v) ((const lept_snap_node*)(const void*)((v).base + (v).at))
+#define LEPT_VIEW_TEXT(base, n) (((n)->flags & LEPT_INLINE) ? (n)->small : (base) + (n)->at)
+
+static lept_view lept_view_at(lept_view v, uint64_t at) {
+    v.at = (size_t)at;
+    return v;
+}
+
+lept_type lept_view_get_type(lept_view v) {
+    assert(v.base != NULL);
+    return (lept_type)LEPT_VIEW_NODE(v)->type;
+}
+
+int lept_view_get_boolean(lept_view v) {
+    assert(v.base != NULL && (LEPT_VIEW_NODE(v)->type == LEPT_TRUE || LEPT_VIEW_NODE(v)->type == LEPT_FALSE));
+    return LEPT_VIEW_NODE(v)->type == LEPT_TRUE;
 }
 
-void lept_set_string(lept_value* v, const char* s, size_t len) {
-    assert(v != NULL && (s != NULL || len != 0));
-    lept_free(v);
-    v->string.s = (char*)malloc((len + 1) * sizeof(char));
-    memcpy(v->string.s, s, len);
-    v->string.s[len] = '\0';
-    v->string.len = len;
-    v->type = LEPT_STRING;
+double lept_view_get_number(lept_view v) {
+    assert(v.base != NULL && LEPT_VIEW_NODE(v)->type == LEPT_NUMBER);
+    return LEPT_VIEW_NODE(v)->n;
+}
+
+const char* lept_view_get_string(lept_view v) {
+    assert(v.base != NULL && LEPT_VIEW_NODE(v)->type == LEPT_STRING);
+    return LEPT_VIEW_TEXT(v.base, LEPT_VIEW_NODE(v));
+}
+
+size_t lept_view_get_string_length(lept_view v) {
+    assert(v.base != NULL && LEPT_VIEW_NODE(v)->type == LEPT_STRING);
+    return LEPT_VIEW_NODE(v)->size;
+}
+
+size_t lept_view_get_array_size(lept_view v) {
+    assert(v.base != NULL && LEPT_VIEW_NODE(v)->type == LEPT_ARRAY);
+    return LEPT_VIEW_NODE(v)->size;
+}
+
+lept_view lept_view_get_array_element(lept_view v, size_t index) {
+    assert(v.base != NULL && LEPT_VIEW_NODE(v)->type == LEPT_ARRAY);
+    assert(index < LEPT_VIEW_NODE(v)->size);
+    return lept_view_at(v, LEPT_VIEW_NODE(v)->at + index * sizeof(lept_snap_node));
+}
+
+size_t lept_view_get_object_size(lept_view v) {
+    assert(v.base != NULL && LEPT_VIEW_NODE(v)->type == LEPT_OBJECT);
+    return LEPT_VIEW_NODE(v)->size;
+}
+
+static lept_view lept_view_key(lept_view v, size_t index) {
+    assert(v.base != NULL && LEPT_VIEW_NODE(v)->type == LEPT_OBJECT);
+    assert(index < LEPT_VIEW_NODE(v)->size);
+    return lept_view_at(v, LEPT_VIEW_NODE(v)->at + 2 * index * sizeof(lept_snap_node));
+}
+
+const char* lept_view_get_object_key(lept_view v, size_t index) {
+    return lept_view_get_string(lept_view_key(v, index));
+}
+
+size_t lept_view_get_object_key_length(lept_view v, size_t index) {
+    return lept_view_get_string_length(lept_view_key(v, index));
+}
+
+lept_view lept_view_get_object_value(lept_view v, size_t index) {
+    lept_view k = lept_view_key(v, index);
+    return lept_view_at(k, k.at + sizeof(lept_snap_node));
+}
+
+static int lept_view_key_eq(lept_view v, size_t index, const char* key, size_t klen) {
+    const lept_snap_node* k = LEPT_VIEW_NODE(lept_view_key(v, index));
+    return k->size == klen && memcmp(LEPT_VIEW_TEXT(v.base, k), key, klen) == 0;
+}
+
+size_t lept_view_find_object_index(lept_view v, const char* key, size_t klen) {
+    const lept_snap_node* n;
+    size_t mask;
+    const uint32_t* slots;
+
+    assert(v.base != NULL && LEPT_VIEW_NODE(v)->type == LEPT_OBJECT && (key != NULL || klen == 0));
+
+    n = LEPT_VIEW_NODE(v);
+    if(n->size < LEPT_OBJECT_HASH_MIN) {
+        for(size_t i = 0; i < n->size; i ++) {
+            if(lept_view_key_eq(v, i, key, klen)) {
+                return i;
+            }
+        }
+        return LEPT_KEY_NOT_EXIST;
+    }
+
+    mask = lept_object_slots(n->size) - 1;
+    slots = (const uint32_t*)(const void*)(v.base + n->at + n->size * 2 * sizeof(lept_snap_node));
+    for(size_t j = lept_hash_key(key, klen) & mask; slots[j] != 0; j = (j + 1) & mask) {
+        if(lept_view_key_eq(v, slots[j] - 1, key, klen)) {
+            return slots[j] - 1;
+        }
+    }
+    return LEPT_KEY_NOT_EXIST;
+}
+
+lept_view lept_view_find_object_value(lept_view v, const char* key, size_t klen) {
+    size_t index = lept_view_find_object_index(v, key, klen);
+    if(index == LEPT_KEY_NOT_EXIST) {
+        v.base = NULL;
+        v.at = 0;
+        return v;
+    }
+    return lept_view_get_object_value(v, index);
+}
+
+/* lazy
+ *
+ * A cursor is the position of a value in the text. Containers are stepped
+ * over a 64-byte block at a time with the classifier of the structural
+ * index, counting only brackets outside strings; strings with
+ * lept_scan_string(). Literals are checked when a cursor lands on them,
+ * numbers and strings when they are read.
+ */
+
+/* past the bracket matching the one at p, NULL if the input ends first */
+static const char* lept_lazy_skip_container(const char* p, const char* end) {
+    uint64_t in_string = 0, escaped_next = 0;
+    size_t depth = 0;
+
+    for(const char* b = p; b < end; b += 64) {
+        lept_block_masks m;
+        uint64_t quote, str, ops;
+
+        if(end - b >= 64) {
+            lept_classify(b, &m);
+        } else {
+            char tail[64];
+            memset(tail, ' ', sizeof(tail));
+            memcpy(tail, b, end - b);
+            lept_classify(tail, &m);
+        }
+        quote = lept_block_quotes(&m, &escaped_next);
+        str = lept_prefix_xor(quote) ^ in_string;
+        in_string = (uint64_t)0 - (str >> 63);
+
+        /* brackets, commas and colons outside strings */
+        for(ops = m.op & ~str; ops != 0; ops &= ops - 1) {
+            int i = lept_ctz64(ops);
+            if(b[i] == '[' || b[i] == '{') {
+                depth ++;
+            } else if((b[i] == ']' || b[i] == '}') && -- depth == 0) {
+                return b + i + 1;
+            }
+        }
+    }
+    return NULL;
+}
+
+/* *q past the value at p, without looking inside it */
+static int lept_lazy_skip(const char* p, const char* end, const char** q) {
+    switch(*p) {
+        case '\"':
+            for(p ++;;) {
+                p = lept_scan_string(p, end);
+                if(p == end) {
+                    return LEPT_PARSE_MISS_QUOTATION_MARK;
+                }
+                if(*p == '\"') {
+                    *q = p + 1;
+                    return LEPT_PARSE_OK;
+                }
+                p += (*p == '\\' && p + 1 < end) ? 2 : 1;
+            }
+        case '[':
+        case '{':
+            if((*q = lept_lazy_skip_container(p, end)) == NULL) {
+                return (*p == '[') ? LEPT_PARSE_INVALID_VALUE : LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET;
+            }
+            return LEPT_PARSE_OK;
+        default:
+            while(p < end && !LEPT_ISWS(*p) && *p != ',' && *p != ']' && *p != '}') {
+                p ++;
+            }
+            *q = p;
+            return LEPT_PARSE_OK;
+    }
+}
+
+static const char* lept_lazy_ws(const char* p, const char* end) {
+    return (p < end && LEPT_ISWS(*p)) ? lept_skip_whitespace(p, end) : p;
+}
+
+static int lept_lazy_literal(const char* p, const char* end, const char* literal, size_t len) {
+    return ((size_t)(end - p) >= len && memcmp(p, literal, len) == 0) ? LEPT_PARSE_OK : LEPT_PARSE_INVALID_VALUE;
+}
+
+/* v at the value starting at p */
+static int lept_lazy_at(lept_lazy* v, const char* p, const char* end) {
+    v->json = p;
+    v->end = end;
+    v->it = NULL;
+    if(p == end) {
+        return LEPT_PARSE_EXPECT_VALUE;
+    }
+    switch(*p) {
+        case 'n': return lept_lazy_literal(p, end, "null", 4);
+        case 't': return lept_lazy_literal(p, end, "true", 4);
+        case 'f': return lept_lazy_literal(p, end, "false", 5);
+        case '\"': case '[': case '{': case '-': return LEPT_PARSE_OK;
+        default: return LEPT_ISDIGIT(*p) ? LEPT_PARSE_OK : LEPT_PARSE_INVALID_VALUE;
+    }
+}
+
+int lept_lazy_init(lept_lazy* v, const char* json, size_t len) {
+    assert(v != NULL && (json != NULL || len == 0));
+    lept_scan_init();
+    return lept_lazy_at(v, lept_lazy_ws(json, json + len), json + len);
+}
+
+lept_type lept_lazy_get_type(const lept_lazy* v) {
+    assert(v != NULL && v->json < v->end);
+    switch(*v->json) {
+        case 'n': return LEPT_NULL;
+        case 't': return LEPT_TRUE;
+        case 'f': return LEPT_FALSE;
+        case '\"': return LEPT_STRING;
+        case '[': return LEPT_ARRAY;
+        case '{': return LEPT_OBJECT;
+        default: return LEPT_NUMBER;
+    }
+}
+
+static int lept_lazy_number(void* user, double d) {
+    *(double*)user = d;
+    return 0;
+}
+
+static const lept_sax_handler lept_lazy_number_handler = {
+    NULL, NULL, lept_lazy_number, NULL, NULL, NULL, NULL, NULL, NULL
+};
+
+int lept_lazy_get_number(const lept_lazy* v, double* d) {
+    lept_context c;
+    int ret;
+
+    assert(v != NULL && d != NULL && lept_lazy_get_type(v) == LEPT_NUMBER);
+
+    lept_context_init(&c, v->json, v->end - v->json);
+    c.sax = &lept_lazy_number_handler;
+    c.user = d;
+    ret = lept_parse_number(&c);
+    /* "1x" is one bad token, as lept_parse() sees it */
+    if(ret == LEPT_PARSE_OK && c.json < c.end && !LEPT_ISWS(*c.json) &&
+        *c.json != ',' && *c.json != ']' && *c.json != '}') {
+        ret = LEPT_PARSE_INVALID_VALUE;
+    }
+    lept_context_free(&c);
+
+    return ret;
+}
+
+int lept_lazy_get_string(const lept_lazy* v, char** s, size_t* len) {
+    lept_context c;
+    char* str = NULL;
+    size_t n = 0;
+    int ret;
+
+    assert(v != NULL && s != NULL && lept_lazy_get_type(v) == LEPT_STRING);
+
+    lept_context_init(&c, v->json, v->end - v->json);
+    if((ret = lept_parse_string_raw(&c, &str, &n)) == LEPT_PARSE_OK) {
+        *s = (char*)malloc(n + 1);
+        memcpy(*s, str, n);
+        (*s)[n] = '\0';
+        if(len != NULL) {
+            *len = n;
+        }
+    }
+    lept_context_free(&c);
+
+    return ret;
+}
+
+int lept_lazy_get_value(const lept_lazy* v, lept_value* value) {
+    const char* q;
+    int ret;
+
+    assert(v != NULL && value != NULL);
+
+    if((ret = lept_lazy_skip(v->json, v->end, &q)) != LEPT_PARSE_OK) {
+        lept_init(value);
+        return ret;
+    }
+    return lept_parse_n(value, v->json, q - v->json);
+}
+
+/* the start of the element or member after the one at it, or of the first
+ * if it is NULL; LEPT_LAZY_END with it at the closing bracket */
+static int lept_lazy_next(lept_lazy* v, const char** p, char close, int miss) {
+    const char* q;
+    int ret;
+
+    if(v->it == NULL) {
+        q = lept_lazy_ws(v->json + 1, v->end);
+        if(q < v->end && *q == close) {
+            v->it = q;
+            return LEPT_LAZY_END;
+        }
+    } else if(*v->it == close) {
+        return LEPT_LAZY_END;
+    } else {
+        if((ret = lept_lazy_skip(v->it, v->end, &q)) != LEPT_PARSE_OK) {
+            return ret;
+        }
+        q = lept_lazy_ws(q, v->end);
+        if(q < v->end && *q == ',') {
+            q = lept_lazy_ws(q + 1, v->end);
+        } else if(q < v->end && *q == close) {
+            v->it = q;
+            return LEPT_LAZY_END;
+        } else {
+            return miss;
+        }
+    }
+    *p = q;
+    return LEPT_PARSE_OK;
+}
+
+int lept_lazy_next_element(lept_lazy* array, lept_lazy* element) {
+    const char* p;
+    int ret;
+
+    assert(array != NULL && element != NULL && lept_lazy_get_type(array) == LEPT_ARRAY);
+
+    if((ret = lept_lazy_next(array, &p, ']', LEPT_PARSE_INVALID_VALUE)) != LEPT_PARSE_OK ||
+        (ret = lept_lazy_at(element, p, array->end)) != LEPT_PARSE_OK) {
+        return ret;
+    }
+    array->it = p;
+    return LEPT_PARSE_OK;
+}
+
+/* the raw key [k, kend), quotes included, is key */
+static int lept_lazy_key_eq(const char* k, const char* kend, const char* key, size_t klen, int* eq) {
+    lept_context c;
+    char* s;
+    size_t len;
+    int ret;
+
+    if(memchr(k + 1, '\\', kend - k - 2) == NULL) {
+        *eq = ((size_t)(kend - k - 2) == klen && memcmp(k + 1, key, klen) == 0);
+        return LEPT_PARSE_OK;
+    }
+    /* escapes are decoded first */
+    lept_context_init(&c, k, kend - k);
+    if((ret = lept_parse_string_raw(&c, &s, &len)) == LEPT_PARSE_OK) {
+        *eq = (len == klen && memcmp(s, key, klen) == 0);
+    }
+    lept_context_free(&c);
+    return ret;
+}
+
+int lept_lazy_find_field(lept_lazy* object, const char* key, size_t klen, lept_lazy* value) {
+    const char* start = object->it; /* where the last search stopped */
+    const char *p, *kend;
+    int ret, eq, wrapped = 0;
+
+    assert(object != NULL && value != NULL && lept_lazy_get_type(object) == LEPT_OBJECT);
+    assert(key != NULL || klen == 0);
+
+    for(;;) {
+        ret = lept_lazy_next(object, &p, '}', LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET);
+        if(ret == LEPT_LAZY_END && start != NULL && !wrapped) {
+            /* once more from the first member */
+            wrapped = 1;
+            object->it = NULL;
+            continue;
+        }
+        if(ret != LEPT_PARSE_OK) {
+            return ret;
+        }
+
+        if(*p != '\"') {
+            return LEPT_PARSE_MISS_KEY;
+        }
+        if((ret = lept_lazy_skip(p, object->end, &kend)) != LEPT_PARSE_OK) {
+            return ret;
+        }
+        if((ret = lept_lazy_key_eq(p, kend, key, klen, &eq)) != LEPT_PARSE_OK) {
+            return ret;
+        }
+        p = lept_lazy_ws(kend, object->end);
+        if(p == object->end || *p != ':') {
+            return LEPT_PARSE_MISS_COLON;
+        }
+        p = lept_lazy_ws(p + 1, object->end);
+        if((ret = lept_lazy_at(value, p, object->end)) != LEPT_PARSE_OK) {
+            return ret;
+        }
+        object->it = p;
+        if(eq) {
+            return LEPT_PARSE_OK;
+        }
+        if(wrapped && p == start) {
+            return LEPT_LAZY_END;
+        }
+    }
 }
 
-/* boolean */
+/* query
+ *
+ * A query compiles to an array of steps, keys decoded and hashed up front.
+ * Evaluation applies step i to a value, feeding each child it selects to
+ * step i + 1; a ".." step is also applied again to every child, so it
+ * reaches the value and all its descendants in document order.
+ */
 
-int lept_get_boolean(const lept_value* v) {
-    assert(v != NULL && (v->type == LEPT_TRUE || v->type == LEPT_FALSE));
-    return v->type == LEPT_TRUE;
-}
+#define LEPT_QUERY_INT_MAX 9007199254740991LL /* 2^53 - 1, as in RFC 9535 */
 
-void lept_set_boolean(lept_value* v, int b) {
-    lept_free(v);
-    v->type = (b == 0) ? LEPT_FALSE : LEPT_TRUE;
-}
+typedef enum {
+    LEPT_STEP_TOKEN, /* pointer: a member, or an element if the token is an index */
+    LEPT_STEP_KEY,   /* a member */
+    LEPT_STEP_INDEX, /* an element, counted from the end if negative */
+    LEPT_STEP_ALL,   /* every element or member value */
+    LEPT_STEP_SLICE  /* [start:end:step] */
+} lept_step_kind;
 
-/* number */
+typedef struct {
+    lept_step_kind kind;
+    int descend;          /* "..": the value and everything in it */
+    char* key;            /* TOKEN, KEY */
+    size_t klen;
+    uint32_t hash;
+    long long index;      /* INDEX, TOKEN (-1: not an index), SLICE start */
+    long long end, step;  /* SLICE */
+    int has_start, has_end;
+} lept_step;
+
+struct lept_query {
+    lept_step* steps;
+    size_t n, cap;
+};
+
+static lept_step* lept_query_push(lept_query* q, lept_step_kind kind, int descend) {
+    lept_step* s;
+    if(q->n == q->cap) {
+        q->cap = q->cap ? q->cap * 2 : 4;
+        q->steps = (lept_step*)realloc(q->steps, q->cap * sizeof(lept_step));
+    }
+    s = &q->steps[q->n ++];
+    memset(s, 0, sizeof(*s));
+    s->kind = kind;
+    s->descend = descend;
+    return s;
+}
 
-double lept_get_number(const lept_value* v) {
-    assert(v != NULL && v->type == LEPT_NUMBER);
-    return v->number.v;
+/* a key step takes over the decoded key in [c->stack, c->stack + c->top) */
+static void lept_query_key(lept_step* s, lept_context* c) {
+    s->klen = c->top;
+    s->key = (char*)malloc(s->klen + 1);
+    if(s->klen > 0) {
+        memcpy(s->key, c->stack, s->klen);
+    }
+    s->key[s->klen] = '\0';
+    s->hash = lept_hash_key(s->key, s->klen);
+    c->top = 0;
 }
 
-void lept_set_number(lept_value* v, double d) {
-    lept_free(v);
-    v->number.v = d;
-    v->type = LEPT_NUMBER;
+/* RFC 6901: "/a~1b/0", "~0" for '~' and "~1" for '/' */
+static int lept_query_pointer(lept_query* q, lept_context* c, const char* p, const char* end) {
+    while(p < end) {
+        lept_step* s = lept_query_push(q, LEPT_STEP_TOKEN, 0);
+        assert(*p == '/');
+        for(p ++; p < end && *p != '/'; p ++) {
+            if(*p == '~') {
+                if(p + 1 == end || (p[1] != '0' && p[1] != '1')) {
+                    return 0;
+                }
+                PUTC(c, (*++ p == '0') ? '~' : '/');
+            } else {
+                PUTC(c, *p);
+            }
+        }
+        lept_query_key(s, c);
+        /* "0" or no leading zero, anything else is only a key */
+        s->index = -1;
+        if(s->klen > 0 && s->klen <= 15 && (s->key[0] != '0' || s->klen == 1)) {
+            size_t i;
+            long long n = 0;
+            for(i = 0; i < s->klen && LEPT_ISDIGIT(s->key[i]); i ++) {
+                n = n * 10 + (s->key[i] - '0');
+            }
+            if(i == s->klen) {
+                s->index = n;
+            }
+        }
+    }
+    return 1;
 }
 
-/* array */
+/* "0", or an optional '-' and digits without a leading zero */
+static const char* lept_query_int(const char* p, const char* end, long long* n) {
+    int neg = 0;
+    *n = 0;
+    if(p < end && *p == '-') {
+        neg = 1;
+        p ++;
+    }
+    if(p == end || !LEPT_ISDIGIT(*p) || (*p == '0' && (neg || (p + 1 < end && LEPT_ISDIGIT(p[1]))))) {
+        return NULL;
+    }
+    for(; p < end && LEPT_ISDIGIT(*p); p ++) {
+        *n = *n * 10 + (*p - '0');
+        if(*n > LEPT_QUERY_INT_MAX) {
+            return NULL;
+        }
+    }
+    if(neg) {
+        *n = -*n;
+    }
+    return p;
+}
 
-size_t lept_get_array_size(const lept_value* v) {
-    assert(v != NULL && v->type == LEPT_ARRAY);
-    return v->array.size;
+static const char* lept_query_ws(const char* p, const char* end) {
+    while(p < end && LEPT_ISWS(*p)) {
+        p ++;
+    }
+    return p;
 }
 
-lept_value* lept_get_array_element(const lept_value* v, size_t index) {
-    assert(v != NULL && v->type == LEPT_ARRAY);
-    assert(index < v->array.size);
-    return &(v->array.e[index]);
+/* 'name' or "name", with JSON escapes plus \' */
+static const char* lept_query_string(lept_context* c, const char* p, const char* end) {
+    char quote = *p ++;
+    while(p < end && *p != quote) {
+        if((unsigned char)*p < 0x20) {
+            return NULL;
+        }
+        if(*p == '\\') {
+            char buf[4];
+            size_t n;
+            int ret;
+            if(p + 1 < end && p[1] == '\'') {
+                PUTC(c, '\'');
+                p += 2;
+                continue;
+            }
+            if((p = lept_parse_escape(p + 1, end, buf, &n, &ret)) == NULL) {
+                return NULL;
+            }
+            memcpy(lept_context_push(c, n), buf, n);
+        } else {
+            PUTC(c, *p ++);
+        }
+    }
+    return (p < end) ? p + 1 : NULL;
 }
 
-/* object */
+/* the inside of [...], up to and past the ']' */
+static const char* lept_query_bracket(lept_query* q, lept_context* c, const char* p, const char* end, int descend) {
+    lept_step* s;
+    long long n;
 
-size_t lept_get_object_size(const lept_value* v) {
-    assert(v != NULL && v->type == LEPT_OBJECT);
-    return v->object.size;
+    p = lept_query_ws(p, end);
+    if(p == end) {
+        return NULL;
+    }
+    if(*p == '*') {
+        lept_query_push(q, LEPT_STEP_ALL, descend);
+        p ++;
+    } else if(*p == '\'' || *p == '\"') {
+        s = lept_query_push(q, LEPT_STEP_KEY, descend);
+        p = lept_query_string(c, p, end);
+        lept_query_key(s, c);
+        if(p == NULL) {
+            return NULL;
+        }
+    } else {
+        const char* r;
+        s = lept_query_push(q, LEPT_STEP_INDEX, descend);
+        if((r = lept_query_int(p, end, &n)) != NULL) {
+            s->index = n;
+            s->has_start = 1;
+            p = lept_query_ws(r, end);
+        }
+        if(p < end && *p == ':') {
+            s->kind = LEPT_STEP_SLICE;
+            s->step = 1;
+            p = lept_query_ws(p + 1, end);
+            if((r = lept_query_int(p, end, &n)) != NULL) {
+                s->end = n;
+                s->has_end = 1;
+                p = lept_query_ws(r, end);
+            }
+            if(p < end && *p == ':') {
+                p = lept_query_ws(p + 1, end);
+                if((r = lept_query_int(p, end, &n)) != NULL) {
+                    s->step = n;
+                    p = r;
+                }
+            }
+        } else if(!s->has_start) {
+            return NULL;
+        }
+    }
+    p = lept_query_ws(p, end);
+    return (p < end && *p == ']') ? p + 1 : NULL;
 }
 
-const char* lept_get_object_key(const lept_value* v, size_t index) {
-    assert(v != NULL && v->type == LEPT_OBJECT);
-    assert(index < v->object.size);
-    return v->object.m[index].k.s;
+#define LEPT_QUERY_NAME_FIRST(ch) \
+    (((ch) >= 'a' && (ch) <= 'z') || ((ch) >= 'A' && (ch) <= 'Z') || (ch) == '_' || (unsigned char)(ch) >= 0x80)
+
+/* RFC 9535 segments after the '$' */
+static int lept_query_path(lept_query* q, lept_context* c, const char* p, const char* end) {
+    while(p < end) {
+        int descend = 0;
+        if(*p == '[') {
+            p ++;
+        } else if(*p == '.') {
+            if(++ p < end && *p == '.') {
+                descend = 1;
+                p ++;
+            }
+            if(p < end && *p == '*') {
+                lept_query_push(q, LEPT_STEP_ALL, descend);
+                p ++;
+                continue;
+            }
+            if(p < end && *p == '[' && descend) {
+                p ++;
+            } else {
+                lept_step* s = lept_query_push(q, LEPT_STEP_KEY, descend);
+                if(p == end || !LEPT_QUERY_NAME_FIRST(*p)) {
+                    return 0;
+                }
+                while(p < end && (LEPT_QUERY_NAME_FIRST(*p) || LEPT_ISDIGIT(*p))) {
+                    PUTC(c, *p ++);
+                }
+                lept_query_key(s, c);
+                continue;
+            }
+        } else {
+            return 0;
+        }
+        if((p = lept_query_bracket(q, c, p, end, descend)) == NULL) {
+            return 0;
+        }
+    }
+    return 1;
 }
 
-size_t lept_get_object_key_length(const lept_value* v, size_t index) {
-    assert(v != NULL && v->type == LEPT_OBJECT);
-    assert(index < v->object.size);
-    return v->object.m[index].k.len;
+lept_query* lept_query_compile(const char* path, size_t len) {
+    lept_query* q;
+    lept_context c;
+    int ok;
+
+    assert(path != NULL || len == 0);
+
+    q = (lept_query*)calloc(1, sizeof(lept_query));
+    lept_context_init(&c, NULL, 0);
+    if(len == 0 || path[0] == '/') {
+        ok = lept_query_pointer(q, &c, path, path + len);
+    } else if(path[0] == '$') {
+        ok = lept_query_path(q, &c, path + 1, path + len);
+    } else {
+        ok = 0;
+    }
+    c.top = 0;
+    lept_context_free(&c);
+    if(!ok) {
+        lept_query_free(q);
+        return NULL;
+    }
+    return q;
 }
 
-lept_value* lept_get_object_value(const lept_value* v, size_t index) {
-    assert(v != NULL && v->type == LEPT_OBJECT);
-    assert(index < v->object.size);
-    return &v->object.m[index].v;
+void lept_query_free(lept_query* q) {
+    if(q != NULL) {
+        for(size_t i = 0; i < q->n; i ++) {
+            free(q->steps[i].key);
+        }
+        free(q->steps);
+        free(q);
+    }
 }
 
-/* stringify */
+typedef struct {
+    const lept_query* q;
+    lept_query_fn fn;
+    void* user;
+    size_t count;
+} lept_query_run;
 
-#define PUTRAWS(c, s, len) memcpy(lept_context_push(c, len), s, len)
+static int lept_query_eval_step(lept_query_run* r, size_t i, lept_value* v);
 
-#define PUTS(c, s, len) \
+/* a child selected by step i goes on to the next step */
+#define LEPT_QUERY_NEXT(r, i, child) \
     do { \
-        PUTC(c, '\"'); \
-        for(size_t i = 0; i < len; i ++) { \
-            switch(s[i]) { \
-                case '\"': PUTRAWS(c, "\\\"", 2); break; \
-                case '\'': PUTRAWS(c, "\\\'", 2); break; \
-                case '\n': PUTRAWS(c, "\\n", 2); break; \
-                case '\t': PUTRAWS(c, "\\t", 2); break; \
-                case '\b': PUTRAWS(c, "\\b", 2); break; \
-                case '\r': PUTRAWS(c, "\\r", 2); break; \
-                case '\f': PUTRAWS(c, "\\f", 2); break; \
-                case '\\': PUTRAWS(c, "\\\\", 2); break; \
-                default: { \
-                    if((unsigned int)s[i] < 0x20) { \
-                        PUTRAWS(c, "\\u00", 4); \
-                        sprintf(lept_context_push(c, 2), "%02x", s[i]); \
-                    } else { \
-                        PUTC(c, s[i]); \
-                    } \
-                } \
-            } \
+        if(lept_query_eval_step((r), (i) + 1, (child))) { \
+            return 1; \
         } \
-        PUTC(c, '\"'); \
     } while(0)
 
-#define PUTKV(c, v, i) \
-    do { \
-        const char* s = lept_get_object_key((v), (i)); \
-        size_t len = lept_get_object_key_length((v), (i)); \
-        PUTS((c), s, len); \
-        PUTC((c), ':'); \
-        lept_stringify_value((c), lept_get_object_value((v), (i))); \
-    } while(0)
+/* non-zero once the callback asks to stop */
+static int lept_query_eval_step(lept_query_run* r, size_t i, lept_value* v) {
+    const lept_step* s;
+    long long n, len;
 
+    if(i == r->q->n) {
+        r->count ++;
+        return r->fn != NULL && r->fn(r->user, v) != 0;
+    }
+    s = &r->q->steps[i];
+    len = v->size;
 
-static int lept_stringify_value(lept_context* c, lept_value* v) {
-    int ret = LEPT_STRINGIFY_OK;
+    switch(s->kind) {
+        case LEPT_STEP_TOKEN:
+            if(v->type == LEPT_ARRAY && s->index >= 0 && s->index < len) {
+                LEPT_QUERY_NEXT(r, i, &v->e[s->index]);
+                break;
+            }
+            /* fall through */
+        case LEPT_STEP_KEY:
+            if(v->type == LEPT_OBJECT) {
+                size_t k = lept_object_find(v, s->key, s->klen, s->hash);
+                if(k != LEPT_KEY_NOT_EXIST) {
+                    LEPT_QUERY_NEXT(r, i, &v->m[k].v);
+                }
+            }
+            break;
+        case LEPT_STEP_INDEX:
+            n = (s->index < 0) ? len + s->index : s->index;
+            if(v->type == LEPT_ARRAY && n >= 0 && n < len) {
+                LEPT_QUERY_NEXT(r, i, &v->e[n]);
+            }
+            break;
+        case LEPT_STEP_ALL:
+            for(size_t k = 0; v->type == LEPT_ARRAY && k < v->size; k ++) {
+                LEPT_QUERY_NEXT(r, i, &v->e[k]);
+            }
+            for(size_t k = 0; v->type == LEPT_OBJECT && k < v->size; k ++) {
+                LEPT_QUERY_NEXT(r, i, &v->m[k].v);
+            }
+            break;
+        case LEPT_STEP_SLICE: {
+            /* RFC 9535 2.3.4.2.2: bounds counted from the end when negative, then clamped */
+            long long lo, hi, a, b;
+            if(v->type != LEPT_ARRAY || s->step == 0) {
+                break;
+            }
+            if(s->step > 0) {
+                a = s->has_start ? s->index : 0;
+                b = s->has_end ? s->end : len;
+            } else {
+                a = s->has_start ? s->index : len - 1;
+                b = s->has_end ? s->end : -len - 1;
+            }
+            a = (a < 0) ? len + a : a;
+            b = (b < 0) ? len + b : b;
+            if(s->step > 0) {
+                lo = (a < 0) ? 0 : (a > len ? len : a);
+                hi = (b < 0) ? 0 : (b > len ? len : b);
+                for(n = lo; n < hi; n += s->step) {
+                    LEPT_QUERY_NEXT(r, i, &v->e[n]);
+                }
+            } else {
+                hi = (a < -1) ? -1 : (a > len - 1 ? len - 1 : a);
+                lo = (b < -1) ? -1 : (b > len - 1 ? len - 1 : b);
+                for(n = hi; lo < n; n += s->step) {
+                    LEPT_QUERY_NEXT(r, i, &v->e[n]);
+                }
+            }
+            break;
+        }
+    }
 
-    switch(v->type) {
+    if(s->descend) {
+        for(size_t k = 0; v->type == LEPT_ARRAY && k < v->size; k ++) {
+            if(lept_query_eval_step(r, i, &v->e[k])) {
+                return 1;
+            }
+        }
+        for(size_t k = 0; v->type == LEPT_OBJECT && k < v->size; k ++) {
+            if(lept_query_eval_step(r, i, &v->m[k].v)) {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
 
-    case LEPT_NULL: PUTRAWS(c, "null", 4); break;
+size_t lept_query_eval(const lept_query* q, lept_value* v, lept_query_fn fn, void* user) {
+    lept_query_run r;
 
-    case LEPT_TRUE: PUTRAWS(c, "true", 4); break;
+    assert(q != NULL && v != NULL);
 
-    case LEPT_FALSE: PUTRAWS(c, "false", 5); break;
+    r.q = q;
+    r.fn = fn;
+    r.user = user;
+    r.count = 0;
+    lept_query_eval_step(&r, 0, v);
+    return r.count;
+}
 
-    case LEPT_NUMBER: {
-        c->top -= (32 - sprintf(lept_context_push(c, 32), "%.17g", lept_get_number(v)));
-        break;
-    }
+static int lept_query_keep(void* user, lept_value* v) {
+    *(lept_value**)user = v;
+    return 1;
+}
 
-    case LEPT_STRING: {
-        const char* s = lept_get_string(v);
-        size_t len = lept_get_string_length(v);
-        PUTS(c, s, len);
-        break;
+lept_value* lept_query_first(const lept_query* q, lept_value* v) {
+    lept_value* first = NULL;
+    lept_query_eval(q, v, lept_query_keep, &first);
+    return first;
+}
+
+/* projection
+ *
+ * The paths merge into a trie with one node per prefix. A node has its
+ * member children by key, its element children by index, and "any" for
+ * the wildcard; an explicit child also carries every path that goes
+ * through the wildcard, so a member or element matches at most one child.
+ * The walk decodes keys and feeds what it keeps to the DOM handler; a
+ * value with no child, or at a node that keeps its whole value, is handed
+ * to lept_lazy_skip() or lept_parse_value() at once.
+ */
+
+typedef struct {
+    char* key;
+    size_t klen;
+    lept_projection* next;
+} lept_proj_member;
+
+typedef struct {
+    size_t index;
+    lept_projection* next;
+} lept_proj_element;
+
+struct lept_projection {
+    int keep;                     /* a path ends here: the whole value */
+    lept_proj_member* members;
+    size_t nmembers;
+    lept_proj_element* elements;
+    size_t nelements;
+    lept_projection* any;         /* "*" */
+};
+
+static lept_projection* lept_proj_clone(const lept_projection* p) {
+    lept_projection* q = (lept_projection*)calloc(1, sizeof(lept_projection));
+    if(p == NULL) {
+        return q;
     }
+    q->keep = p->keep;
+    q->nmembers = p->nmembers;
+    q->nelements = p->nelements;
+    if(p->nmembers > 0) {
+        q->members = (lept_proj_member*)malloc(p->nmembers * sizeof(lept_proj_member));
+    }
+    for(size_t i = 0; i < p->nmembers; i ++) {
+        q->members[i].klen = p->members[i].klen;
+        q->members[i].key = (char*)malloc(p->members[i].klen + 1);
+        memcpy(q->members[i].key, p->members[i].key, p->members[i].klen + 1);
+        q->members[i].next = lept_proj_clone(p->members[i].next);
+    }
+    if(p->nelements > 0) {
+        q->elements = (lept_proj_element*)malloc(p->nelements * sizeof(lept_proj_element));
+    }
+    for(size_t i = 0; i < p->nelements; i ++) {
+        q->elements[i].index = p->elements[i].index;
+        q->elements[i].next = lept_proj_clone(p->elements[i].next);
+    }
+    q->any = (p->any != NULL) ? lept_proj_clone(p->any) : NULL;
+    return q;
+}
 
-    case LEPT_ARRAY: {
-        size_t size = lept_get_array_size(v);
-        PUTC(c, '[');
-        for(size_t i = 0; (size > 0) && (i < size - 1); i ++) {
-            lept_stringify_value(c, lept_get_array_element(v, i));
-            PUTC(c, ',');
+static lept_projection* lept_proj_member_find(const lept_projection* p, const char* key, size_t klen) {
+    for(size_t i = 0; i < p->nmembers; i ++) {
+        if(p->members[i].klen == klen && memcmp(p->members[i].key, key, klen) == 0) {
+            return p->members[i].next;
         }
-        if(size >= 1) {
-            lept_stringify_value(c, lept_get_array_element(v, size - 1));
+    }
+    return NULL;
+}
+
+static lept_projection* lept_proj_element_find(const lept_projection* p, size_t index) {
+    for(size_t i = 0; i < p->nelements; i ++) {
+        if(p->elements[i].index == index) {
+            return p->elements[i].next;
         }
-        PUTC(c, ']');
-        break;
     }
+    return NULL;
+}
+
+/* the child for key, started from the wildcard's paths if it is new */
+static lept_projection* lept_proj_add_member(lept_projection* p, const char* key, size_t klen) {
+    lept_projection* next = lept_proj_member_find(p, key, klen);
+    lept_proj_member* m;
+    if(next != NULL) {
+        return next;
+    }
+    p->members = (lept_proj_member*)realloc(p->members, (p->nmembers + 1) * sizeof(lept_proj_member));
+    m = &p->members[p->nmembers ++];
+    m->klen = klen;
+    m->key = (char*)malloc(klen + 1);
+    memcpy(m->key, key, klen + 1);
+    return m->next = lept_proj_clone(p->any);
+}
 
-    case LEPT_OBJECT: {
-        size_t size = lept_get_object_size(v);
-        PUTC(c, '{');
-        for(size_t i = 0; (size > 0) && (i < size - 1); i ++) {
-            PUTKV(c, v, i);
-            PUTC(c, ',');
+static lept_projection* lept_proj_add_element(lept_projection* p, size_t index) {
+    lept_projection* next = lept_proj_element_find(p, index);
+    lept_proj_element* e;
+    if(next != NULL) {
+        return next;
+    }
+    p->elements = (lept_proj_element*)realloc(p->elements, (p->nelements + 1) * sizeof(lept_proj_element));
+    e = &p->elements[p->nelements ++];
+    e->index = index;
+    return e->next = lept_proj_clone(p->any);
+}
+
+/* steps [i, q->n) of a query below p */
+static int lept_proj_insert(lept_projection* p, const lept_query* q, size_t i) {
+    const lept_step* s;
+
+    if(i == q->n) {
+        p->keep = 1;
+        return 1;
+    }
+    s = &q->steps[i];
+    if(s->descend) {
+        return 0;
+    }
+    switch(s->kind) {
+        case LEPT_STEP_TOKEN:
+            if(s->klen == 1 && s->key[0] == '*') {
+                break;
+            }
+            if(s->index >= 0 && !lept_proj_insert(lept_proj_add_element(p, (size_t)s->index), q, i + 1)) {
+                return 0;
+            }
+            return lept_proj_insert(lept_proj_add_member(p, s->key, s->klen), q, i + 1);
+        case LEPT_STEP_KEY:
+            return lept_proj_insert(lept_proj_add_member(p, s->key, s->klen), q, i + 1);
+        case LEPT_STEP_INDEX:
+            /* counting from the end needs the size before the elements */
+            return s->index >= 0 && lept_proj_insert(lept_proj_add_element(p, (size_t)s->index), q, i + 1);
+        case LEPT_STEP_ALL:
+            break;
+        default:
+            return 0;
+    }
+
+    /* the wildcard, and every child already there */
+    if(p->any == NULL) {
+        p->any = (lept_projection*)calloc(1, sizeof(lept_projection));
+    }
+    if(!lept_proj_insert(p->any, q, i + 1)) {
+        return 0;
+    }
+    for(size_t k = 0; k < p->nmembers; k ++) {
+        if(!lept_proj_insert(p->members[k].next, q, i + 1)) {
+            return 0;
         }
-        if(size >= 1) {
-            PUTKV(c, v, size - 1);
+    }
+    for(size_t k = 0; k < p->nelements; k ++) {
+        if(!lept_proj_insert(p->elements[k].next, q, i + 1)) {
+            return 0;
         }
-        PUTC(c, '}');
-        break;
     }
+    return 1;
+}
 
-    default: ret = LEPT_STRINGIFY_UNKNOWN_TYPE; break;
+lept_projection* lept_projection_compile(const char* const* paths, size_t n) {
+    lept_projection* p;
 
-    }
+    assert(paths != NULL || n == 0);
 
-    return ret;
+    p = (lept_projection*)calloc(1, sizeof(lept_projection));
+    for(size_t i = 0; i < n; i ++) {
+        lept_query* q = lept_query_compile(paths[i], strlen(paths[i]));
+        int ok = (q != NULL && lept_proj_insert(p, q, 0));
+        lept_query_free(q);
+        if(!ok) {
+            lept_projection_free(p);
+            return NULL;
+        }
+    }
+    return p;
 }
 
-int lept_stringify(lept_value* v, char** json, size_t* len) {
-    assert(v != NULL); assert(json != NULL);
+void lept_projection_free(lept_projection* p) {
+    if(p != NULL) {
+        for(size_t i = 0; i < p->nmembers; i ++) {
+            free(p->members[i].key);
+            lept_projection_free(p->members[i].next);
+        }
+        for(size_t i = 0; i < p->nelements; i ++) {
+            lept_projection_free(p->elements[i].next);
+        }
+        lept_projection_free(p->any);
+        free(p->members);
+        free(p->elements);
+        free(p);
+    }
+}
 
+/* past the value at c->json, unread */
+static int lept_project_skip(lept_context* c) {
+    const char* q;
     int ret;
 
-    lept_context c;
-    lept_context_init(&c, NULL);
+    if(c->json == c->end) {
+        return LEPT_PARSE_EXPECT_VALUE;
+    }
+    if((ret = lept_lazy_skip(c->json, c->end, &q)) != LEPT_PARSE_OK) {
+        return ret;
+    }
+    if(q == c->json) {
+        return LEPT_PARSE_INVALID_VALUE;
+    }
+    c->json = q;
+    return LEPT_PARSE_OK;
+}
 
-    ret = lept_stringify_value(&c, v);
+/* what p selects of the value at c->json, pushed unless *kept is 0 */
+static int lept_project_value(lept_context* c, const lept_projection* p, int* kept) {
+    const lept_projection* next;
+    size_t size = 0, index = 0; /* kept, and elements seen */
+    char ch = LEPT_PEEK(c, c->json);
+    int ret, k;
+
+    *kept = 0;
+    if(p->keep) {
+        *kept = 1;
+        return lept_parse_value(c);
+    }
+    if(!(ch == '{' && (p->nmembers > 0 || p->any != NULL)) && !(ch == '[' && (p->nelements > 0 || p->any != NULL))) {
+        /* no path goes into it */
+        return lept_project_skip(c);
+    }
 
-    if(ret != LEPT_STRINGIFY_OK) {
-        lept_context_free(&c);
-        *json = NULL;
+    c->json ++;
+    lept_parse_whitespace(c);
+    if(LEPT_PEEK(c, c->json) == ch + 2) {
+        c->json ++;
     } else {
-        if(len != NULL) {
-            *len = c.top;
+        for(;;) {
+            if(ch == '{') {
+                const char* kend;
+                char* s;
+                size_t len;
+                if(LEPT_PEEK(c, c->json) != '\"') {
+                    return LEPT_PARSE_MISS_KEY;
+                }
+                /* a key without escapes is looked up where it is, and only decoded if kept */
+                if((ret = lept_lazy_skip(c->json, c->end, &kend)) != LEPT_PARSE_OK) {
+                    return ret;
+                }
+                if(memchr(c->json + 1, '\\', kend - c->json - 2) == NULL &&
+                    lept_proj_member_find(p, c->json + 1, kend - c->json - 2) == NULL && p->any == NULL) {
+                    next = NULL;
+                    c->json = kend;
+                } else {
+                    if((ret = lept_parse_string_raw(c, &s, &len)) != LEPT_PARSE_OK) {
+                        return ret;
+                    }
+                    next = lept_proj_member_find(p, s, len);
+                    if(next == NULL) {
+                        next = p->any;
+                    }
+                    /* s is just above the top, the key goes first */
+                    if(next != NULL && lept_dom_key(c, s, len) != 0) {
+                        return c->abort_ret;
+                    }
+                }
+                lept_parse_whitespace(c);
+                if(LEPT_PEEK(c, c->json) != ':') {
+                    return LEPT_PARSE_MISS_COLON;
+                }
+                c->json ++;
+                lept_parse_whitespace(c);
+            } else {
+                next = lept_proj_element_find(p, index ++);
+                if(next == NULL) {
+                    next = p->any;
+                }
+            }
+
+            if(next == NULL) {
+                ret = lept_project_skip(c);
+                k = 0;
+            } else {
+                ret = lept_project_value(c, next, &k);
+                if(!k && ch == '{') {
+                    lept_value key = LEPT_CONTEXT_POP(c, lept_value);
+                    lept_free(&key);
+                }
+            }
+            if(ret != LEPT_PARSE_OK) {
+                return ret;
+            }
+            size += k;
+
+            lept_parse_whitespace(c);
+            if(LEPT_PEEK(c, c->json) == ',') {
+                c->json ++;
+                lept_parse_whitespace(c);
+                continue;
+            }
+            if(LEPT_PEEK(c, c->json) != ch + 2) {
+                return (ch == '[') ? LEPT_PARSE_INVALID_VALUE : LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET;
+            }
+            c->json ++;
+            break;
         }
+    }
+    *kept = 1;
+    if((ch == '[') ? lept_dom_end_array(c, size) : lept_dom_end_object(c, size)) {
+        *kept = 0;
+        return c->abort_ret;
+    }
+    return LEPT_PARSE_OK;
+}
 
-        PUTC(&c, '\0');
-        *json = c.stack;
+int lept_parse_projected(lept_value* v, const char* json, size_t len, const lept_projection* p) {
+    lept_context c;
+    int ret, kept;
+
+    assert(v != NULL && (json != NULL || len == 0) && p != NULL);
+
+    lept_init(v);
+    lept_context_init(&c, json, len);
+    c.sax = &lept_dom_handler;
+    c.user = &c;
+
+    lept_parse_whitespace(&c);
+    if((ret = lept_project_value(&c, p, &kept)) == LEPT_PARSE_OK) {
+        lept_parse_whitespace(&c);
+        if(c.json != c.end) {
+            ret = LEPT_PARSE_ROOT_NOT_SINGULAR;
+        }
+    }
+    if(ret == LEPT_PARSE_OK && kept) {
+        *v = LEPT_CONTEXT_POP(&c, lept_value);
     }
+    while(c.top > 0) {
+        lept_free((lept_value*)lept_context_pop(&c, sizeof(lept_value)));
+    }
+    free(c.levels);
+    c.levels = NULL;
+    c.depth = c.levels_size = 0;
+    lept_context_free(&c);
 
     return ret;
 }
@@ -2,6 +2,8 @@
 #define LEPTJSON_H__
 
 #include <stddef.h> /* size_t */
+#include <stdint.h> /* uint32_t */
+#include <stdio.h>  /* FILE */
 
 struct lept_value;
 typedef struct lept_value lept_value;
@@ -15,42 +17,45 @@ typedef enum {
 	LEPT_OBJECT
 } lept_type;
 
-typedef struct lept_value {
+/* the payload points into memory owned elsewhere (the input buffer of an
+ * in-situ parse, or an arena), lept_free() leaves it alone */
+#define LEPT_BORROWED 0x01
 
-	union {
-		struct {
-			lept_member* m;
-			size_t size;
-		} object; /* object */
-
-		struct {
-			lept_value* e;
-			size_t size;
-		} array; /* array */
+/* strings up to this long are stored in the node itself */
+#define LEPT_INLINE_MAX 13
 
-		struct {
-			size_t len;
-			char* s;
-		} string; /* string */
+/**
+  * A node is 16 bytes: the payload pointer (or the number), a 32-bit size
+  * shared by strings, arrays and objects, a capacity class, and the flags
+  * and type bytes at the end. A short string instead fills the first 14
+  * bytes, its '\0' and a byte holding LEPT_INLINE_MAX - len included, and
+  * needs no allocation. The fields are internal; use the accessors.
+  */
+typedef struct lept_value {
 
+	union {
 		struct {
-			double v;
-		} number; /* number */
+			union {
+				double n;        /* number */
+				char* s;         /* string */
+				lept_value* e;   /* array */
+				lept_member* m;  /* object */
+			};
+			uint32_t size;       /* string length, array or object size */
+			unsigned char cap;   /* array or object capacity, 0: size, else 1 << (cap - 1) */
+			unsigned char spare;
+			unsigned char flags; /* LEPT_BORROWED, ... */
+			unsigned char type;  /* lept_type */
+		};
+		char small[LEPT_INLINE_MAX + 1]; /* inline string */
 	};
 
-    lept_type type;
-
 } lept_value;
 
+/* the key is a string node, inline when short */
 typedef struct lept_member {
-
-	struct {
-		size_t len;
-		char* s;
-	} k;
-
+	lept_value k;
 	lept_value v;
-
 } lept_member;
 
 enum {
@@ -67,13 +72,18 @@ enum {
 	LEPT_PARSE_MISS_KEY,
 	LEPT_PARSE_MISS_COLON,
 	LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET,
+	LEPT_PARSE_ABORTED,
+	LEPT_PARSE_TOO_DEEP,
+	LEPT_PARSE_TOO_LONG,
 	LEPT_STRINGIFY_OK,
-	LEPT_STRINGIFY_UNKNOWN_TYPE
+	LEPT_STRINGIFY_UNKNOWN_TYPE,
+	LEPT_STRINGIFY_WRITE_FAILED,
+	LEPT_STRINGIFY_BUFFER_TOO_SMALL
 };
 
 /* helper - strings */
 
-static const char* lept_type_string[] = {
+static const char* const lept_type_string[] = {
 	"LEPT_NULL",
 	"LEPT_FALSE",
 	"LEPT_TRUE",
@@ -83,7 +93,7 @@ static const char* lept_type_string[] = {
 	"LEPT_OBJECT"
 };
 
-static const char* lept_parse_xxx_string[] = {
+static const char* const lept_parse_xxx_string[] = {
 	"LEPT_PARSE_OK",
 	"LEPT_PARSE_EXPECT_VALUE",
 	"LEPT_PARSE_INVALID_VALUE",
@@ -97,14 +107,192 @@ static const char* lept_parse_xxx_string[] = {
 	"LEPT_PARSE_MISS_KEY",
 	"LEPT_PARSE_MISS_COLON",
 	"LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET",
+	"LEPT_PARSE_ABORTED",
+	"LEPT_PARSE_TOO_DEEP",
+	"LEPT_PARSE_TOO_LONG",
 	"LEPT_STRINGIFY_OK",
-	"LEPT_STRINGIFY_UNKNOWN_TYPE"
+	"LEPT_STRINGIFY_UNKNOWN_TYPE",
+	"LEPT_STRINGIFY_WRITE_FAILED",
+	"LEPT_STRINGIFY_BUFFER_TOO_SMALL"
 };
 
 void lept_init(lept_value* v);
 void lept_free(lept_value* v);
 
+/* a string or container beyond the 2^32 - 1 bytes or elements a node holds fails with LEPT_PARSE_TOO_LONG */
 int lept_parse(lept_value* v, const char* json);
+/* parse exactly len bytes, json needs no '\0' terminator */
+int lept_parse_n(lept_value* v, const char* json, size_t len);
+
+/* depth
+ *
+ * Parsing fails with LEPT_PARSE_TOO_DEEP on entering more than max_depth
+ * nested arrays and objects (LEPT_PARSE_MAX_DEPTH, 1024 unless defined at
+ * build time; 0 lifts the limit). Nesting does not use the C stack, the
+ * limit guards lept_free() and lept_stringify(), which still recurse. The
+ * setting is the process-wide default, like the engine: change it before
+ * other threads start parsing, and pass a limit of its own to one call
+ * with lept_parse_ex().
+ */
+
+void lept_set_max_depth(size_t depth);
+size_t lept_get_max_depth();
+
+/* sax
+ *
+ * lept_parse_sax() reports the document as a sequence of events instead of
+ * building a tree, and allocates nothing per value. Strings and keys are
+ * decoded but only valid during their callback. A NULL handler skips the
+ * event; a handler returning non-zero stops the parse with
+ * LEPT_PARSE_ABORTED. Events already sent are not taken back when a later
+ * syntax error is found.
+ */
+
+typedef struct {
+	int (*null)(void* user);
+	int (*boolean)(void* user, int b);
+	int (*number)(void* user, double d);
+	int (*string)(void* user, const char* s, size_t len);
+	int (*start_array)(void* user);
+	int (*end_array)(void* user, size_t size);
+	int (*start_object)(void* user);
+	int (*key)(void* user, const char* s, size_t len);
+	int (*end_object)(void* user, size_t size);
+} lept_sax_handler;
+
+int lept_parse_sax(const char* json, size_t len, const lept_sax_handler* h, void* user);
+
+/* engine
+ *
+ * LEPT_ENGINE_INDEX first indexes the structural characters of the whole
+ * input with vector code (stage 1), then parses along that index (stage 2).
+ * It pays off on large, loosely formatted documents; results and errors are
+ * the same as with the default engine. The setting is process-wide and
+ * should be chosen before parsing starts.
+ */
+
+typedef enum {
+	LEPT_ENGINE_RECURSIVE, /* default */
+	LEPT_ENGINE_INDEX
+} lept_engine;
+
+void lept_set_engine(lept_engine e);
+lept_engine lept_get_engine();
+
+/* options
+ *
+ * lept_parse_ex() is lept_parse_n() with the depth limit and the engine of
+ * this call only. lept_parse_options_init() fills in the process defaults.
+ */
+
+typedef struct {
+	size_t max_depth; /* 0: no limit */
+	lept_engine engine;
+} lept_parse_options;
+
+void lept_parse_options_init(lept_parse_options* o);
+int lept_parse_ex(lept_value* v, const char* json, size_t len, const lept_parse_options* o);
+
+/* stream
+ *
+ * The push parser takes the document in chunks of any size, split anywhere,
+ * even inside a token, and keeps its place between calls. A feed returns
+ * the first error as soon as it is seen, and keeps returning it; finish
+ * ends the input and gives the same value and error code as lept_parse_n()
+ * on the whole document. The stream then starts over for the next one.
+ */
+
+typedef struct lept_stream lept_stream;
+
+lept_stream* lept_stream_new();
+void lept_stream_free(lept_stream* s);
+int lept_stream_feed(lept_stream* s, const char* chunk, size_t len);
+int lept_stream_finish(lept_stream* s, lept_value* v);
+
+/* in-situ
+ *
+ * lept_parse_insitu() decodes every string and key in place, so they point
+ * into json instead of being copied: no string is allocated at all. The
+ * buffer is overwritten (even when parsing fails) and must outlive v.
+ */
+
+int lept_parse_insitu(lept_value* v, char* json, size_t len);
+
+/* arena
+ *
+ * lept_parse_arena() bump-allocates every string, array and object of the
+ * document from large blocks owned by the arena. Such values are marked
+ * LEPT_BORROWED and lept_free() leaves them alone, so a document left as
+ * parsed needs no lept_free(): lept_arena_reset() releases all of it at
+ * once and keeps the blocks for the next document. A changed one may hold
+ * heap memory the reset does not see (a string set, a container grown), so
+ * it needs lept_free() before the reset; that frees only what is its own.
+ */
+
+typedef struct lept_arena_block lept_arena_block;
+
+typedef struct {
+	lept_arena_block* head; /* first block */
+	lept_arena_block* cur;  /* block being allocated from, NULL after reset */
+	size_t block_size;
+	char* stack;            /* parse stack reused across documents */
+	size_t stack_size;
+} lept_arena;
+
+void lept_arena_init(lept_arena* a, size_t block_size); /* 0: default size */
+void lept_arena_reset(lept_arena* a);
+void lept_arena_free(lept_arena* a);
+
+int lept_parse_arena(lept_value* v, const char* json, size_t len, lept_arena* a);
+
+/* intern
+ *
+ * lept_parse_intern() keeps one copy of each distinct key in the table t,
+ * shared by every object with that key, across all documents parsed with t.
+ * Such keys are LEPT_BORROWED and live until lept_intern_free(), which must
+ * come after the values. Keys short enough to be inline are not interned.
+ * lept_intern_key() returns the shared copy of a key, adding it if needed;
+ * lookups with that pointer match by address before comparing bytes.
+ */
+
+typedef struct lept_intern lept_intern;
+
+lept_intern* lept_intern_new();
+void lept_intern_free(lept_intern* t);
+const char* lept_intern_key(lept_intern* t, const char* key, size_t klen);
+size_t lept_intern_size(const lept_intern* t); /* bytes of key text held */
+
+int lept_parse_intern(lept_value* v, const char* json, size_t len, lept_intern* t);
+
+/* lines
+ *
+ * lept_parse_lines() parses newline-delimited JSON, one document per line,
+ * on nthreads threads (0: one per online CPU). Lines need no copy or '\0'.
+ * *lines gets one entry per line, in input order, with the value and the
+ * error code lept_parse_n() gives for that line alone; a blank line is
+ * LEPT_PARSE_EXPECT_VALUE, a last line without '\n' counts if not empty.
+ * Returns the number of lines; lept_free_lines() releases them.
+ */
+
+typedef struct {
+	lept_value v;
+	int ret;
+} lept_line;
+
+size_t lept_parse_lines(const char* json, size_t len, lept_line** lines, int nthreads);
+void lept_free_lines(lept_line* lines, size_t n);
+
+/* parallel
+ *
+ * lept_parse_parallel() splits a document that is one large array between
+ * its top-level elements and parses the pieces on nthreads threads (0: one
+ * per online CPU). The value and error code are those of lept_parse_n(),
+ * which it falls back to for small documents, other roots, and any input
+ * it cannot split safely.
+ */
+
+int lept_parse_parallel(lept_value* v, const char* json, size_t len, int nthreads);
+
 lept_type lept_get_type(const lept_value* v);
 
 int lept_get_boolean(const lept_value* v);
@@ -120,13 +308,218 @@ void lept_set_string(lept_value* v, const char* s, size_t len);
 size_t lept_get_array_size(const lept_value* v);
 lept_value* lept_get_array_element(const lept_value* v, size_t index);
 
+/* building
+ *
+ * Arrays and objects grow by doubling, so appending is amortized O(1); a
+ * reserved or grown capacity is rounded up to a power of two, a parsed one
+ * is the size. Element and member pointers stay valid until the next call
+ * that adds to or removes from the same array or object. New elements and
+ * values are null, ready for the lept_set_xxx() functions. An array or
+ * object from an arena that grows is copied out of it with everything it
+ * holds, and then no longer depends on the arena; like any changed arena
+ * document, it needs lept_free().
+ */
+
+void lept_set_array(lept_value* v, size_t capacity);
+size_t lept_get_array_capacity(const lept_value* v);
+void lept_reserve_array(lept_value* v, size_t capacity);
+void lept_shrink_array(lept_value* v);
+void lept_clear_array(lept_value* v);
+lept_value* lept_pushback_array_element(lept_value* v);
+void lept_popback_array_element(lept_value* v);
+lept_value* lept_insert_array_element(lept_value* v, size_t index);
+void lept_erase_array_element(lept_value* v, size_t index, size_t count);
+
 size_t lept_get_object_size(const lept_value* v);
 const char* lept_get_object_key(const lept_value* v, size_t index);
 size_t lept_get_object_key_length(const lept_value* v, size_t index);
 lept_value* lept_get_object_value(const lept_value* v, size_t index);
 
+/* by key, hashed for wide objects; the first match if keys repeat; only reads */
+#define LEPT_KEY_NOT_EXIST ((size_t)-1)
+size_t lept_find_object_index(const lept_value* v, const char* key, size_t klen);
+lept_value* lept_find_object_value(const lept_value* v, const char* key, size_t klen); /* NULL: not found */
+
+void lept_set_object(lept_value* v, size_t capacity);
+size_t lept_get_object_capacity(const lept_value* v);
+void lept_reserve_object(lept_value* v, size_t capacity);
+void lept_shrink_object(lept_value* v);
+void lept_clear_object(lept_value* v);
+lept_value* lept_set_object_value(lept_value* v, const char* key, size_t klen); /* the existing one if any */
+void lept_remove_object_value(lept_value* v, size_t index);
+
 #define lept_set_null(v) lept_free(v)
 
 int lept_stringify(lept_value* v, char** json, size_t* len);
 
+/* sink
+ *
+ * lept_stringify_to() hands the output to write in pieces as it is
+ * produced, each at most LEPT_STRINGIFY_BUFFER_SIZE (4096) bytes plus one
+ * token of up to 32 bytes, so memory use does not grow with the document
+ * or its depth. A non-zero return from write makes the call fail with
+ * LEPT_STRINGIFY_WRITE_FAILED and drops the rest.
+ */
+
+typedef int (*lept_write_fn)(void* user, const char* s, size_t len);
+
+int lept_stringify_to(lept_value* v, lept_write_fn write, void* user);
+int lept_stringify_file(lept_value* v, FILE* fp);
+int lept_stringify_fd(lept_value* v, int fd); /* retries short writes and EINTR */
+
+/* exact size
+ *
+ * lept_stringify_length() is the exact length lept_stringify() produces,
+ * computed without writing. lept_stringify_into() writes the text and a
+ * '\0' straight into buf, allocating nothing, so cap must be at least that
+ * length + 1; otherwise it fails with LEPT_STRINGIFY_BUFFER_TOO_SMALL and
+ * the buffer holds a prefix.
+ */
+
+size_t lept_stringify_length(lept_value* v);
+int lept_stringify_into(lept_value* v, char* buf, size_t cap, size_t* len);
+
+/* parallel
+ *
+ * lept_stringify_parallel() gives the same text as lept_stringify(), but
+ * writes the elements or members of a large root array or object on up to
+ * nthreads threads (0: one per online CPU). Each thread takes at least
+ * LEPT_PARALLEL_MIN_ELEMENTS (1024) of them, so small values stay on one.
+ */
+
+int lept_stringify_parallel(lept_value* v, char** json, size_t* len, int nthreads);
+
+/* binary
+ *
+ * CBOR (RFC 8949) and MessagePack forms of a value, for services that have
+ * no use for the text. Encoding gives a malloc()ed buffer; whole numbers
+ * are written as integers, others as float32 when exact, else float64.
+ * Decoding takes any well-formed input whose map keys are strings:
+ * integers become numbers (exact up to 2^53), byte strings and bin become
+ * strings, CBOR tags are skipped and undefined is null. Errors are the
+ * parse codes: LEPT_PARSE_EXPECT_VALUE for input that ends early,
+ * LEPT_PARSE_INVALID_VALUE for an item JSON cannot hold (ext, NaN, a
+ * simple value, a misplaced break), LEPT_PARSE_MISS_KEY for another kind
+ * of key and LEPT_PARSE_ROOT_NOT_SINGULAR for bytes after the value.
+ */
+
+int lept_encode_cbor(const lept_value* v, char** buf, size_t* len);
+int lept_decode_cbor(lept_value* v, const char* buf, size_t len);
+int lept_encode_msgpack(const lept_value* v, char** buf, size_t* len);
+int lept_decode_msgpack(lept_value* v, const char* buf, size_t len);
+
+/* snapshot
+ *
+ * lept_snapshot_write() saves a value in a form that is read in place:
+ * nodes refer to each other by offset, so lept_snapshot_open() only maps
+ * the file read-only, whatever its size, and every process that opens the
+ * same file shares its pages. A lept_view is a node of an open snapshot,
+ * read with accessors named after those of lept_value; it stays valid
+ * until lept_snapshot_close(). Writing returns LEPT_STRINGIFY_OK or
+ * LEPT_STRINGIFY_WRITE_FAILED. Opening returns NULL for a file that
+ * cannot be mapped, or that is not a snapshot of this version and byte
+ * order; the rest of the file is trusted.
+ */
+
+typedef struct lept_snapshot lept_snapshot;
+
+typedef struct {
+	const char* base; /* the mapped file, NULL: not found */
+	size_t at;        /* offset of the node */
+} lept_view;
+
+int lept_snapshot_write(const lept_value* v, const char* path);
+lept_snapshot* lept_snapshot_open(const char* path);
+void lept_snapshot_close(lept_snapshot* s);
+lept_view lept_snapshot_root(const lept_snapshot* s);
+
+lept_type lept_view_get_type(lept_view v);
+int lept_view_get_boolean(lept_view v);
+double lept_view_get_number(lept_view v);
+const char* lept_view_get_string(lept_view v);
+size_t lept_view_get_string_length(lept_view v);
+size_t lept_view_get_array_size(lept_view v);
+lept_view lept_view_get_array_element(lept_view v, size_t index);
+size_t lept_view_get_object_size(lept_view v);
+const char* lept_view_get_object_key(lept_view v, size_t index);
+size_t lept_view_get_object_key_length(lept_view v, size_t index);
+lept_view lept_view_get_object_value(lept_view v, size_t index);
+size_t lept_view_find_object_index(lept_view v, const char* key, size_t klen);
+lept_view lept_view_find_object_value(lept_view v, const char* key, size_t klen); /* base NULL: not found */
+
+/* lazy
+ *
+ * lept_lazy_init() points a cursor at the root of a document and reads no
+ * further. lept_lazy_next_element() and lept_lazy_find_field() move into
+ * an array or object, checking the separators between the values they pass
+ * and stepping over each value they do not stop at by matching brackets;
+ * numbers and strings are decoded only when read. Errors inside values
+ * never visited therefore go unreported, as does text after the root. A
+ * field is searched for from where the last search on the object stopped,
+ * wrapping around once, so fields read in document order cost one pass; of
+ * repeated keys it finds whichever comes next. Calls return the parse
+ * codes, or LEPT_LAZY_END past the last element or for a missing field.
+ * Cursors point into the text, which must outlive them.
+ */
+
+#define LEPT_LAZY_END (-1)
+
+typedef struct {
+	const char* json; /* the value */
+	const char* end;  /* of the input */
+	const char* it;   /* array or object: the element or value last visited, NULL: none */
+} lept_lazy;
+
+int lept_lazy_init(lept_lazy* v, const char* json, size_t len);
+lept_type lept_lazy_get_type(const lept_lazy* v);
+int lept_lazy_get_number(const lept_lazy* v, double* d);
+int lept_lazy_get_string(const lept_lazy* v, char** s, size_t* len); /* *s malloc()ed, '\0'-terminated */
+int lept_lazy_get_value(const lept_lazy* v, lept_value* value);      /* the whole value, as lept_parse_n() */
+int lept_lazy_next_element(lept_lazy* array, lept_lazy* element);
+int lept_lazy_find_field(lept_lazy* object, const char* key, size_t klen, lept_lazy* value);
+
+/* query
+ *
+ * lept_query_compile() checks and decodes a path once, into a program that
+ * lept_query_eval() runs on any number of values. A path starting with '/'
+ * (or empty) is an RFC 6901 JSON Pointer, which selects at most one value.
+ * One starting with '$' is the RFC 9535 JSONPath subset of member names
+ * (.name, ['name']), indexes ([0], [-1] from the end), wildcards (.*, [*]),
+ * slices ([start:end:step]) and descendants (..name, ..*, ..[0]); without
+ * filters or unions. Compiling returns NULL for anything else. Each value
+ * selected is passed to fn, in document order, until fn returns non-zero;
+ * the count of values passed is returned. Members are found by key through
+ * the object hash index. The matches point into v, which is not const as
+ * they may be changed through them; evaluation itself only reads.
+ */
+
+typedef struct lept_query lept_query;
+typedef int (*lept_query_fn)(void* user, lept_value* v);
+
+lept_query* lept_query_compile(const char* path, size_t len);
+void lept_query_free(lept_query* q);
+size_t lept_query_eval(const lept_query* q, lept_value* v, lept_query_fn fn, void* user);
+lept_value* lept_query_first(const lept_query* q, lept_value* v); /* NULL: none */
+
+/* projection
+ *
+ * lept_parse_projected() builds only the parts of the document that a
+ * projection, compiled from query paths such as "/user/id", "/ts" and
+ * "$.items[*].price", selects. In a projection the pointer token "*"
+ * matches every member or element, as [*] does. Objects and arrays on the
+ * way to a selected value keep only what is selected inside them, so
+ * elements are renumbered. A value no path can go into, as a scalar or an
+ * array where only member names follow, is left out; if nothing is left,
+ * v is null. Everything else is stepped over without being decoded or
+ * allocated, and is only checked as far as lept_lazy does. Descendant
+ * segments, slices and negative indexes cannot be decided while reading
+ * and fail to compile.
+ */
+
+typedef struct lept_projection lept_projection;
+
+lept_projection* lept_projection_compile(const char* const* paths, size_t n);
+void lept_projection_free(lept_projection* p);
+int lept_parse_projected(lept_value* v, const char* json, size_t len, const lept_projection* p);
+
 #endif /* LEPTJSON_H__ */
@@ -244,6 +244,13 @@ static void test_parse_number() {
     TEST_NUMBER(-2.2250738585072014e-308, "-2.2250738585072014e-308");
     TEST_NUMBER( 1.7976931348623157e+308, "1.7976931348623157e+308");  /* Max double */
     TEST_NUMBER(-1.7976931348623157e+308, "-1.7976931348623157e+308");
+
+    TEST_NUMBER(9007199254740992.0, "9007199254740993"); /* 2^53 + 1, ties to even */
+    TEST_NUMBER(1.2345678901234568e+29, "123456789012345678901234567890");
+    TEST_NUMBER(-122.4194155, "-122.4194155");
+    TEST_NUMBER(1.0, "1.00000000000000011102230246251565404236316680908203125"); /* exactly halfway */
+    TEST_NUMBER(1.0000000000000002, "1.00000000000000011102230246251565404236316680908203126");
+    TEST_NUMBER(1e-300, "0.000000000000000000000000000000000000000000000000000000000001e-240");
 }
 
 static void test_parse_string() {
@@ -259,6 +266,12 @@ static void test_parse_string() {
     TEST_STRING("\xE2\x82\xAC", "\"\\u20AC\""); /* Euro sign U+20AC */
     TEST_STRING("\xF0\x9D\x84\x9E", "\"\\uD834\\uDD1E\"");  /* G clef sign U+1D11E */
     TEST_STRING("\xF0\x9D\x84\x9E", "\"\\ud834\\udd1e\"");  /* G clef sign U+1D11E */
+
+    /* runs longer than one vector, escapes on both sides of a block boundary */
+    TEST_STRING("0123456789abcdef0123456789abcdef0123456789abcdef\n0123456789abcdef",
+        "\"0123456789abcdef0123456789abcdef0123456789abcdef\\n0123456789abcdef\"");
+    TEST_STRING("0123456789abcdef0123456789abcde\"\\0123456789abcdef0123456789abcdef\xC2\xA2",
+        "\"0123456789abcdef0123456789abcde\\\"\\\\0123456789abcdef0123456789abcdef\\u00A2\"");
 }
 
 static void test_parse_array() {
@@ -297,6 +310,13 @@ static void test_parse_array() {
 	EXPECT_EQ_DOUBLE(4.0f, lept_get_number(lept_get_array_element(&v, 3)));
 	lept_free(&v);
 
+	lept_init(&v);
+	ret_parse = lept_parse(&v, "[\n                                        1,\n\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t2\r\n                                        ]   ");
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, ret_parse, lept_parse_xxx_string);
+	EXPECT_EQ_SIZE_T(2, lept_get_array_size(&v));
+	EXPECT_EQ_DOUBLE(2.0, lept_get_number(lept_get_array_element(&v, 1)));
+	lept_free(&v);
+
 	lept_init(&v);
 	ret_parse = lept_parse(&v, "[\"13fas\", [ 1, 55.123], 3, 4]");
 	EXPECT_EQ_TEST(LEPT_PARSE_OK, ret_parse, lept_parse_xxx_string);
@@ -490,6 +510,12 @@ static void test_parse_invalid_value() {
     TEST_ERROR(LEPT_PARSE_INVALID_VALUE, "INF");
     TEST_ERROR(LEPT_PARSE_INVALID_VALUE, "NAN");
     TEST_ERROR(LEPT_PARSE_INVALID_VALUE, "nan");
+    TEST_ERROR(LEPT_PARSE_INVALID_VALUE, "-");
+    TEST_ERROR(LEPT_PARSE_INVALID_VALUE, "-1.");
+    TEST_ERROR(LEPT_PARSE_INVALID_VALUE, "1.e3");
+    TEST_ERROR(LEPT_PARSE_INVALID_VALUE, "1e");
+    TEST_ERROR(LEPT_PARSE_INVALID_VALUE, "1e+");
+    TEST_ERROR(LEPT_PARSE_INVALID_VALUE, "0x1F");
 	TEST_ERROR(LEPT_PARSE_INVALID_VALUE, "[,]");
 	TEST_ERROR(LEPT_PARSE_INVALID_VALUE, "[2, 2, ]");
     TEST_ERROR(LEPT_PARSE_INVALID_VALUE, "[1");
@@ -512,6 +538,8 @@ static void test_parse_number_too_big() {
 
     TEST_ERROR(LEPT_PARSE_NUMBER_TOO_BIG, "123E123123122");
     TEST_ERROR(LEPT_PARSE_NUMBER_TOO_BIG, "-123E123123122");
+    TEST_ERROR(LEPT_PARSE_NUMBER_TOO_BIG, "1e309");
+    TEST_ERROR(LEPT_PARSE_NUMBER_TOO_BIG, "179769313486231580793728971405303415079934132710037826936173778980444968292764750946649017977587207096330286416692887910946555547851940402630657488671505820681908902000708383676273854845817711531764475730270069855571366959622842914819860834936475292719074168444365510704342711559699508093042880177904174497792");
 	TEST_ERROR(LEPT_PARSE_NUMBER_TOO_BIG, "[-123E123123122, 12]");
 }
 
@@ -521,6 +549,7 @@ static void test_parse_miss_quotation_mark() {
     TEST_ERROR(LEPT_PARSE_MISS_QUOTATION_MARK, "\"");
 	TEST_ERROR(LEPT_PARSE_MISS_QUOTATION_MARK, "\"ABC");
     TEST_ERROR(LEPT_PARSE_MISS_QUOTATION_MARK, "[123, \"ABC]");
+    TEST_ERROR(LEPT_PARSE_MISS_QUOTATION_MARK, "\"0123456789abcdef0123456789abcdef0123456789");
 }
 
 static void test_parse_invalid_escape() {
@@ -538,6 +567,7 @@ static void test_parse_invalid_string_char() {
     TEST_ERROR(LEPT_PARSE_INVALID_STRING_CHAR, "\"\x01\"");
     TEST_ERROR(LEPT_PARSE_INVALID_STRING_CHAR, "\"\x1F\"");
 	TEST_ERROR(LEPT_PARSE_INVALID_STRING_CHAR, "[123, [2, 2], \"\x1F\"]");
+    TEST_ERROR(LEPT_PARSE_INVALID_STRING_CHAR, "\"0123456789abcdef0123456789abcdef0123456789\x1F\"");
 }
 
 static void test_parse_invalid_unicode_surrogate() {
@@ -598,6 +628,62 @@ static void test_parse_miss_comma_or_curly_bracket() {
     TEST_ERROR(LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET, "{\"a\":{}");
 }
 
+static void test_parse_too_deep() {
+    fprintf_warn(stdout, " => %s starts...\n", __func__);
+
+    size_t n = 20000;
+    char* json = (char*)malloc(2 * n + 1);
+    size_t max_depth = lept_get_max_depth();
+    lept_sax_handler h = { NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL };
+    lept_parse_options o;
+    lept_stream* s;
+    lept_value v;
+
+    memset(json, '[', n);
+    memset(json + n, ']', n);
+    json[2 * n] = '\0';
+
+    /* the default limit */
+    EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_parse_n(&v, json + n - 1024, 2 * 1024), lept_parse_xxx_string);
+    lept_free(&v);
+    EXPECT_EQ_TEST(LEPT_PARSE_TOO_DEEP, lept_parse_n(&v, json + n - 1025, 2 * 1025), lept_parse_xxx_string);
+    EXPECT_EQ_INT(LEPT_NULL, lept_get_type(&v));
+
+    /* far deeper than any recursion would survive, with no limit */
+    lept_set_max_depth(0);
+    EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_parse_sax(json, 2 * n, &h, NULL), lept_parse_xxx_string);
+    EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_parse_n(&v, json + n - 5000, 2 * 5000), lept_parse_xxx_string);
+    lept_free(&v);
+
+    lept_set_max_depth(2);
+    TEST_ERROR(LEPT_PARSE_OK, "[[1],{\"a\":1},[]]");
+    TEST_ERROR(LEPT_PARSE_TOO_DEEP, "[[[1]]]");
+    TEST_ERROR(LEPT_PARSE_TOO_DEEP, "{\"a\":{\"b\":{}}}");
+    TEST_ERROR(LEPT_PARSE_TOO_DEEP, "[[[");
+    TEST_ERROR(LEPT_PARSE_MISS_COLON, "[{\"a\"[[[]]]}]");
+    s = lept_stream_new();
+    lept_stream_feed(s, "[[[1]]]", 7);
+    EXPECT_EQ_TEST(LEPT_PARSE_TOO_DEEP, lept_stream_finish(s, &v), lept_parse_xxx_string);
+    lept_stream_free(s);
+    lept_set_max_depth(max_depth);
+
+    /* a limit for one call, the default stays */
+    lept_parse_options_init(&o);
+    EXPECT_EQ_SIZE_T(max_depth, o.max_depth);
+    o.max_depth = 2;
+    EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_parse_ex(&v, "[[1],[]]", 8, &o), lept_parse_xxx_string);
+    lept_free(&v);
+    EXPECT_EQ_TEST(LEPT_PARSE_TOO_DEEP, lept_parse_ex(&v, "[[[1]]]", 7, &o), lept_parse_xxx_string);
+    o.max_depth = 0;
+    o.engine = LEPT_ENGINE_INDEX;
+    EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_parse_ex(&v, json + n - 5000, 2 * 5000, &o), lept_parse_xxx_string);
+    lept_free(&v);
+    EXPECT_EQ_SIZE_T(max_depth, lept_get_max_depth());
+    EXPECT_EQ_TEST(LEPT_PARSE_TOO_DEEP, lept_parse_n(&v, json + n - 1025, 2 * 1025), lept_parse_xxx_string);
+
+    free(json);
+}
+
 static void test_access_string() {
     fprintf_warn(stdout, " => %s starts...\n", __func__);
 
@@ -609,6 +695,23 @@ static void test_access_string() {
     EXPECT_EQ_STRING("Hello", lept_get_string(&v), lept_get_string_length(&v));
     lept_set_string(&v, "Hello World!", 12);
     EXPECT_EQ_STRING("Hello World!", lept_get_string(&v), lept_get_string_length(&v));
+    /* around the inline limit */
+    lept_set_string(&v, "Hello, World!", 13);
+    EXPECT_EQ_STRING("Hello, World!", lept_get_string(&v), lept_get_string_length(&v));
+    lept_set_string(&v, "Hello, World!!", 14);
+    EXPECT_EQ_STRING("Hello, World!!", lept_get_string(&v), lept_get_string_length(&v));
+    lept_set_string(&v, "Hello\0World!", 12);
+    EXPECT_EQ_STRING("Hello\0World!", lept_get_string(&v), lept_get_string_length(&v));
+    lept_free(&v);
+    EXPECT_EQ_SIZE_T(16, sizeof(lept_value));
+
+    EXPECT_EQ_TEST(LEPT_PARSE_OK,
+        lept_parse(&v, "{\"abcdefghijklm\":\"abcdefghijklm\",\"abcdefghijklmn\":\"abcdefghijklmn\"}"), lept_parse_xxx_string);
+    EXPECT_EQ_SIZE_T(13, lept_get_object_key_length(&v, 0));
+    EXPECT_EQ_STRING("abcdefghijklm", lept_get_string(lept_get_object_value(&v, 0)), 13);
+    EXPECT_EQ_SIZE_T(14, lept_get_object_key_length(&v, 1));
+    EXPECT_EQ_STRING("abcdefghijklmn", lept_get_object_key(&v, 1), 14);
+    EXPECT_EQ_STRING("abcdefghijklmn", lept_get_string(lept_find_object_value(&v, "abcdefghijklmn", 14)), 14);
     lept_free(&v);
 }
 
@@ -639,10 +742,118 @@ static void test_access_array() {
 
 	lept_value v;
 
+	lept_value a, *e;
+	lept_arena arena;
+	const char* json;
+	size_t i, j;
+
 	lept_init(&v);
 	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_parse(&v, "[ ]"), lept_parse_xxx_string);
 	EXPECT_EQ_SIZE_T(0, lept_get_array_size(&v));
 	lept_free(&v);
+
+	lept_init(&a);
+	for(j = 0; j <= 5; j += 5) {
+		lept_set_array(&a, j);
+		EXPECT_EQ_SIZE_T(0, lept_get_array_size(&a));
+		EXPECT_TRUE(lept_get_array_capacity(&a) >= j);
+		for(i = 0; i < 10; i ++) {
+			lept_set_number(lept_pushback_array_element(&a), (double)i);
+		}
+		EXPECT_EQ_SIZE_T(10, lept_get_array_size(&a));
+		for(i = 0; i < 10; i ++) {
+			EXPECT_EQ_DOUBLE((double)i, lept_get_number(lept_get_array_element(&a, i)));
+		}
+	}
+
+	lept_popback_array_element(&a);
+	EXPECT_EQ_SIZE_T(9, lept_get_array_size(&a));
+	for(i = 0; i < 9; i ++) {
+		EXPECT_EQ_DOUBLE((double)i, lept_get_number(lept_get_array_element(&a, i)));
+	}
+
+	lept_erase_array_element(&a, 4, 0);
+	EXPECT_EQ_SIZE_T(9, lept_get_array_size(&a));
+	lept_erase_array_element(&a, 8, 1);
+	EXPECT_EQ_SIZE_T(8, lept_get_array_size(&a));
+	lept_erase_array_element(&a, 0, 2);
+	EXPECT_EQ_SIZE_T(6, lept_get_array_size(&a));
+	for(i = 0; i < 6; i ++) {
+		EXPECT_EQ_DOUBLE((double)i + 2, lept_get_number(lept_get_array_element(&a, i)));
+	}
+
+	for(i = 0; i < 2; i ++) {
+		lept_set_number(lept_insert_array_element(&a, i), (double)i);
+	}
+	EXPECT_EQ_SIZE_T(8, lept_get_array_size(&a));
+	for(i = 0; i < 8; i ++) {
+		EXPECT_EQ_DOUBLE((double)i, lept_get_number(lept_get_array_element(&a, i)));
+	}
+
+	EXPECT_TRUE(lept_get_array_capacity(&a) > 8);
+	lept_shrink_array(&a);
+	EXPECT_EQ_SIZE_T(8, lept_get_array_capacity(&a));
+	EXPECT_EQ_SIZE_T(8, lept_get_array_size(&a));
+	for(i = 0; i < 8; i ++) {
+		EXPECT_EQ_DOUBLE((double)i, lept_get_number(lept_get_array_element(&a, i)));
+	}
+
+	lept_set_string(&v, "Hello, long string", 18);
+	lept_set_string(lept_pushback_array_element(&a), "Hello, long string", 18); /* test if element is freed */
+	i = lept_get_array_capacity(&a);
+	lept_clear_array(&a);
+	EXPECT_EQ_SIZE_T(0, lept_get_array_size(&a));
+	EXPECT_EQ_SIZE_T(i, lept_get_array_capacity(&a));
+	lept_shrink_array(&a);
+	EXPECT_EQ_SIZE_T(0, lept_get_array_capacity(&a));
+	lept_free(&v);
+	lept_free(&a);
+
+	/* a parsed array grows from its exact size, an arena one moves to the heap */
+	lept_arena_init(&arena, 0);
+	json = "[1,\"two\",[3]]";
+	for(j = 0; j < 2; j ++) {
+		if(j == 0) {
+			EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_parse(&a, json), lept_parse_xxx_string);
+		} else {
+			EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_parse_arena(&a, json, strlen(json), &arena), lept_parse_xxx_string);
+		}
+		EXPECT_EQ_SIZE_T(3, lept_get_array_capacity(&a));
+		e = lept_pushback_array_element(lept_get_array_element(&a, 2));
+		lept_set_boolean(e, 1);
+		lept_set_number(lept_insert_array_element(&a, 0), 0.0);
+		EXPECT_EQ_SIZE_T(4, lept_get_array_capacity(&a));
+		EXPECT_EQ_DOUBLE(1.0, lept_get_number(lept_get_array_element(&a, 1)));
+		EXPECT_EQ_STRING("two", lept_get_string(lept_get_array_element(&a, 2)), 3);
+		EXPECT_EQ_SIZE_T(2, lept_get_array_size(lept_get_array_element(&a, 3)));
+		lept_clear_array(&a);
+		lept_free(&a);
+		lept_arena_reset(&arena);
+	}
+
+	/* what a grown arena array holds is copied too, and outlives the arena */
+	json = "[\"a string too long to be inline\",{\"a key too long to be inline\":[\"also too long for inline\"]}]";
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_parse_arena(&a, json, strlen(json), &arena), lept_parse_xxx_string);
+	lept_set_null(lept_pushback_array_element(&a));
+	lept_arena_reset(&arena);
+	json = "[\"overwrites what the arena held before\",[],{}]";
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_parse_arena(&v, json, strlen(json), &arena), lept_parse_xxx_string);
+	EXPECT_EQ_STRING("a string too long to be inline", lept_get_string(lept_get_array_element(&a, 0)), 31);
+	e = lept_get_array_element(&a, 1);
+	EXPECT_EQ_STRING("a key too long to be inline", lept_get_object_key(e, 0), 28);
+	e = lept_find_object_value(e, "a key too long to be inline", 27);
+	EXPECT_EQ_STRING("also too long for inline", lept_get_string(lept_get_array_element(e, 0)), 25);
+	lept_free(&a);
+
+	/* emptied, an arena array keeps its room, which moves all the same */
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_parse_arena(&a, "[1,2,3,4,5]", 11, &arena), lept_parse_xxx_string);
+	lept_clear_array(&a);
+	for(i = 0; i < 9; i ++) {
+		lept_set_number(lept_pushback_array_element(&a), (double)i);
+	}
+	EXPECT_EQ_DOUBLE(8.0, lept_get_number(lept_get_array_element(&a, 8)));
+	lept_free(&a);
+	lept_arena_free(&arena);
 }
 
 static void test_access_object() {
@@ -650,10 +861,924 @@ static void test_access_object() {
 
 	lept_value v;
 
+	lept_value o, *pv;
+	char key[32];
+	size_t i, j, index;
+
 	lept_init(&v);
 	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_parse(&v, "{}"), lept_parse_xxx_string);
 	EXPECT_EQ_SIZE_T(0, lept_get_object_size(&v));
+	EXPECT_EQ_SIZE_T(LEPT_KEY_NOT_EXIST, lept_find_object_index(&v, "a", 1));
 	lept_free(&v);
+
+	lept_init(&o);
+	for(j = 0; j <= 5; j += 5) {
+		lept_set_object(&o, j);
+		EXPECT_EQ_SIZE_T(0, lept_get_object_size(&o));
+		EXPECT_TRUE(lept_get_object_capacity(&o) >= j);
+		for(i = 0; i < 10; i ++) {
+			key[0] = 'a' + (char)i;
+			key[1] = '\0';
+			lept_set_number(lept_set_object_value(&o, key, 1), (double)i);
+		}
+		EXPECT_EQ_SIZE_T(10, lept_get_object_size(&o));
+		for(i = 0; i < 10; i ++) {
+			key[0] = 'a' + (char)i;
+			index = lept_find_object_index(&o, key, 1);
+			EXPECT_TRUE(index != LEPT_KEY_NOT_EXIST);
+			pv = lept_get_object_value(&o, index);
+			EXPECT_EQ_DOUBLE((double)i, lept_get_number(pv));
+		}
+	}
+
+	/* an existing key keeps its member */
+	lept_set_string(lept_set_object_value(&o, "j", 1), "Hello, long string", 18);
+	EXPECT_EQ_SIZE_T(10, lept_get_object_size(&o));
+	EXPECT_EQ_STRING("Hello, long string", lept_get_string(lept_find_object_value(&o, "j", 1)), 18);
+
+	index = lept_find_object_index(&o, "j", 1);
+	lept_remove_object_value(&o, index);
+	EXPECT_EQ_SIZE_T(LEPT_KEY_NOT_EXIST, lept_find_object_index(&o, "j", 1));
+	EXPECT_EQ_SIZE_T(9, lept_get_object_size(&o));
+
+	index = lept_find_object_index(&o, "a", 1);
+	lept_remove_object_value(&o, index);
+	EXPECT_EQ_SIZE_T(LEPT_KEY_NOT_EXIST, lept_find_object_index(&o, "a", 1));
+	EXPECT_EQ_SIZE_T(8, lept_get_object_size(&o));
+	EXPECT_EQ_DOUBLE(5.0, lept_get_number(lept_find_object_value(&o, "f", 1)));
+
+	EXPECT_TRUE(lept_get_object_capacity(&o) > 8);
+	lept_shrink_object(&o);
+	EXPECT_EQ_SIZE_T(8, lept_get_object_capacity(&o));
+	EXPECT_EQ_SIZE_T(8, lept_get_object_size(&o));
+	for(i = 0; i < 8; i ++) {
+		key[0] = 'a' + (char)(i + 1);
+		EXPECT_EQ_DOUBLE((double)(i + 1), lept_get_number(lept_get_object_value(&o, lept_find_object_index(&o, key, 1))));
+	}
+
+	lept_set_string(lept_set_object_value(&o, "a long key of a member", 22), "Hello, long string", 18);
+	i = lept_get_object_capacity(&o);
+	lept_clear_object(&o);
+	EXPECT_EQ_SIZE_T(0, lept_get_object_size(&o));
+	EXPECT_EQ_SIZE_T(i, lept_get_object_capacity(&o));
+	lept_shrink_object(&o);
+	EXPECT_EQ_SIZE_T(0, lept_get_object_capacity(&o));
+
+	/* appends keep a hashed object findable, removals too */
+	for(i = 0; i < 1000; i ++) {
+		j = sprintf(key, "member %d", (int)i);
+		lept_set_number(lept_set_object_value(&o, key, j), (double)i);
+		EXPECT_EQ_SIZE_T(i, lept_find_object_index(&o, key, j));
+	}
+	for(i = 0; i < 1000; i += 100) {
+		j = sprintf(key, "member %d", (int)i);
+		lept_remove_object_value(&o, lept_find_object_index(&o, key, j));
+	}
+	EXPECT_EQ_SIZE_T(990, lept_get_object_size(&o));
+	for(i = 0; i < 1000; i ++) {
+		j = sprintf(key, "member %d", (int)i);
+		pv = lept_find_object_value(&o, key, j);
+		if(i % 100 == 0) {
+			EXPECT_TRUE(pv == NULL);
+		} else {
+			EXPECT_EQ_DOUBLE((double)i, lept_get_number(pv));
+		}
+	}
+	lept_free(&o);
+
+	/* a parsed, hashed object grows too */
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_parse(&o,
+		"{\"k0\":0,\"k1\":1,\"k2\":2,\"k3\":3,\"k4\":4,\"k5\":5,\"k6\":6,\"k7\":7,"
+		"\"k8\":8,\"k9\":9,\"k10\":10,\"k11\":11,\"k12\":12,\"k13\":13,\"k14\":14,\"k15\":15}"),
+		lept_parse_xxx_string);
+	EXPECT_EQ_SIZE_T(16, lept_get_object_capacity(&o));
+	EXPECT_EQ_DOUBLE(15.0, lept_get_number(lept_find_object_value(&o, "k15", 3)));
+	lept_set_null(lept_set_object_value(&o, "k16", 3));
+	EXPECT_EQ_SIZE_T(32, lept_get_object_capacity(&o));
+	EXPECT_EQ_SIZE_T(16, lept_find_object_index(&o, "k16", 3));
+	EXPECT_EQ_DOUBLE(15.0, lept_get_number(lept_find_object_value(&o, "k15", 3)));
+	lept_free(&o);
+}
+
+static void test_find_object() {
+	fprintf_warn(stdout, " => %s starts...\n", __func__);
+
+	static const int sizes[] = { 3, 15, 16, 200 }; /* either side of the hash threshold */
+	char json[8192], key[16];
+	size_t len;
+	lept_value v, *e;
+	lept_arena a;
+
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_parse(&v, "{\"a\":1,\"b\":2,\"a\":3,\"\":4,\"a\\u0000b\":5}"),
+		lept_parse_xxx_string);
+	EXPECT_EQ_SIZE_T(0, lept_find_object_index(&v, "a", 1));
+	EXPECT_EQ_SIZE_T(1, lept_find_object_index(&v, "b", 1));
+	EXPECT_EQ_SIZE_T(3, lept_find_object_index(&v, "", 0));
+	EXPECT_EQ_SIZE_T(4, lept_find_object_index(&v, "a\0b", 3));
+	EXPECT_EQ_SIZE_T(LEPT_KEY_NOT_EXIST, lept_find_object_index(&v, "ab", 2));
+	EXPECT_TRUE(lept_find_object_value(&v, "c", 1) == NULL);
+	lept_free(&v);
+
+	lept_arena_init(&a, 0);
+	for(size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s ++) {
+		/* keys k0..kn-1 in reverse order, then a duplicate of k0 */
+		len = sprintf(json, "{");
+		for(int i = sizes[s] - 1; i >= 0; i --) {
+			len += sprintf(json + len, "\"k%d\":%d,", i, i);
+		}
+		sprintf(json + len, "\"k0\":-1}");
+
+		for(int pass = 0; pass < 2; pass ++) {
+			if(pass == 0) {
+				EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_parse(&v, json), lept_parse_xxx_string);
+			} else {
+				EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_parse_arena(&v, json, strlen(json), &a), lept_parse_xxx_string);
+			}
+			for(int i = 0; i < sizes[s]; i ++) {
+				int klen = sprintf(key, "k%d", i);
+				EXPECT_EQ_SIZE_T(sizes[s] - 1 - i, lept_find_object_index(&v, key, klen));
+				e = lept_find_object_value(&v, key, klen);
+				EXPECT_EQ_DOUBLE((double)i, e != NULL ? lept_get_number(e) : -2.0);
+			}
+			EXPECT_EQ_SIZE_T(LEPT_KEY_NOT_EXIST, lept_find_object_index(&v, "k", 1));
+			EXPECT_EQ_SIZE_T(LEPT_KEY_NOT_EXIST, lept_find_object_index(&v, "k99999", 6));
+			/* insertion order is untouched */
+			EXPECT_EQ_STRING("k0", lept_get_object_key(&v, sizes[s] - 1), 3);
+			lept_free(&v);
+			lept_arena_reset(&a);
+		}
+	}
+	lept_arena_free(&a);
+}
+
+/* joins the matches into one JSON array text */
+static int test_query_collect(void* user, lept_value* v) {
+	char* json;
+	size_t len;
+	char* out = (char*)user;
+	size_t at = strlen(out);
+
+	EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_stringify(v, &json, &len));
+	sprintf(out + at, "%s%.*s", (at > 1) ? "," : "", (int)len, json);
+	free(json);
+	return 0;
+}
+
+#define TEST_QUERY(expect, v, path) \
+    do { \
+        char out[1024] = "["; \
+        lept_query* q = lept_query_compile(path, strlen(path)); \
+        EXPECT_TRUE(q != NULL); \
+        if(q != NULL) { \
+            lept_query_eval(q, v, test_query_collect, out); \
+            strcat(out, "]"); \
+            EXPECT_EQ_STRING(expect, out, strlen(expect) + 1); \
+            lept_query_free(q); \
+        } \
+    } while(0)
+
+#define TEST_QUERY_ERROR(path) \
+    do { \
+        EXPECT_TRUE(lept_query_compile(path, strlen(path)) == NULL); \
+    } while(0)
+
+static int test_query_stop(void* user, lept_value* v) {
+	(void)v;
+	return -- *(int*)user == 0;
+}
+
+static void test_query() {
+	fprintf_warn(stdout, " => %s starts...\n", __func__);
+
+	lept_value v;
+	lept_query* q;
+	int left;
+
+	/* RFC 6901 section 5 */
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_parse(&v,
+		"{\"foo\":[\"bar\",\"baz\"],\"\":0,\"a/b\":1,\"c%d\":2,\"e^f\":3,\"g|h\":4,\"i\\\\j\":5,"
+		"\"k\\\"l\":6,\" \":7,\"m~n\":8}"), lept_parse_xxx_string);
+	TEST_QUERY("[[\"bar\",\"baz\"]]", &v, "/foo");
+	TEST_QUERY("[\"bar\"]", &v, "/foo/0");
+	TEST_QUERY("[0]", &v, "/");
+	TEST_QUERY("[1]", &v, "/a~1b");
+	TEST_QUERY("[2]", &v, "/c%d");
+	TEST_QUERY("[3]", &v, "/e^f");
+	TEST_QUERY("[4]", &v, "/g|h");
+	TEST_QUERY("[5]", &v, "/i\\j");
+	TEST_QUERY("[6]", &v, "/k\"l");
+	TEST_QUERY("[7]", &v, "/ ");
+	TEST_QUERY("[8]", &v, "/m~0n");
+	TEST_QUERY("[]", &v, "/foo/2");
+	TEST_QUERY("[]", &v, "/foo/01");
+	TEST_QUERY("[]", &v, "/foo/-");
+	TEST_QUERY("[]", &v, "/bar");
+	TEST_QUERY("[]", &v, "/foo/0/x");
+	q = lept_query_compile("", 0);
+	EXPECT_TRUE(lept_query_first(q, &v) == &v);
+	lept_query_free(q);
+	lept_free(&v);
+
+	/* Goessner's store, RFC 9535 section 1.5 */
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_parse(&v,
+		"{\"store\":{\"book\":["
+		"{\"category\":\"reference\",\"author\":\"Nigel Rees\",\"title\":\"Sayings of the Century\",\"price\":8},"
+		"{\"category\":\"fiction\",\"author\":\"Evelyn Waugh\",\"title\":\"Sword of Honour\",\"price\":12},"
+		"{\"category\":\"fiction\",\"author\":\"Herman Melville\",\"title\":\"Moby Dick\",\"isbn\":\"0-553-21311-3\",\"price\":8},"
+		"{\"category\":\"fiction\",\"author\":\"J. R. R. Tolkien\",\"title\":\"The Lord of the Rings\",\"isbn\":\"0-395-19395-8\",\"price\":22}],"
+		"\"bicycle\":{\"color\":\"red\",\"price\":399}}}"), lept_parse_xxx_string);
+	TEST_QUERY("[\"Nigel Rees\",\"Evelyn Waugh\",\"Herman Melville\",\"J. R. R. Tolkien\"]", &v, "$.store.book[*].author");
+	TEST_QUERY("[\"Nigel Rees\",\"Evelyn Waugh\",\"Herman Melville\",\"J. R. R. Tolkien\"]", &v, "$..author");
+	TEST_QUERY("[8,12,8,22,399]", &v, "$.store..price");
+	TEST_QUERY("[\"Moby Dick\"]", &v, "$..book[2].title");
+	TEST_QUERY("[\"J. R. R. Tolkien\"]", &v, "$..book[-1].author");
+	TEST_QUERY("[\"Nigel Rees\",\"Evelyn Waugh\"]", &v, "$..book[0:2].author");
+	TEST_QUERY("[\"0-553-21311-3\",\"0-395-19395-8\"]", &v, "$..book[*].isbn");
+	TEST_QUERY("[\"red\"]", &v, "$['store'][\"bicycle\"][ 'col\\u006fr' ]");
+	TEST_QUERY("[399]", &v, "/store/bicycle/price");
+	TEST_QUERY("[]", &v, "$.store.book[4]");
+	TEST_QUERY("[]", &v, "$.store.bicycle[0]");
+	TEST_QUERY("[]", &v, "$.store.missing..price");
+	q = lept_query_compile("$..*", 4);
+	EXPECT_EQ_SIZE_T(27, lept_query_eval(q, &v, NULL, NULL));
+	left = 3;
+	EXPECT_EQ_SIZE_T(3, lept_query_eval(q, &v, test_query_stop, &left));
+	lept_query_free(q);
+	lept_free(&v);
+
+	/* RFC 9535 section 2.3.4.3 */
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_parse(&v, "[\"a\",\"b\",\"c\",\"d\",\"e\",\"f\",\"g\"]"), lept_parse_xxx_string);
+	TEST_QUERY("[\"b\",\"c\"]", &v, "$[1:3]");
+	TEST_QUERY("[\"f\",\"g\"]", &v, "$[5:]");
+	TEST_QUERY("[\"b\",\"d\"]", &v, "$[1:5:2]");
+	TEST_QUERY("[\"f\",\"d\"]", &v, "$[5:1:-2]");
+	TEST_QUERY("[\"g\",\"f\",\"e\",\"d\",\"c\",\"b\",\"a\"]", &v, "$[::-1]");
+	TEST_QUERY("[\"e\",\"f\",\"g\"]", &v, "$[-3:100]");
+	TEST_QUERY("[]", &v, "$[::0]");
+	TEST_QUERY("[]", &v, "$[3:1]");
+	TEST_QUERY("[\"g\"]", &v, "$[-1]");
+	TEST_QUERY("[]", &v, "$[-8]");
+	TEST_QUERY("[]", &v, "$.a");
+	lept_free(&v);
+
+	/* deep enough for the hash index on the way down */
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_parse(&v,
+		"{\"k0\":0,\"k1\":1,\"k2\":2,\"k3\":3,\"k4\":4,\"k5\":5,\"k6\":6,\"k7\":7,\"k8\":8,\"k9\":9,"
+		"\"k10\":10,\"k11\":11,\"k12\":12,\"k13\":13,\"k14\":14,\"k15\":{\"x\":[{\"x\":1}]}}"), lept_parse_xxx_string);
+	TEST_QUERY("[14]", &v, "$.k14");
+	TEST_QUERY("[[{\"x\":1}],1]", &v, "$..x");
+	TEST_QUERY("[1]", &v, "/k15/x/0/x");
+	lept_free(&v);
+
+	TEST_QUERY_ERROR("a");
+	TEST_QUERY_ERROR("foo/0");
+	TEST_QUERY_ERROR("/~2");
+	TEST_QUERY_ERROR("/a~");
+	TEST_QUERY_ERROR("$.");
+	TEST_QUERY_ERROR("$..");
+	TEST_QUERY_ERROR("$.1a");
+	TEST_QUERY_ERROR("$a");
+	TEST_QUERY_ERROR("$[01]");
+	TEST_QUERY_ERROR("$[-0]");
+	TEST_QUERY_ERROR("$[9007199254740992]");
+	TEST_QUERY_ERROR("$['a]");
+	TEST_QUERY_ERROR("$['a'");
+	TEST_QUERY_ERROR("$[]");
+	TEST_QUERY_ERROR("$[?(@.a)]");
+	TEST_QUERY_ERROR("$['\\x']");
+}
+
+/* parse the first len bytes of json from an exact-size heap copy */
+#define TEST_PARSE_N(expect, json, len) \
+    do { \
+        lept_value v; \
+        char* buf = (char*)malloc(len); \
+        memcpy(buf, json, len); \
+        EXPECT_EQ_TEST(expect, lept_parse_n(&v, buf, len), lept_parse_xxx_string); \
+        lept_free(&v); \
+        free(buf); \
+    } while(0)
+
+static void test_parse_n() {
+	fprintf_warn(stdout, " => %s starts...\n", __func__);
+
+	TEST_PARSE_N(LEPT_PARSE_OK, "[1,2]xxx", 5);
+	TEST_PARSE_N(LEPT_PARSE_OK, "{\"k\":\"0123456789abcdef0123456789abcdef0123456789\"}", 50);
+	TEST_PARSE_N(LEPT_PARSE_OK, "true", 4);
+	TEST_PARSE_N(LEPT_PARSE_OK, "-1.5e3", 6);
+	TEST_PARSE_N(LEPT_PARSE_EXPECT_VALUE, "   ", 3);
+	TEST_PARSE_N(LEPT_PARSE_EXPECT_VALUE, "[1,", 3);
+	TEST_PARSE_N(LEPT_PARSE_INVALID_VALUE, "true", 3);
+	TEST_PARSE_N(LEPT_PARSE_INVALID_VALUE, "-1.5e3", 5);
+	TEST_PARSE_N(LEPT_PARSE_INVALID_VALUE, "1.5", 2);
+	TEST_PARSE_N(LEPT_PARSE_INVALID_VALUE, "[1", 2);
+	TEST_PARSE_N(LEPT_PARSE_MISS_QUOTATION_MARK, "\"abc\"", 4);
+	TEST_PARSE_N(LEPT_PARSE_MISS_QUOTATION_MARK, "\"0123456789abcdef0123456789abcdef0123456789\"", 43);
+	TEST_PARSE_N(LEPT_PARSE_INVALID_ESCAPE, "\"\\n\"", 2);
+	TEST_PARSE_N(LEPT_PARSE_INVALID_UNICODE_HEX, "\"\\u0041\"", 6);
+	TEST_PARSE_N(LEPT_PARSE_INVALID_UNICODE_SURROGATE, "\"\\uD834\\uDD1E\"", 8);
+	TEST_PARSE_N(LEPT_PARSE_MISS_COLON, "{\"a\":1}", 4);
+
+	/* embedded '\0' is an ordinary (invalid) byte, not the end of input */
+	TEST_PARSE_N(LEPT_PARSE_ROOT_NOT_SINGULAR, "null\0", 5);
+	TEST_PARSE_N(LEPT_PARSE_INVALID_VALUE, "\0", 1);
+	TEST_PARSE_N(LEPT_PARSE_INVALID_STRING_CHAR, "\"a\0b\"", 5);
+	TEST_PARSE_N(LEPT_PARSE_INVALID_VALUE, "[1\0]", 4);
+}
+
+static void test_parse_insitu() {
+	fprintf_warn(stdout, " => %s starts...\n", __func__);
+
+	char json[] = "{\"plain\":\"abc\",\"esc\\u0041\":\"a\\tb\\uD834\\uDD1Ec\",\"a\":[\"\",\"x\\\"y\"]}";
+	char bad[] = "[\"ok\",\"\\v\"]";
+	lept_value v;
+	const lept_value* e;
+
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_parse_insitu(&v, json, sizeof(json) - 1), lept_parse_xxx_string);
+	EXPECT_EQ_SIZE_T(3, lept_get_object_size(&v));
+
+	/* strings and keys point into the buffer */
+	e = lept_get_object_value(&v, 0);
+	EXPECT_EQ_STRING("abc", lept_get_string(e), 4);
+	EXPECT_EQ_SIZE_T(3, lept_get_string_length(e));
+	EXPECT_TRUE(lept_get_string(e) == json + 10);
+	EXPECT_TRUE(lept_get_object_key(&v, 0) == json + 2);
+	EXPECT_EQ_STRING("plain", lept_get_object_key(&v, 0), 6);
+
+	/* escapes are decoded in place */
+	EXPECT_EQ_STRING("escA", lept_get_object_key(&v, 1), 5);
+	EXPECT_EQ_SIZE_T(4, lept_get_object_key_length(&v, 1));
+	e = lept_get_object_value(&v, 1);
+	EXPECT_EQ_STRING("a\tb\xF0\x9D\x84\x9E" "c", lept_get_string(e), 9);
+	EXPECT_EQ_SIZE_T(8, lept_get_string_length(e));
+	EXPECT_TRUE(lept_get_string(e) > json && lept_get_string(e) < json + sizeof(json));
+
+	e = lept_get_object_value(&v, 2);
+	EXPECT_EQ_STRING("", lept_get_string(lept_get_array_element(e, 0)), 1);
+	EXPECT_EQ_STRING("x\"y", lept_get_string(lept_get_array_element(e, 1)), 4);
+
+	lept_free(&v);
+
+	EXPECT_EQ_TEST(LEPT_PARSE_INVALID_ESCAPE, lept_parse_insitu(&v, bad, sizeof(bad) - 1), lept_parse_xxx_string);
+	EXPECT_EQ_INT(LEPT_NULL, lept_get_type(&v));
+
+	/* assigning to a borrowed string must not free the buffer */
+	strcpy(json, "\"borrowed\"");
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_parse_insitu(&v, json, strlen(json)), lept_parse_xxx_string);
+	lept_set_string(&v, "owned", 5);
+	EXPECT_EQ_STRING("owned", lept_get_string(&v), 6);
+	lept_free(&v);
+}
+
+static void test_parse_engine() {
+	fprintf_warn(stdout, " => %s starts...\n", __func__);
+
+	/* tokens, escapes and backslash runs shifted across 64-byte blocks */
+	static const char* docs[] = {
+		" [ 1 , \"a\\\\\" , \"b\\\\\\\"\\\\\" ,\"\\\\\\\\\\\\\"\" ] ",
+		"{ \"k\" : [ true , false,null ] ,\"\\\"\":{ }}\n",
+		"[ 1x ]", "[ 1 x ]", "{ \"a\" 1 }", "[ \"abc ]  ", "[ 1 ] 2", "[ \"\\\"] \" ]"
+	};
+	char json[256];
+	lept_value v1, v2;
+	char *s1, *s2;
+	int r1, r2;
+
+	for(size_t d = 0; d < sizeof(docs) / sizeof(docs[0]); d ++) {
+		for(size_t pad = 0; pad < 70; pad ++) {
+			memset(json, ' ', pad);
+			strcpy(json + pad, docs[d]);
+
+			lept_set_engine(LEPT_ENGINE_RECURSIVE);
+			r1 = lept_parse(&v1, json);
+			lept_set_engine(LEPT_ENGINE_INDEX);
+			r2 = lept_parse(&v2, json);
+			lept_set_engine(LEPT_ENGINE_RECURSIVE);
+
+			EXPECT_EQ_TEST(r1, r2, lept_parse_xxx_string);
+			if(r1 == LEPT_PARSE_OK && r2 == LEPT_PARSE_OK) {
+				lept_stringify(&v1, &s1, NULL);
+				lept_stringify(&v2, &s2, NULL);
+				EXPECT_EQ_STRING(s1, s2, strlen(s1) + 1);
+				free(s1);
+				free(s2);
+			}
+			lept_free(&v1);
+			lept_free(&v2);
+		}
+	}
+}
+
+/* sax handlers writing each event as a short token */
+
+typedef struct {
+	char buf[256];
+	size_t len;
+	int abort_on_number;
+} test_sax_log;
+
+static int test_sax_put(void* user, const char* s, size_t len) {
+	test_sax_log* log = (test_sax_log*)user;
+	memcpy(log->buf + log->len, s, len);
+	log->len += len;
+	log->buf[log->len++] = ' ';
+	log->buf[log->len] = '\0';
+	return 0;
+}
+
+static int test_sax_null(void* user) { return test_sax_put(user, "n", 1); }
+static int test_sax_boolean(void* user, int b) { return test_sax_put(user, b ? "t" : "f", 1); }
+static int test_sax_start_array(void* user) { return test_sax_put(user, "[", 1); }
+static int test_sax_start_object(void* user) { return test_sax_put(user, "{", 1); }
+
+static int test_sax_number(void* user, double d) {
+	char tmp[32];
+	test_sax_put(user, tmp, sprintf(tmp, "%g", d));
+	return ((test_sax_log*)user)->abort_on_number;
+}
+
+static int test_sax_end_array(void* user, size_t size) {
+	char tmp[32];
+	return test_sax_put(user, tmp, sprintf(tmp, "]%d", (int)size));
+}
+
+static int test_sax_end_object(void* user, size_t size) {
+	char tmp[32];
+	return test_sax_put(user, tmp, sprintf(tmp, "}%d", (int)size));
+}
+
+static int test_sax_key(void* user, const char* s, size_t len) {
+	test_sax_put(user, "k:", 2);
+	((test_sax_log*)user)->len --;
+	return test_sax_put(user, s, len);
+}
+
+#define TEST_SAX(expect, ret, json, abort) \
+	do { \
+		test_sax_log log; \
+		log.len = 0; \
+		log.buf[0] = '\0'; \
+		log.abort_on_number = (abort); \
+		EXPECT_EQ_TEST(ret, lept_parse_sax(json, strlen(json), &h, &log), lept_parse_xxx_string); \
+		EXPECT_EQ_STRING(expect, log.buf, strlen(expect) + 1); \
+	} while(0)
+
+static void test_parse_sax() {
+	fprintf_warn(stdout, " => %s starts...\n", __func__);
+
+	lept_sax_handler h = {
+		test_sax_null, test_sax_boolean, test_sax_number, NULL,
+		test_sax_start_array, test_sax_end_array,
+		test_sax_start_object, test_sax_key, test_sax_end_object
+	};
+
+	TEST_SAX("n ", LEPT_PARSE_OK, " null ", 0);
+	TEST_SAX("[ t f n 1.5 [ ]0 { }0 ]6 ", LEPT_PARSE_OK, "[true,false,null,1.5,[],{}]", 0);
+	TEST_SAX("{ k:a [ ]1 k:b\\c { k: -2 }1 }2 ", LEPT_PARSE_OK, "{\"a\":[\"skipped\"],\"b\\\\c\":{\"\":-2}}", 0);
+
+	/* events up to the error have been sent */
+	TEST_SAX("[ 1 ", LEPT_PARSE_INVALID_VALUE, "[1 2]", 0);
+	TEST_SAX("{ k:a ", LEPT_PARSE_MISS_COLON, "{\"a\" 1}", 0);
+
+	/* a non-zero return stops at once */
+	TEST_SAX("[ t 7 ", LEPT_PARSE_ABORTED, "[true, 7, 8]", 1);
+}
+
+/* every document fed in two chunks split at each byte, then byte by byte */
+static void test_parse_stream() {
+	fprintf_warn(stdout, " => %s starts...\n", __func__);
+
+	static const char* docs[] = {
+		" null ", "true", "-1.5e+3", "\"a\\tb\\uD834\\uDD1Ec\"", "[]", " [ 1 , [ \"x\" , { } ] ] ",
+		"{\"n\":null,\"f\":false,\"s\":\"a\\\\\\\"b\",\"a\":[1,2,3],\"o\":{\"1\":1}}",
+		"", " ", "nul", "truex", "[1x]", "1.", "0x0", "[1,]", "[1 2]", "[1", "[", "{", "{\"a\"", "{\"a\" 1}",
+		"{\"a\":", "{\"a\":1", "{\"a\":1,}", "{1:1}", "[\"abc", "\"\\v\"", "\"\\u12\"", "\"\\uD800\"",
+		"\"a\nb\"", "1e309", "[1] 2", "{\"a\":1 \"b\"}", "?"
+	};
+	lept_stream* s = lept_stream_new();
+	lept_value v1, v2;
+	char *s1, *s2;
+	int r1, r2;
+
+	for(size_t d = 0; d < sizeof(docs) / sizeof(docs[0]); d ++) {
+		size_t len = strlen(docs[d]);
+
+		r1 = lept_parse_n(&v1, docs[d], len);
+		if(r1 == LEPT_PARSE_OK) {
+			lept_stringify(&v1, &s1, NULL);
+		}
+		for(size_t split = 0; split <= len + 1; split ++) {
+			if(split <= len) {
+				lept_stream_feed(s, docs[d], split);
+				lept_stream_feed(s, docs[d] + split, len - split);
+			} else {
+				for(size_t i = 0; i < len; i ++) {
+					lept_stream_feed(s, docs[d] + i, 1);
+				}
+			}
+			r2 = lept_stream_finish(s, &v2);
+
+			EXPECT_EQ_TEST(r1, r2, lept_parse_xxx_string);
+			if(r1 == LEPT_PARSE_OK && r2 == LEPT_PARSE_OK) {
+				lept_stringify(&v2, &s2, NULL);
+				EXPECT_EQ_STRING(s1, s2, strlen(s1) + 1);
+				free(s2);
+			}
+			lept_free(&v2);
+		}
+		if(r1 == LEPT_PARSE_OK) {
+			free(s1);
+		}
+		lept_free(&v1);
+	}
+
+	/* an error is reported by the feed that reaches it */
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_stream_feed(s, "[1, 2", 5), lept_parse_xxx_string);
+	EXPECT_EQ_TEST(LEPT_PARSE_INVALID_VALUE, lept_stream_feed(s, " 3]", 3), lept_parse_xxx_string);
+	EXPECT_EQ_TEST(LEPT_PARSE_INVALID_VALUE, lept_stream_feed(s, "[]", 2), lept_parse_xxx_string);
+	EXPECT_EQ_TEST(LEPT_PARSE_INVALID_VALUE, lept_stream_finish(s, &v2), lept_parse_xxx_string);
+	EXPECT_EQ_INT(LEPT_NULL, lept_get_type(&v2));
+
+	lept_stream_free(s);
+}
+
+static void test_parse_arena() {
+	fprintf_warn(stdout, " => %s starts...\n", __func__);
+
+	const char* json = "{\"s\":\"a string longer than one block of the arena\",\"a\":[1,\"2\",[3]],\"o\":{}}";
+	lept_arena a;
+	lept_value v;
+	int i;
+
+	lept_arena_init(&a, 64); /* tiny blocks to exercise block chaining */
+	for(i = 0; i < 3; i ++) {
+		EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_parse_arena(&v, json, strlen(json), &a), lept_parse_xxx_string);
+		EXPECT_EQ_SIZE_T(3, lept_get_object_size(&v));
+		EXPECT_EQ_STRING("a string longer than one block of the arena",
+			lept_get_string(lept_get_object_value(&v, 0)), lept_get_string_length(lept_get_object_value(&v, 0)));
+		EXPECT_EQ_SIZE_T(3, lept_get_array_size(lept_get_object_value(&v, 1)));
+		EXPECT_EQ_STRING("2", lept_get_string(lept_get_array_element(lept_get_object_value(&v, 1), 1)), 1);
+		EXPECT_EQ_SIZE_T(0, lept_get_object_size(lept_get_object_value(&v, 2)));
+		lept_arena_reset(&a);
+	}
+
+	EXPECT_EQ_TEST(LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET, lept_parse_arena(&v, "{\"a\":[\"x\"] \"b\"", 14, &a),
+		lept_parse_xxx_string);
+
+	/* the length bounds the parse, no '\0' is needed */
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_parse_arena(&v, "[1,2]garbage", 5, &a), lept_parse_xxx_string);
+	EXPECT_EQ_SIZE_T(2, lept_get_array_size(&v));
+
+	/* arena values are borrowed, lept_free() leaves the blocks alone */
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_parse_arena(&v, "[\"x\",{\"k\":[]}]", 14, &a), lept_parse_xxx_string);
+	lept_free(&v);
+	EXPECT_EQ_INT(LEPT_NULL, lept_get_type(&v));
+
+	/* a changed arena document holds heap strings, which lept_free() releases */
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_parse_arena(&v, "[\"x\",{\"k\":[]}]", 14, &a), lept_parse_xxx_string);
+	lept_set_string(lept_get_array_element(&v, 0), "a string too long to be inline", 30);
+	lept_set_string(lept_find_object_value(lept_get_array_element(&v, 1), "k", 1), "another one, on the heap", 24);
+	lept_free(&v);
+	lept_arena_reset(&a);
+	lept_arena_free(&a);
+}
+
+static void test_parse_intern() {
+	fprintf_warn(stdout, " => %s starts...\n", __func__);
+
+	const char* json = "[{\"identifier\":1,\"display_name\":\"a\"},{\"display_name\":\"b\",\"identifier\":2}]";
+	lept_intern* t = lept_intern_new();
+	lept_value v, w;
+	const char* key;
+	char buf[32];
+	int i;
+
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_parse_intern(&v, json, strlen(json), t), lept_parse_xxx_string);
+	EXPECT_EQ_SIZE_T(2, lept_get_array_size(&v));
+
+	/* short keys are inline in each node */
+	key = lept_get_object_key(lept_get_array_element(&v, 0), 1);
+	EXPECT_EQ_STRING("display_name", key, 12);
+	EXPECT_TRUE(key != lept_get_object_key(lept_get_array_element(&v, 1), 0));
+	EXPECT_EQ_SIZE_T(0, lept_intern_size(t));
+	lept_free(&v);
+
+	/* long ones are shared */
+	json = "[{\"customer_identifier\":1,\"x\":[]},{\"customer_identifier\":2}]";
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_parse_intern(&w, json, strlen(json), t), lept_parse_xxx_string);
+	key = lept_get_object_key(lept_get_array_element(&w, 0), 0);
+	EXPECT_EQ_STRING("customer_identifier", key, lept_get_object_key_length(lept_get_array_element(&w, 0), 0));
+	EXPECT_TRUE(key == lept_get_object_key(lept_get_array_element(&w, 1), 0));
+	EXPECT_TRUE(key == lept_intern_key(t, "customer_identifier", 19));
+	EXPECT_EQ_SIZE_T(20, lept_intern_size(t));
+	EXPECT_EQ_DOUBLE(2.0, lept_get_number(lept_find_object_value(lept_get_array_element(&w, 1), key, 19)));
+	EXPECT_EQ_DOUBLE(1.0, lept_get_number(lept_find_object_value(lept_get_array_element(&w, 0), "customer_identifier", 19)));
+
+	/* later documents find the keys already there */
+	json = "{\"customer_identifier\":1 \"another_long_key\"";
+	EXPECT_EQ_TEST(LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET, lept_parse_intern(&v, json, strlen(json), t),
+		lept_parse_xxx_string);
+	EXPECT_EQ_SIZE_T(20, lept_intern_size(t));
+	EXPECT_TRUE(lept_intern_key(t, "another_long_key", 16) != NULL);
+	EXPECT_EQ_SIZE_T(37, lept_intern_size(t));
+
+	/* growing the table leaves the text in place */
+	for(i = 0; i < 1000; i ++) {
+		sprintf(buf, "generated_key_%04d", i);
+		EXPECT_EQ_STRING(buf, lept_intern_key(t, buf, 18), 18);
+	}
+	EXPECT_EQ_SIZE_T(37 + 1000 * 19, lept_intern_size(t));
+	EXPECT_TRUE(key == lept_intern_key(t, "customer_identifier", 19));
+
+	/* the values go first, the table owns their keys */
+	lept_free(&w);
+	lept_intern_free(t);
+}
+
+static void test_parse_lines() {
+	fprintf_warn(stdout, " => %s starts...\n", __func__);
+
+	static const char* docs[] = {
+		"{\"id\":1,\"tags\":[\"a\",\"b\"]}", " [1, 2] \r", "", "\"line\"", "{\"id\":", "  ", "1 2",
+		"{\"nested\":{\"deep\":[[[]]]}}", "null"
+	};
+	static const int nthreads[] = { 1, 2, 3, 8, 0 };
+	size_t ndocs = sizeof(docs) / sizeof(docs[0]);
+	char buf[256] = "";
+	lept_line* lines;
+	lept_value v;
+	char *s1, *s2;
+	size_t n;
+	int r;
+
+	/* the last line has no '\n' */
+	for(size_t d = 0; d < ndocs; d ++) {
+		strcat(buf, docs[d]);
+		strcat(buf, (d + 1 < ndocs) ? "\n" : "");
+	}
+
+	for(size_t t = 0; t < sizeof(nthreads) / sizeof(nthreads[0]); t ++) {
+		n = lept_parse_lines(buf, strlen(buf), &lines, nthreads[t]);
+		EXPECT_EQ_SIZE_T(ndocs, n);
+		for(size_t d = 0; d < ndocs && d < n; d ++) {
+			r = lept_parse(&v, docs[d]);
+			EXPECT_EQ_TEST(r, lines[d].ret, lept_parse_xxx_string);
+			if(r == LEPT_PARSE_OK && lines[d].ret == LEPT_PARSE_OK) {
+				lept_stringify(&v, &s1, NULL);
+				lept_stringify(&lines[d].v, &s2, NULL);
+				EXPECT_EQ_STRING(s1, s2, strlen(s1) + 1);
+				free(s1);
+				free(s2);
+			}
+			lept_free(&v);
+		}
+		lept_free_lines(lines, n);
+	}
+
+	/* a trailing '\n' ends the last line rather than starting an empty one */
+	n = lept_parse_lines("1\n\n2\n", 5, &lines, 2);
+	EXPECT_EQ_SIZE_T(3, n);
+	EXPECT_EQ_TEST(LEPT_PARSE_EXPECT_VALUE, lines[1].ret, lept_parse_xxx_string);
+	EXPECT_EQ_DOUBLE(2.0, lept_get_number(&lines[2].v));
+	lept_free_lines(lines, n);
+
+	n = lept_parse_lines("", 0, &lines, 4);
+	EXPECT_EQ_SIZE_T(0, n);
+	lept_free_lines(lines, n);
+}
+
+static void test_parse_parallel() {
+	fprintf_warn(stdout, " => %s starts...\n", __func__);
+
+	/* strings with commas, brackets and escaped quotes around the splits */
+	static const char* elements[] = {
+		"{\"s\":\"a,b],[c\",\"n\":[1,[2,{\"x\":\",\"}]]}", "\"\\\",\\\\\"", " [ ] ", "-1.5e3", "null",
+		"{\"k\\\"}\":{}}", "\"]},{[\""
+	};
+	/* stands in for the middle element, the last one follows the array */
+	static const char* breaks[] = { "1", "", "x", "[", "\"", "]", "}", "[1,{]", "\"\\\"", " 1" };
+	static const int nthreads[] = { 2, 3, 8, 0 };
+	size_t nelements = sizeof(elements) / sizeof(elements[0]);
+	size_t nbreaks = sizeof(breaks) / sizeof(breaks[0]);
+	size_t cap = 1 << 19, len, count = 30000;
+	char* json = (char*)malloc(cap);
+	lept_value v1, v2;
+	char *s1, *s2;
+	int r1, r2;
+
+	for(size_t b = 0; b < nbreaks; b ++) {
+		len = 0;
+		json[len ++] = '[';
+		for(size_t i = 0; i < count; i ++) {
+			len += sprintf(json + len, "%s%s", i ? "," : "",
+				(i == count / 2 && b + 1 < nbreaks) ? breaks[b] : elements[i % nelements]);
+		}
+		len += sprintf(json + len, "]%s", (b + 1 < nbreaks) ? "" : breaks[b]);
+
+		r1 = lept_parse_n(&v1, json, len);
+		EXPECT_EQ_INT(b == 0, r1 == LEPT_PARSE_OK);
+		if(r1 == LEPT_PARSE_OK) {
+			lept_stringify(&v1, &s1, NULL);
+		}
+		for(size_t t = 0; t < sizeof(nthreads) / sizeof(nthreads[0]); t ++) {
+			r2 = lept_parse_parallel(&v2, json, len, nthreads[t]);
+			EXPECT_EQ_TEST(r1, r2, lept_parse_xxx_string);
+			if(r1 == LEPT_PARSE_OK && r2 == LEPT_PARSE_OK) {
+				EXPECT_EQ_SIZE_T(count, lept_get_array_size(&v2));
+				lept_stringify(&v2, &s2, NULL);
+				EXPECT_EQ_STRING(s1, s2, strlen(s1) + 1);
+				free(s2);
+			}
+			lept_free(&v2);
+		}
+		if(r1 == LEPT_PARSE_OK) {
+			free(s1);
+		}
+		lept_free(&v1);
+	}
+
+	/* small documents and other roots go the usual way */
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_parse_parallel(&v1, " [1,2] ", 7, 4), lept_parse_xxx_string);
+	EXPECT_EQ_SIZE_T(2, lept_get_array_size(&v1));
+	lept_free(&v1);
+	EXPECT_EQ_TEST(LEPT_PARSE_ROOT_NOT_SINGULAR, lept_parse_parallel(&v1, "{} 1", 4, 4), lept_parse_xxx_string);
+
+	free(json);
+}
+
+static void test_parse_lazy() {
+	fprintf_warn(stdout, " => %s starts...\n", __func__);
+
+	const char* json =
+		" {\"id\" : 42, \"skip\":{\"a\":[1,{\"b\":\"]}\\\"[{\"}],\"c\":\"x\"},"
+		"\"name\":\"ab\\ncd\",\"tags\":[\"t0\", [\"t1\"], {}, null, true, false, -0.5e1],"
+		"\"k\\u0065y\":\"escaped\",\"empty\":[],\"last\":\"" "0123456789012345678901234567890123456789012345678901234567890123456789" "\"} ";
+	lept_lazy root, v, e;
+	lept_value value;
+	double d;
+	char* s;
+	size_t len;
+	char* str;
+
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_lazy_init(&root, json, strlen(json)), lept_parse_xxx_string);
+	EXPECT_EQ_TEST(LEPT_OBJECT, lept_lazy_get_type(&root), lept_type_string);
+
+	/* in document order */
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_lazy_find_field(&root, "id", 2, &v), lept_parse_xxx_string);
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_lazy_get_number(&v, &d), lept_parse_xxx_string);
+	EXPECT_EQ_DOUBLE(42.0, d);
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_lazy_find_field(&root, "name", 4, &v), lept_parse_xxx_string);
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_lazy_get_string(&v, &s, &len), lept_parse_xxx_string);
+	EXPECT_EQ_SIZE_T(5, len);
+	EXPECT_EQ_STRING("ab\ncd", s, len + 1);
+	free(s);
+
+	/* an array, element by element */
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_lazy_find_field(&root, "tags", 4, &v), lept_parse_xxx_string);
+	static const lept_type types[] = { LEPT_STRING, LEPT_ARRAY, LEPT_OBJECT, LEPT_NULL, LEPT_TRUE, LEPT_FALSE, LEPT_NUMBER };
+	for(size_t i = 0; i < sizeof(types) / sizeof(types[0]); i ++) {
+		EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_lazy_next_element(&v, &e), lept_parse_xxx_string);
+		EXPECT_EQ_TEST(types[i], lept_lazy_get_type(&e), lept_type_string);
+	}
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_lazy_get_number(&e, &d), lept_parse_xxx_string);
+	EXPECT_EQ_DOUBLE(-5.0, d);
+	EXPECT_EQ_INT(LEPT_LAZY_END, lept_lazy_next_element(&v, &e));
+	EXPECT_EQ_INT(LEPT_LAZY_END, lept_lazy_next_element(&v, &e));
+
+	/* out of order wraps around, keys are compared decoded */
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_lazy_find_field(&root, "skip", 4, &v), lept_parse_xxx_string);
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_lazy_find_field(&v, "c", 1, &e), lept_parse_xxx_string);
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_lazy_get_value(&e, &value), lept_parse_xxx_string);
+	EXPECT_EQ_STRING("x", lept_get_string(&value), 2);
+	lept_free(&value);
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_lazy_find_field(&root, "key", 3, &v), lept_parse_xxx_string);
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_lazy_get_string(&v, &s, NULL), lept_parse_xxx_string);
+	EXPECT_EQ_STRING("escaped", s, 8);
+	free(s);
+	EXPECT_EQ_INT(LEPT_LAZY_END, lept_lazy_find_field(&root, "missing", 7, &v));
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_lazy_find_field(&root, "id", 2, &v), lept_parse_xxx_string);
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_lazy_find_field(&root, "last", 4, &v), lept_parse_xxx_string);
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_lazy_get_string(&v, &s, &len), lept_parse_xxx_string);
+	EXPECT_EQ_SIZE_T(70, len);
+	free(s);
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_lazy_find_field(&root, "empty", 5, &v), lept_parse_xxx_string);
+	EXPECT_EQ_INT(LEPT_LAZY_END, lept_lazy_next_element(&v, &e));
+
+	/* a subtree skipped whole is the same text lept_parse() would take */
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_lazy_find_field(&root, "skip", 4, &v), lept_parse_xxx_string);
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_lazy_get_value(&v, &value), lept_parse_xxx_string);
+	EXPECT_EQ_TEST(LEPT_STRINGIFY_OK, lept_stringify(&value, &str, NULL), lept_parse_xxx_string);
+	EXPECT_EQ_STRING("{\"a\":[1,{\"b\":\"]}\\\"[{\"}],\"c\":\"x\"}", str, strlen(str) + 1);
+	free(str);
+	lept_free(&value);
+
+	/* errors in what is read, not in what is skipped */
+	EXPECT_EQ_TEST(LEPT_PARSE_EXPECT_VALUE, lept_lazy_init(&root, " ", strlen(" ")), lept_parse_xxx_string);
+	EXPECT_EQ_TEST(LEPT_PARSE_INVALID_VALUE, lept_lazy_init(&root, "nul", strlen("nul")), lept_parse_xxx_string);
+	EXPECT_EQ_TEST(LEPT_PARSE_INVALID_VALUE, lept_lazy_init(&root, "?", strlen("?")), lept_parse_xxx_string);
+	lept_lazy_init(&root, "[1x, \"a\\q\", {\"a\":1 \"b\":2}, [1 2], tru]", strlen("[1x, \"a\\q\", {\"a\":1 \"b\":2}, [1 2], tru]"));
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_lazy_next_element(&root, &e), lept_parse_xxx_string);
+	EXPECT_EQ_TEST(LEPT_PARSE_INVALID_VALUE, lept_lazy_get_number(&e, &d), lept_parse_xxx_string);
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_lazy_next_element(&root, &e), lept_parse_xxx_string);
+	EXPECT_EQ_TEST(LEPT_PARSE_INVALID_ESCAPE, lept_lazy_get_string(&e, &s, NULL), lept_parse_xxx_string);
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_lazy_next_element(&root, &e), lept_parse_xxx_string);
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_lazy_find_field(&e, "a", 1, &v), lept_parse_xxx_string);
+	EXPECT_EQ_TEST(LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET, lept_lazy_find_field(&e, "b", 1, &v), lept_parse_xxx_string);
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_lazy_next_element(&root, &e), lept_parse_xxx_string);
+	EXPECT_EQ_TEST(LEPT_PARSE_INVALID_VALUE, lept_lazy_next_element(&root, &e), lept_parse_xxx_string);
+	lept_lazy_init(&root, "{\"a\" 1}", strlen("{\"a\" 1}"));
+	EXPECT_EQ_TEST(LEPT_PARSE_MISS_COLON, lept_lazy_find_field(&root, "a", 1, &v), lept_parse_xxx_string);
+	lept_lazy_init(&root, "{1:1}", strlen("{1:1}"));
+	EXPECT_EQ_TEST(LEPT_PARSE_MISS_KEY, lept_lazy_find_field(&root, "a", 1, &v), lept_parse_xxx_string);
+	lept_lazy_init(&root, "[[1,\"]\"],2", strlen("[[1,\"]\"],2"));
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_lazy_next_element(&root, &e), lept_parse_xxx_string);
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_lazy_next_element(&root, &e), lept_parse_xxx_string);
+	EXPECT_EQ_TEST(LEPT_PARSE_INVALID_VALUE, lept_lazy_next_element(&root, &e), lept_parse_xxx_string);
+	lept_lazy_init(&root, "[[1,[2]", strlen("[[1,[2]"));
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_lazy_next_element(&root, &e), lept_parse_xxx_string);
+	EXPECT_EQ_TEST(LEPT_PARSE_INVALID_VALUE, lept_lazy_next_element(&root, &e), lept_parse_xxx_string);
+	lept_lazy_init(&root, "{\"a\":\"1}", strlen("{\"a\":\"1}"));
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_lazy_find_field(&root, "a", 1, &v), lept_parse_xxx_string);
+	EXPECT_EQ_TEST(LEPT_PARSE_MISS_QUOTATION_MARK, lept_lazy_find_field(&root, "b", 1, &v), lept_parse_xxx_string);
+}
+
+#define TEST_PROJECTED(expect, json, proj) \
+    do { \
+        lept_value v; \
+        char* out; \
+        size_t len; \
+        EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_parse_projected(&v, json, strlen(json), proj), lept_parse_xxx_string); \
+        EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_stringify(&v, &out, &len)); \
+        EXPECT_EQ_STRING(expect, out, len + 1); \
+        free(out); \
+        lept_free(&v); \
+    } while(0)
+
+#define TEST_PROJECTED_ERROR(error, json, proj) \
+    do { \
+        lept_value v; \
+        EXPECT_EQ_TEST(error, lept_parse_projected(&v, json, strlen(json), proj), lept_parse_xxx_string); \
+        EXPECT_EQ_TEST(LEPT_NULL, lept_get_type(&v), lept_type_string); \
+    } while(0)
+
+static void test_parse_projected() {
+	fprintf_warn(stdout, " => %s starts...\n", __func__);
+
+	static const char* paths[] = { "/user/id", "/ts", "/items/*/price" };
+	static const char* merged[] = { "$.a[1].x", "$.a[*].y", "/a/0/z", "/b/1", "/b" };
+	static const char* everything[] = { "" };
+	static const char* bad[][1] = { { "$..id" }, { "$[1:2]" }, { "$[-1]" }, { "x" } };
+	const char* json =
+		" {\"ts\" : 1700000000, \"skip\":{\"a\":[1,{\"b\":\"]}\\\"[{\"}],\"c\":\"x\"},"
+		"\"user\":{\"name\":\"n\",\"id\":7,\"more\":[[[]]]},"
+		"\"items\":[{\"price\":1.5,\"qty\":2},{\"qty\":3},5,{\"price\":[1,2]},[{\"price\":0}]],"
+		"\"us\\u0065r\":{\"id\":8}} ";
+	lept_projection* p;
+
+	p = lept_projection_compile(paths, 3);
+	EXPECT_TRUE(p != NULL);
+	/* escaped keys match too, and duplicates are kept as lept_parse() keeps them */
+	TEST_PROJECTED("{\"ts\":1700000000,\"user\":{\"id\":7},\"items\":[{\"price\":1.5},{},{\"price\":[1,2]}],\"user\":{\"id\":8}}",
+		json, p);
+	TEST_PROJECTED("{}", "{\"a\":1}", p);
+	TEST_PROJECTED("{\"items\":[]}", "{\"items\":[]}", p);
+	TEST_PROJECTED("{\"user\":{}}", "{\"user\":{\"ID\":1}}", p);
+	TEST_PROJECTED("null", "[1,2]", p);
+	TEST_PROJECTED("null", "true", p);
+	TEST_PROJECTED_ERROR(LEPT_PARSE_EXPECT_VALUE, "", p);
+	TEST_PROJECTED_ERROR(LEPT_PARSE_MISS_KEY, "{1:2}", p);
+	TEST_PROJECTED_ERROR(LEPT_PARSE_MISS_COLON, "{\"a\" 1}", p);
+	TEST_PROJECTED_ERROR(LEPT_PARSE_INVALID_VALUE, "{\"a\":}", p);
+	TEST_PROJECTED_ERROR(LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET, "{\"a\":[1,2}", p);
+	TEST_PROJECTED_ERROR(LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET, "{\"ts\":1 \"a\":2}", p);
+	TEST_PROJECTED_ERROR(LEPT_PARSE_INVALID_VALUE, "{\"items\":[{\"price\":1} {}]}", p);
+	TEST_PROJECTED_ERROR(LEPT_PARSE_INVALID_VALUE, "{\"ts\":tru}", p);
+	TEST_PROJECTED_ERROR(LEPT_PARSE_MISS_QUOTATION_MARK, "{\"user\":{\"id\":1,\"x\":\"}}", p);
+	TEST_PROJECTED_ERROR(LEPT_PARSE_INVALID_VALUE, "{\"skip\":[1,{}", p);
+	TEST_PROJECTED_ERROR(LEPT_PARSE_ROOT_NOT_SINGULAR, "{} x", p);
+	lept_projection_free(p);
+
+	/* a wildcard's paths reach the explicit children too, whichever came first */
+	p = lept_projection_compile(merged, 5);
+	TEST_PROJECTED("{\"a\":[{\"y\":2,\"z\":3},{\"x\":4,\"y\":5},{\"y\":8}],\"b\":{\"0\":1,\"1\":2}}",
+		"{\"a\":[{\"x\":1,\"y\":2,\"z\":3},{\"x\":4,\"y\":5,\"z\":6},{\"x\":7,\"y\":8,\"z\":9}],\"b\":{\"0\":1,\"1\":2}}", p);
+	TEST_PROJECTED("{\"b\":[\"p\",\"q\"]}", "{\"b\":[\"p\",\"q\"]}", p);
+	lept_projection_free(p);
+
+	p = lept_projection_compile(everything, 1);
+	TEST_PROJECTED("{\"ts\":1700000000,\"skip\":{\"a\":[1,{\"b\":\"]}\\\"[{\"}],\"c\":\"x\"},"
+		"\"user\":{\"name\":\"n\",\"id\":7,\"more\":[[[]]]},"
+		"\"items\":[{\"price\":1.5,\"qty\":2},{\"qty\":3},5,{\"price\":[1,2]},[{\"price\":0}]],"
+		"\"user\":{\"id\":8}}", json, p);
+	lept_projection_free(p);
+
+	p = lept_projection_compile(NULL, 0);
+	TEST_PROJECTED("null", json, p);
+	lept_projection_free(p);
+
+	for(size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i ++) {
+		EXPECT_TRUE(lept_projection_compile(bad[i], 1) == NULL);
+	}
 }
 
 static void test_parse() {
@@ -672,14 +1797,44 @@ static void test_parse() {
     test_parse_miss_key();
     test_parse_miss_colon();
     test_parse_miss_comma_or_curly_bracket();
+    test_parse_too_deep();
 
     test_access_boolean();
     test_access_string();
     test_access_number();
 	test_access_array();
     test_access_object();
+    test_find_object();
+    test_query();
+
+    test_parse_n();
+    test_parse_insitu();
+    test_parse_arena();
+    test_parse_intern();
+    test_parse_lines();
+    test_parse_parallel();
+    test_parse_lazy();
+    test_parse_projected();
+    test_parse_engine();
+    test_parse_sax();
+    test_parse_stream();
 }
 
+/* the value through a binary form and back prints as json */
+#define TEST_BINARY_ROUNDTRIP(json, v, encode, decode) \
+    do { \
+        char *b_buf, *b_json; \
+        size_t b_len, b_json_len; \
+        lept_value b_v; \
+        EXPECT_EQ_INT(LEPT_STRINGIFY_OK, encode(v, &b_buf, &b_len)); \
+        EXPECT_EQ_TEST(LEPT_PARSE_OK, decode(&b_v, b_buf, b_len), lept_parse_xxx_string); \
+        EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_stringify(&b_v, &b_json, &b_json_len)); \
+        EXPECT_EQ_STRING(json, b_json, b_json_len + 1); \
+        free(b_json); \
+        free(b_buf); \
+        lept_free(&b_v); \
+    } while(0)
+
 #define TEST_ROUNDTRIP(json) \
     do { \
         char* r_json; \
@@ -692,7 +1847,10 @@ static void test_parse() {
         ret = lept_stringify(&v, &r_json, &r_len); \
         EXPECT_EQ_INT(LEPT_STRINGIFY_OK, ret); \
         EXPECT_EQ_STRING(json, r_json, r_len); \
+        EXPECT_EQ_SIZE_T(r_len, lept_stringify_length(&v)); \
         free(r_json); \
+        TEST_BINARY_ROUNDTRIP(json, &v, lept_encode_cbor, lept_decode_cbor); \
+        TEST_BINARY_ROUNDTRIP(json, &v, lept_encode_msgpack, lept_decode_msgpack); \
     } while(0)
 
 static void test_stringify_number() {
@@ -710,14 +1868,25 @@ static void test_stringify_number() {
     TEST_ROUNDTRIP("1.234e-20");
 
     TEST_ROUNDTRIP("1.0000000000000002"); /* the smallest number > 1 */
-    TEST_ROUNDTRIP("4.9406564584124654e-324"); /* minimum denormal */
-    TEST_ROUNDTRIP("-4.9406564584124654e-324");
-    TEST_ROUNDTRIP("2.2250738585072009e-308");  /* Max subnormal double */
-    TEST_ROUNDTRIP("-2.2250738585072009e-308");
+    TEST_ROUNDTRIP("5e-324"); /* minimum denormal */
+    TEST_ROUNDTRIP("-5e-324");
+    TEST_ROUNDTRIP("2.225073858507201e-308");  /* Max subnormal double */
+    TEST_ROUNDTRIP("-2.225073858507201e-308");
     TEST_ROUNDTRIP("2.2250738585072014e-308");  /* Min normal positive double */
     TEST_ROUNDTRIP("-2.2250738585072014e-308");
     TEST_ROUNDTRIP("1.7976931348623157e+308");  /* Max double */
     TEST_ROUNDTRIP("-1.7976931348623157e+308");
+
+    /* shortest representation */
+    TEST_ROUNDTRIP("0.1");
+    TEST_ROUNDTRIP("0.3");
+    TEST_ROUNDTRIP("0.00015");
+    TEST_ROUNDTRIP("1.5e-05");
+    TEST_ROUNDTRIP("1e+23");
+    TEST_ROUNDTRIP("123456.789");
+    TEST_ROUNDTRIP("9007199254740991");
+    TEST_ROUNDTRIP("18014398509481984");
+    TEST_ROUNDTRIP("1e+17");
 }
 
 static void test_stringify_string() {
@@ -728,6 +1897,8 @@ static void test_stringify_string() {
     TEST_ROUNDTRIP("\"Hello\\nWorld\"");
     TEST_ROUNDTRIP("\"\\\" \\\\ / \\b \\f \\n \\r \\t\"");
     TEST_ROUNDTRIP("\"Hello\\u0000World\"");
+    TEST_ROUNDTRIP("\"\\u0001\\u001f\"");
+    TEST_ROUNDTRIP("\"it's\"");
 }
 
 static void test_stringify_array() {
@@ -744,6 +1915,479 @@ static void test_stringify_object() {
     TEST_ROUNDTRIP("{\"n\":null,\"f\":false,\"t\":true,\"i\":123,\"s\":\"abc\",\"a\":[1,2,3],\"o\":{\"1\":1,\"2\":2,\"3\":3}}");
 }
 
+/* a sink gathering the pieces, failing once it holds more than fail_after bytes */
+
+typedef struct {
+    char* s;
+    size_t len, max_piece, fail_after;
+} test_sink;
+
+static int test_sink_write(void* user, const char* s, size_t len) {
+    test_sink* sink = (test_sink*)user;
+    sink->s = (char*)realloc(sink->s, sink->len + len);
+    memcpy(sink->s + sink->len, s, len);
+    sink->len += len;
+    if(len > sink->max_piece) {
+        sink->max_piece = len;
+    }
+    return sink->len > sink->fail_after;
+}
+
+static void test_stringify_to() {
+    fprintf_warn(stdout, " => %s starts...\n", __func__);
+
+    size_t n = 3000;
+    char* json = (char*)malloc(8 * n + 64);
+    char *expect, *actual;
+    size_t len, i;
+    test_sink sink = { NULL, 0, 0, (size_t)-1 };
+    FILE* fp;
+    lept_value v;
+
+    /* a long escaped string and many small elements, both across pieces */
+    strcpy(json, "[\"");
+    for(i = 0; i < n; i ++) {
+        strcat(json + 2 + 3 * i, "a\\n");
+    }
+    strcat(json, "\"");
+    for(i = 0; i < n; i ++) {
+        strcat(json, ",1.5");
+    }
+    strcat(json, "]");
+    EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_parse(&v, json), lept_parse_xxx_string);
+    lept_stringify(&v, &expect, &len);
+
+    EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_stringify_to(&v, test_sink_write, &sink));
+    EXPECT_EQ_SIZE_T(len, sink.len);
+    EXPECT_EQ_STRING(expect, sink.s, len);
+    EXPECT_TRUE(sink.max_piece <= 4096 + 32);
+
+    /* a failed write stops the output */
+    sink.len = 0;
+    sink.fail_after = 5000;
+    EXPECT_EQ_INT(LEPT_STRINGIFY_WRITE_FAILED, lept_stringify_to(&v, test_sink_write, &sink));
+    EXPECT_TRUE(sink.len < len);
+
+    fp = tmpfile();
+    if(fp != NULL) {
+        EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_stringify_file(&v, fp));
+        fflush(fp);
+        EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_stringify_fd(&v, fileno(fp)));
+        actual = (char*)malloc(2 * len);
+        rewind(fp);
+        EXPECT_EQ_SIZE_T(2 * len, fread(actual, 1, 2 * len, fp));
+        EXPECT_EQ_STRING(expect, actual, len);
+        EXPECT_EQ_STRING(expect, actual + len, len);
+        free(actual);
+        fclose(fp);
+    }
+    lept_free(&v);
+    free(expect);
+
+    /* closing brackets past the mark are flushed too, whatever the depth */
+    {
+        lept_value* e = &v;
+        lept_init(&v);
+        for(i = 0; i < 1000; i ++) {
+            lept_set_array(e, 0);
+            e = lept_pushback_array_element(e);
+        }
+        memset(json, 'x', n + 50);
+        lept_set_string(e, json, n + 50);
+    }
+    lept_stringify(&v, &expect, &len);
+    sink.len = 0;
+    sink.max_piece = 0;
+    sink.fail_after = (size_t)-1;
+    EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_stringify_to(&v, test_sink_write, &sink));
+    EXPECT_EQ_SIZE_T(len, sink.len);
+    EXPECT_EQ_STRING(expect, sink.s, len);
+    EXPECT_TRUE(sink.max_piece <= 4096 + 32);
+
+    free(sink.s);
+    free(expect);
+    lept_free(&v);
+    free(json);
+}
+
+static void test_stringify_into() {
+    fprintf_warn(stdout, " => %s starts...\n", __func__);
+
+    const char* json = "{\"s\":\"a\\u0001\\\"b\",\"a\":[1.5,-2e-07,true,null,{}],\"e\":[]}";
+    char buf[64];
+    size_t len, n = 0;
+    lept_value v;
+
+    EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_parse(&v, json), lept_parse_xxx_string);
+    len = lept_stringify_length(&v);
+    EXPECT_EQ_SIZE_T(strlen(json), len);
+
+    /* room for the text and its '\0', and one byte less */
+    EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_stringify_into(&v, buf, len + 1, &n));
+    EXPECT_EQ_SIZE_T(len, n);
+    EXPECT_EQ_STRING(json, buf, len + 1);
+    EXPECT_EQ_INT(LEPT_STRINGIFY_BUFFER_TOO_SMALL, lept_stringify_into(&v, buf, len, NULL));
+    EXPECT_EQ_INT(LEPT_STRINGIFY_BUFFER_TOO_SMALL, lept_stringify_into(&v, NULL, 0, NULL));
+
+    /* nothing is written past cap, and what is written is a prefix */
+    for(size_t cap = 1; cap <= len; cap ++) {
+        memset(buf, '#', sizeof(buf));
+        EXPECT_EQ_INT(LEPT_STRINGIFY_BUFFER_TOO_SMALL, lept_stringify_into(&v, buf, cap, NULL));
+        EXPECT_TRUE(buf[cap] == '#');
+        for(n = 0; n < cap && buf[n] != '#'; n ++) {
+        }
+        EXPECT_TRUE(memcmp(buf, json, n) == 0);
+    }
+
+    lept_free(&v);
+}
+
+static void test_stringify_parallel() {
+	fprintf_warn(stdout, " => %s starts...\n", __func__);
+
+	static const int nthreads[] = { 1, 2, 3, 8, 0 };
+	size_t cap = 1 << 20, len = 0, n1, n2;
+	char* json = (char*)malloc(cap);
+	lept_value v;
+	char *s1, *s2;
+
+	/* a large array, then a large object, then a small array */
+	json[len ++] = '[';
+	for(int i = 0; i < 10000; i ++) {
+		len += sprintf(json + len, "%s{\"id\":%d,\"s\":\"x\\n%d\",\"a\":[%d,true,null]}", i ? "," : "", i, i, -i);
+	}
+	json[len ++] = ']';
+	json[len] = '\0';
+	for(int d = 0; d < 3; d ++) {
+		if(d == 1) {
+			len = 0;
+			json[len ++] = '{';
+			for(int i = 0; i < 10000; i ++) {
+				len += sprintf(json + len, "%s\"key%d\":[%d.5,\"v\"]", i ? "," : "", i, i);
+			}
+			json[len ++] = '}';
+			json[len] = '\0';
+		} else if(d == 2) {
+			strcpy(json, "[1,\"a\",{}]");
+		}
+		EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_parse(&v, json), lept_parse_xxx_string);
+		EXPECT_EQ_TEST(LEPT_STRINGIFY_OK, lept_stringify(&v, &s1, &n1), lept_parse_xxx_string);
+		for(size_t t = 0; t < sizeof(nthreads) / sizeof(nthreads[0]); t ++) {
+			EXPECT_EQ_TEST(LEPT_STRINGIFY_OK, lept_stringify_parallel(&v, &s2, &n2, nthreads[t]), lept_parse_xxx_string);
+			EXPECT_EQ_SIZE_T(n1, n2);
+			EXPECT_EQ_STRING(s1, s2, n1 + 1);
+			free(s2);
+		}
+		free(s1);
+		lept_free(&v);
+	}
+
+	free(json);
+}
+
+/* bytes from hex digits */
+static size_t test_hex(const char* hex, char* bin) {
+	size_t n = 0;
+	unsigned b;
+	for(; *hex != '\0'; hex += 2) {
+		sscanf(hex, "%2x", &b);
+		bin[n ++] = (char)b;
+	}
+	return n;
+}
+
+#define TEST_BINARY_DECODE(decode, hex, json) \
+	do { \
+		char b_bin[64], *b_json; \
+		size_t b_len; \
+		lept_value b_v; \
+		EXPECT_EQ_TEST(LEPT_PARSE_OK, decode(&b_v, b_bin, test_hex(hex, b_bin)), lept_parse_xxx_string); \
+		EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_stringify(&b_v, &b_json, &b_len)); \
+		EXPECT_EQ_STRING(json, b_json, b_len + 1); \
+		free(b_json); \
+		lept_free(&b_v); \
+	} while(0)
+
+/* json encodes to exactly hex, and decodes back */
+#define TEST_BINARY(encode, decode, hex, json) \
+	do { \
+		char b_bin[64], *b_buf; \
+		size_t b_n = test_hex(hex, b_bin), b_len; \
+		lept_value b_v; \
+		EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_parse(&b_v, json), lept_parse_xxx_string); \
+		EXPECT_EQ_INT(LEPT_STRINGIFY_OK, encode(&b_v, &b_buf, &b_len)); \
+		EXPECT_EQ_SIZE_T(b_n, b_len); \
+		EXPECT_TRUE(b_n == b_len && memcmp(b_bin, b_buf, b_n) == 0); \
+		free(b_buf); \
+		lept_free(&b_v); \
+		TEST_BINARY_DECODE(decode, hex, json); \
+	} while(0)
+
+#define TEST_BINARY_ERROR(decode, error, hex) \
+	do { \
+		char b_bin[64]; \
+		lept_value b_v; \
+		EXPECT_EQ_TEST(error, decode(&b_v, b_bin, test_hex(hex, b_bin)), lept_parse_xxx_string); \
+		EXPECT_EQ_TEST(LEPT_NULL, lept_get_type(&b_v), lept_type_string); \
+	} while(0)
+
+#define TEST_CBOR(hex, json) TEST_BINARY(lept_encode_cbor, lept_decode_cbor, hex, json)
+#define TEST_MSGPACK(hex, json) TEST_BINARY(lept_encode_msgpack, lept_decode_msgpack, hex, json)
+
+static void test_binary() {
+	fprintf_warn(stdout, " => %s starts...\n", __func__);
+
+	/* CBOR, mostly from RFC 8949 appendix A */
+	TEST_CBOR("00", "0");
+	TEST_CBOR("17", "23");
+	TEST_CBOR("1818", "24");
+	TEST_CBOR("1903e8", "1000");
+	TEST_CBOR("1a000f4240", "1000000");
+	TEST_CBOR("1b000000e8d4a51000", "1000000000000");
+	TEST_CBOR("20", "-1");
+	TEST_CBOR("3903e7", "-1000");
+	TEST_CBOR("3b7fffffffffffffff", "-9.223372036854776e+18");
+	TEST_CBOR("fa3fc00000", "1.5");
+	TEST_CBOR("fa80000000", "-0");
+	TEST_CBOR("fb3ff199999999999a", "1.1");
+	TEST_CBOR("fb7e37e43c8800759c", "1e+300");
+	TEST_CBOR("fadf800000", "-1.8446744073709552e+19");
+	TEST_CBOR("f4", "false");
+	TEST_CBOR("f5", "true");
+	TEST_CBOR("f6", "null");
+	TEST_CBOR("60", "\"\"");
+	TEST_CBOR("6449455446", "\"IETF\"");
+	TEST_CBOR("62c3bc", "\"\xc3\xbc\"");
+	TEST_CBOR("80", "[]");
+	TEST_CBOR("8301820203820405", "[1,[2,3],[4,5]]");
+	TEST_CBOR("a0", "{}");
+	TEST_CBOR("a26161016162820203", "{\"a\":1,\"b\":[2,3]}");
+	TEST_BINARY_DECODE(lept_decode_cbor, "1bffffffffffffffff", "1.8446744073709552e+19");
+	TEST_BINARY_DECODE(lept_decode_cbor, "3bffffffffffffffff", "-1.8446744073709552e+19");
+	TEST_BINARY_DECODE(lept_decode_cbor, "f93e00", "1.5");
+	TEST_BINARY_DECODE(lept_decode_cbor, "f98000", "-0");
+	TEST_BINARY_DECODE(lept_decode_cbor, "f90001", "5.960464477539063e-08");
+	TEST_BINARY_DECODE(lept_decode_cbor, "f97bff", "65504");
+	TEST_BINARY_DECODE(lept_decode_cbor, "fa47c35000", "100000");
+	TEST_BINARY_DECODE(lept_decode_cbor, "f7", "null");
+	TEST_BINARY_DECODE(lept_decode_cbor, "4401020304", "\"\\u0001\\u0002\\u0003\\u0004\"");
+	TEST_BINARY_DECODE(lept_decode_cbor, "c074323031332d30332d32315432303a30343a30305a", "\"2013-03-21T20:04:00Z\"");
+	TEST_BINARY_DECODE(lept_decode_cbor, "d82076687474703a2f2f7777772e6578616d706c652e636f6d", "\"http://www.example.com\"");
+	TEST_BINARY_DECODE(lept_decode_cbor, "7f657374726561646d696e67ff", "\"streaming\"");
+	TEST_BINARY_DECODE(lept_decode_cbor, "7fff", "\"\"");
+	TEST_BINARY_DECODE(lept_decode_cbor, "9fff", "[]");
+	TEST_BINARY_DECODE(lept_decode_cbor, "9f018202039f0405ffff", "[1,[2,3],[4,5]]");
+	TEST_BINARY_DECODE(lept_decode_cbor, "83018202039f0405ff", "[1,[2,3],[4,5]]");
+	TEST_BINARY_DECODE(lept_decode_cbor, "bf61610161629f0203ffff", "{\"a\":1,\"b\":[2,3]}");
+	TEST_BINARY_DECODE(lept_decode_cbor, "bf6346756ef563416d7421ff", "{\"Fun\":true,\"Amt\":-2}");
+
+	TEST_BINARY_ERROR(lept_decode_cbor, LEPT_PARSE_EXPECT_VALUE, "");
+	TEST_BINARY_ERROR(lept_decode_cbor, LEPT_PARSE_EXPECT_VALUE, "18");
+	TEST_BINARY_ERROR(lept_decode_cbor, LEPT_PARSE_EXPECT_VALUE, "6261");
+	TEST_BINARY_ERROR(lept_decode_cbor, LEPT_PARSE_EXPECT_VALUE, "8201");
+	TEST_BINARY_ERROR(lept_decode_cbor, LEPT_PARSE_EXPECT_VALUE, "9f01");
+	TEST_BINARY_ERROR(lept_decode_cbor, LEPT_PARSE_EXPECT_VALUE, "7f6161");
+	TEST_BINARY_ERROR(lept_decode_cbor, LEPT_PARSE_EXPECT_VALUE, "c0");
+	TEST_BINARY_ERROR(lept_decode_cbor, LEPT_PARSE_INVALID_VALUE, "1c");
+	TEST_BINARY_ERROR(lept_decode_cbor, LEPT_PARSE_INVALID_VALUE, "ff");
+	TEST_BINARY_ERROR(lept_decode_cbor, LEPT_PARSE_INVALID_VALUE, "c0ff");
+	TEST_BINARY_ERROR(lept_decode_cbor, LEPT_PARSE_INVALID_VALUE, "9fc0ff");
+	TEST_BINARY_ERROR(lept_decode_cbor, LEPT_PARSE_INVALID_VALUE, "bf6161c1ff");
+	TEST_BINARY_ERROR(lept_decode_cbor, LEPT_PARSE_INVALID_VALUE, "1f");
+	TEST_BINARY_ERROR(lept_decode_cbor, LEPT_PARSE_INVALID_VALUE, "8201ff");
+	TEST_BINARY_ERROR(lept_decode_cbor, LEPT_PARSE_INVALID_VALUE, "bf6161ff");
+	TEST_BINARY_ERROR(lept_decode_cbor, LEPT_PARSE_INVALID_VALUE, "7f01ff");
+	TEST_BINARY_ERROR(lept_decode_cbor, LEPT_PARSE_INVALID_VALUE, "7f7f6161ffff");
+	TEST_BINARY_ERROR(lept_decode_cbor, LEPT_PARSE_INVALID_VALUE, "f0");
+	TEST_BINARY_ERROR(lept_decode_cbor, LEPT_PARSE_INVALID_VALUE, "f820");
+	TEST_BINARY_ERROR(lept_decode_cbor, LEPT_PARSE_INVALID_VALUE, "f97c00");
+	TEST_BINARY_ERROR(lept_decode_cbor, LEPT_PARSE_INVALID_VALUE, "f97e00");
+	TEST_BINARY_ERROR(lept_decode_cbor, LEPT_PARSE_INVALID_VALUE, "fb7ff0000000000000");
+	TEST_BINARY_ERROR(lept_decode_cbor, LEPT_PARSE_TOO_LONG, "9b0000000100000000");
+	TEST_BINARY_ERROR(lept_decode_cbor, LEPT_PARSE_MISS_KEY, "a10102");
+	TEST_BINARY_ERROR(lept_decode_cbor, LEPT_PARSE_MISS_KEY, "826161a1f6f6");
+	TEST_BINARY_ERROR(lept_decode_cbor, LEPT_PARSE_ROOT_NOT_SINGULAR, "0102");
+	TEST_BINARY_ERROR(lept_decode_cbor, LEPT_PARSE_ROOT_NOT_SINGULAR, "80ff");
+
+	/* MessagePack */
+	TEST_MSGPACK("00", "0");
+	TEST_MSGPACK("7f", "127");
+	TEST_MSGPACK("cc80", "128");
+	TEST_MSGPACK("cd0100", "256");
+	TEST_MSGPACK("ce00010000", "65536");
+	TEST_MSGPACK("cf0000000100000000", "4294967296");
+	TEST_MSGPACK("ff", "-1");
+	TEST_MSGPACK("e0", "-32");
+	TEST_MSGPACK("d0df", "-33");
+	TEST_MSGPACK("d080", "-128");
+	TEST_MSGPACK("d1ff7f", "-129");
+	TEST_MSGPACK("d280000000", "-2147483648");
+	TEST_MSGPACK("d3ffffffff7fffffff", "-2147483649");
+	TEST_MSGPACK("d38000000000000000", "-9.223372036854776e+18");
+	TEST_MSGPACK("ca3fc00000", "1.5");
+	TEST_MSGPACK("ca80000000", "-0");
+	TEST_MSGPACK("cb3ff199999999999a", "1.1");
+	TEST_MSGPACK("c0", "null");
+	TEST_MSGPACK("c2", "false");
+	TEST_MSGPACK("c3", "true");
+	TEST_MSGPACK("a0", "\"\"");
+	TEST_MSGPACK("a3616263", "\"abc\"");
+	TEST_MSGPACK("d9206161616161616161616161616161616161616161616161616161616161616161",
+		"\"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa\"");
+	TEST_MSGPACK("90", "[]");
+	TEST_MSGPACK("93010203", "[1,2,3]");
+	TEST_MSGPACK("80", "{}");
+	TEST_MSGPACK("82a16101a16292c0c3", "{\"a\":1,\"b\":[null,true]}");
+	TEST_BINARY_DECODE(lept_decode_msgpack, "c4026869", "\"hi\"");
+	TEST_BINARY_DECODE(lept_decode_msgpack, "da000161", "\"a\"");
+	TEST_BINARY_DECODE(lept_decode_msgpack, "dc00020102", "[1,2]");
+	TEST_BINARY_DECODE(lept_decode_msgpack, "dd0000000100", "[0]");
+	TEST_BINARY_DECODE(lept_decode_msgpack, "de0001a16101", "{\"a\":1}");
+	TEST_BINARY_DECODE(lept_decode_msgpack, "cb3ff8000000000000", "1.5");
+	TEST_BINARY_DECODE(lept_decode_msgpack, "d000", "0");
+	TEST_BINARY_DECODE(lept_decode_msgpack, "cfffffffffffffffff", "1.8446744073709552e+19");
+
+	TEST_BINARY_ERROR(lept_decode_msgpack, LEPT_PARSE_EXPECT_VALUE, "");
+	TEST_BINARY_ERROR(lept_decode_msgpack, LEPT_PARSE_EXPECT_VALUE, "cd01");
+	TEST_BINARY_ERROR(lept_decode_msgpack, LEPT_PARSE_EXPECT_VALUE, "a261");
+	TEST_BINARY_ERROR(lept_decode_msgpack, LEPT_PARSE_EXPECT_VALUE, "9201");
+	TEST_BINARY_ERROR(lept_decode_msgpack, LEPT_PARSE_EXPECT_VALUE, "81a161");
+	TEST_BINARY_ERROR(lept_decode_msgpack, LEPT_PARSE_INVALID_VALUE, "c1");
+	TEST_BINARY_ERROR(lept_decode_msgpack, LEPT_PARSE_INVALID_VALUE, "d40100");
+	TEST_BINARY_ERROR(lept_decode_msgpack, LEPT_PARSE_INVALID_VALUE, "c7010100");
+	TEST_BINARY_ERROR(lept_decode_msgpack, LEPT_PARSE_INVALID_VALUE, "ca7fc00000");
+	TEST_BINARY_ERROR(lept_decode_msgpack, LEPT_PARSE_MISS_KEY, "810101");
+	TEST_BINARY_ERROR(lept_decode_msgpack, LEPT_PARSE_ROOT_NOT_SINGULAR, "0000");
+
+	/* nesting counts against the same limit as text */
+	{
+		size_t max_depth = lept_get_max_depth();
+		lept_value v;
+		lept_set_max_depth(2);
+		TEST_BINARY_DECODE(lept_decode_cbor, "818100", "[[0]]");
+		TEST_BINARY_ERROR(lept_decode_cbor, LEPT_PARSE_TOO_DEEP, "81818100");
+		TEST_BINARY_ERROR(lept_decode_msgpack, LEPT_PARSE_TOO_DEEP, "91919100");
+		lept_set_max_depth(max_depth);
+
+		/* long strings and large containers take the wider heads */
+		char* json = (char*)malloc(1 << 18);
+		size_t len = 0;
+		json[len ++] = '[';
+		for(int i = 0; i < 20000; i ++) {
+			len += sprintf(json + len, "%s%d", i ? "," : "", i - 10000);
+		}
+		len += sprintf(json + len, ",\"%0300d\",{\"%070000d\":0}]", 0, 0);
+		EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_parse(&v, json), lept_parse_xxx_string);
+		TEST_BINARY_ROUNDTRIP(json, &v, lept_encode_cbor, lept_decode_cbor);
+		TEST_BINARY_ROUNDTRIP(json, &v, lept_encode_msgpack, lept_decode_msgpack);
+		lept_free(&v);
+		free(json);
+	}
+}
+
+/* v and its snapshot view hold the same thing */
+static int test_view_equal(const lept_value* v, lept_view w) {
+	if(lept_get_type(v) != lept_view_get_type(w)) {
+		return 0;
+	}
+	switch(lept_get_type(v)) {
+		case LEPT_NUMBER: return lept_get_number(v) == lept_view_get_number(w);
+		case LEPT_STRING:
+			return lept_get_string_length(v) == lept_view_get_string_length(w) &&
+				memcmp(lept_get_string(v), lept_view_get_string(w), lept_get_string_length(v) + 1) == 0;
+		case LEPT_ARRAY:
+			if(lept_get_array_size(v) != lept_view_get_array_size(w)) {
+				return 0;
+			}
+			for(size_t i = 0; i < lept_get_array_size(v); i ++) {
+				if(!test_view_equal(lept_get_array_element(v, i), lept_view_get_array_element(w, i))) {
+					return 0;
+				}
+			}
+			return 1;
+		case LEPT_OBJECT:
+			if(lept_get_object_size(v) != lept_view_get_object_size(w)) {
+				return 0;
+			}
+			for(size_t i = 0; i < lept_get_object_size(v); i ++) {
+				if(lept_get_object_key_length(v, i) != lept_view_get_object_key_length(w, i) ||
+					memcmp(lept_get_object_key(v, i), lept_view_get_object_key(w, i), lept_get_object_key_length(v, i)) != 0 ||
+					!test_view_equal(lept_get_object_value(v, i), lept_view_get_object_value(w, i))) {
+					return 0;
+				}
+			}
+			return 1;
+		default: return 1;
+	}
+}
+
+static void test_snapshot() {
+	fprintf_warn(stdout, " => %s starts...\n", __func__);
+
+	static const char* docs[] = {
+		"null", "true", "-1.5", "\"\"", "\"a long string \\u0000 with a NUL\"", "[]", "{}",
+		"[1,[2,[3,[]]],{\"a\":{},\"b\":[null,false,true]},\"x\",\"\"]",
+		"{\"n\":null,\"f\":false,\"t\":true,\"i\":123,\"s\":\"abc\",\"a\":[1,2,3],\"o\":{\"1\":1,\"2\":2,\"3\":3}}",
+	};
+	const char* path = "leptjson_test.snapshot";
+	char json[4096];
+	size_t len = 0;
+	lept_snapshot* s;
+	lept_value v;
+	lept_view root, w;
+	FILE* fp;
+
+	for(size_t d = 0; d < sizeof(docs) / sizeof(docs[0]); d ++) {
+		EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_parse(&v, docs[d]), lept_parse_xxx_string);
+		EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_snapshot_write(&v, path));
+		EXPECT_TRUE((s = lept_snapshot_open(path)) != NULL);
+		if(s != NULL) {
+			EXPECT_TRUE(test_view_equal(&v, lept_snapshot_root(s)));
+			lept_snapshot_close(s);
+		}
+		lept_free(&v);
+	}
+
+	/* a wide object is looked up through its table, a repeated key finds the first */
+	len += sprintf(json + len, "{");
+	for(int i = 0; i < 100; i ++) {
+		len += sprintf(json + len, "\"key%d\":[%d,\"v%d\"],", i, i, i);
+	}
+	sprintf(json + len, "\"key7\":0,\"\":true}");
+	EXPECT_EQ_TEST(LEPT_PARSE_OK, lept_parse(&v, json), lept_parse_xxx_string);
+	EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_snapshot_write(&v, path));
+	lept_free(&v);
+	EXPECT_TRUE((s = lept_snapshot_open(path)) != NULL);
+	if(s != NULL) {
+		root = lept_snapshot_root(s);
+		EXPECT_EQ_SIZE_T(102, lept_view_get_object_size(root));
+		for(int i = 0; i < 100; i ++) {
+			char key[16];
+			sprintf(key, "key%d", i);
+			EXPECT_EQ_SIZE_T(i, lept_view_find_object_index(root, key, strlen(key)));
+			w = lept_view_find_object_value(root, key, strlen(key));
+			EXPECT_TRUE(w.base != NULL);
+			EXPECT_EQ_DOUBLE((double)i, lept_view_get_number(lept_view_get_array_element(w, 0)));
+		}
+		EXPECT_EQ_SIZE_T(LEPT_KEY_NOT_EXIST, lept_view_find_object_index(root, "key100", 6));
+		EXPECT_TRUE(lept_view_find_object_value(root, "key", 3).base == NULL);
+		EXPECT_TRUE(lept_view_get_boolean(lept_view_find_object_value(root, "", 0)));
+		w = lept_view_get_array_element(lept_view_get_object_value(root, 42), 1);
+		EXPECT_EQ_STRING("v42", lept_view_get_string(w), 4);
+		EXPECT_EQ_STRING("key99", lept_view_get_object_key(root, 99), 6);
+		lept_snapshot_close(s);
+	}
+
+	/* not a snapshot */
+	EXPECT_TRUE(lept_snapshot_open("leptjson_test.missing") == NULL);
+	if((fp = fopen(path, "wb")) != NULL) {
+		fputs("[1,2,3] and some more text to fill a header", fp);
+		fclose(fp);
+	}
+	EXPECT_TRUE(lept_snapshot_open(path) == NULL);
+	remove(path);
+}
+
 static void test_stringify() {
     fprintf_color(GREEN, stdout,  "== %s starts...\n", __func__);
 
@@ -754,6 +2398,11 @@ static void test_stringify() {
     test_stringify_string();
     test_stringify_array();
     test_stringify_object();
+    test_stringify_to();
+    test_stringify_into();
+    test_stringify_parallel();
+    test_binary();
+    test_snapshot();
 }
 
 /* main */
@@ -761,6 +2410,13 @@ static void test_stringify() {
 int main() {
     test_parse();
     test_stringify();
+
+    /* the whole suite again on the structural index */
+    lept_set_engine(LEPT_ENGINE_INDEX);
+    test_parse();
+    test_stringify();
+    lept_set_engine(LEPT_ENGINE_RECURSIVE);
+
     fprintf_info(stdout, "%d/%d (%3.2f%%) passed\n", test_pass, test_count, test_pass * 100.0 / test_count);
 
     return main_ret;